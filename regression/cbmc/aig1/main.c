@@ -0,0 +1,20 @@
+#include <assert.h>
+
+int main()
+{
+  unsigned char a, b, c;
+
+  // the same functions, built from different gates
+  assert((a^b)==((a|b)&~(a&b)));
+  assert((unsigned char)(a+b)==(unsigned char)((a^b)+2*(a&b)));
+
+  unsigned char mask=c?0xff:0;
+  assert((c?a:b)==((a&mask)|(b&~mask)));
+
+  // the only counterexample has a=40, b=203
+  __CPROVER_assume(b==(unsigned char)(a*5+3));
+  unsigned char s=(a^b)+2*(a&b);
+  assert(b!=203);
+
+  return 0;
+}
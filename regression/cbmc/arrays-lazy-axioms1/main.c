@@ -0,0 +1,18 @@
+int nondet_int();
+
+int a[100];
+
+int main()
+{
+  int i=nondet_int(), j=nondet_int(), k=nondet_int();
+  __CPROVER_assume(i>=0 && i<100 && j>=0 && j<100 && k>=0 && k<100);
+
+  a[i]=1;
+  a[j]=2;
+
+  __CPROVER_assert(i==j || a[i]==1, "read over write");
+  __CPROVER_assert(k!=i || k==j || a[k]==1, "equal indices");
+  __CPROVER_assert(a[i]==1, "overwritten");
+
+  return 0;
+}
@@ -0,0 +1,23 @@
+int nondet_int();
+
+int main()
+{
+  int x=nondet_int();
+  int y=0;
+
+  for(int i=0; i<4; i++)
+  {
+    if(x>i)
+    {
+      if(x<10)
+        y++;
+      else
+        y+=2;
+    }
+  }
+
+  __CPROVER_assert(y<=8, "y is bounded");
+  __CPROVER_assert(y!=3, "y can be 3");
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+#include <assert.h>
+
+int main()
+{
+  unsigned x, y, z;
+
+  if(x<100)
+    y=x*3;
+  else
+    y=x/3;
+
+  if(y<50)
+    z=y+x;
+  else
+    z=y-x;
+
+  assert(z!=2021);
+
+  return 0;
+}
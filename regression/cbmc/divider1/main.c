@@ -0,0 +1,25 @@
+#include <assert.h>
+
+int main()
+{
+  unsigned char a, b;
+
+  // division by a power of two
+  assert(a/8==a>>3);
+  assert(a%8==(a&7));
+
+  // non-constant division
+  if(b!=0)
+  {
+    unsigned char q=a/b, r=a%b;
+    assert(q*b+r==a);
+    assert(r<b);
+  }
+
+  // signed division rounds towards zero
+  signed char c, d;
+  if(d!=0 && !(c==-128 && d==-1))
+    assert((c/d)*d+c%d==c);
+
+  return 0;
+}
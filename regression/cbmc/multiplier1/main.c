@@ -0,0 +1,19 @@
+#include <assert.h>
+
+int main()
+{
+  unsigned x;
+
+  // constant multiplication and division by powers of two
+  assert(x*8==x<<3);
+  assert((x/16)*16+x%16==x);
+  assert(x*0x9E3779B1u*0x0E8B2F51u==x);
+
+  // non-constant multiplication
+  unsigned short a, b;
+  unsigned long long p=(unsigned long long)a*b;
+  assert(p<=0xFFFE0001ull);
+  assert(a*b==b*a);
+
+  return 0;
+}
@@ -0,0 +1,16 @@
+int main()
+{
+  int x;
+  int y;
+
+  if(x > 10)
+    y = 1;
+  else
+    y = 2;
+
+  __CPROVER_assert(y == 1 || x <= 10, "consistent");
+  __CPROVER_assert(y != 1, "then-branch");
+  __CPROVER_assert(y != 2, "else-branch");
+
+  return 0;
+}
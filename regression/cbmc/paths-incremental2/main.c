@@ -0,0 +1,12 @@
+int main()
+{
+  unsigned char x;
+  int a[4];
+
+  if(x<4)
+    a[x]=1;
+
+  __CPROVER_assert(x>=4 || a[x]==1, "written");
+
+  return 0;
+}
@@ -0,0 +1,19 @@
+int main()
+{
+  unsigned x;
+  unsigned bits=0;
+
+  // each branch point saved by the first path is handed to a worker
+  if(x&1)
+    bits++;
+  if(x&2)
+    bits++;
+  if(x&4)
+    bits++;
+
+  // only fails on a path in the subtree of the first branch point
+  __CPROVER_assert(bits<3, "not all bits set");
+  __CPROVER_assert(bits<=3, "at most three bits set");
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+int main()
+{
+  int x;
+  int taken=0;
+
+  // a complete binary tree of 16 paths: breadth-first exploration has up
+  // to 7 saved branch points, depth-first exploration at most 4
+  if(x>0)
+    taken++;
+  if(x>10)
+    taken++;
+  if(x>20)
+    taken++;
+  if(x>30)
+    taken++;
+
+  __CPROVER_assert(taken!=4, "x>30 is reachable");
+
+  return 0;
+}
@@ -0,0 +1,11 @@
+int main()
+{
+  int x;
+
+  if(x>0)
+    x--;
+
+  __CPROVER_assert(x<=0 || x>0, "never checked");
+
+  return 0;
+}
@@ -0,0 +1,12 @@
+int main()
+{
+  unsigned x;
+  unsigned y = x * x;
+
+  __CPROVER_assert(y % 2 == x % 2, "holds");
+  __CPROVER_assert(y != 49, "fails");
+  __CPROVER_assert(x + 1 != 0, "fails too");
+  __CPROVER_assert(y == x * x, "holds too");
+
+  return 0;
+}
@@ -0,0 +1,13 @@
+#include <assert.h>
+
+int main()
+{
+  unsigned x, y;
+
+  __CPROVER_assume(x>1 && y>1 && x<1000 && y<1000);
+
+  assert(x*y!=2021);
+  assert(x*y!=2017);
+
+  return 0;
+}
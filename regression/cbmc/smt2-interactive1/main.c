@@ -0,0 +1,18 @@
+int nondet_int();
+
+int main()
+{
+  int x=nondet_int();
+  int y;
+
+  if(x>10)
+    y=x-10;
+  else
+    y=10-x;
+
+  __CPROVER_assert(y>=0 || x<-2147483637, "y is non-negative");
+  __CPROVER_assert(y!=5, "y can be 5");
+  __CPROVER_assert(x<=10 || y<x, "y is smaller");
+
+  return 0;
+}
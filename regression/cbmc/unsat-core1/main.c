@@ -0,0 +1,18 @@
+int square(int a)
+{
+  return a*a;
+}
+
+int main()
+{
+  int x, y;
+  __CPROVER_assume(x>0 && x<10);
+
+  // does not matter for the assertion
+  y=square(x);
+
+  int z=x+1;
+  __CPROVER_assert(z>1, "z is positive");
+
+  return y;
+}
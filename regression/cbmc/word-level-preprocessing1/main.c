@@ -0,0 +1,13 @@
+#include <assert.h>
+
+int main()
+{
+  unsigned long long x, y;
+  __CPROVER_assume(x<100 && y<100);
+
+  unsigned long long z=x*y+x;
+  assert(z<=9900);
+  assert(z!=97*89+97);
+
+  return 0;
+}
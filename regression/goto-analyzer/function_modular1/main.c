@@ -0,0 +1,20 @@
+#include <assert.h>
+
+int g;
+
+void f(void)
+{
+  int i=0;
+  while(i<10)
+    i++;
+  g=i;
+  assert(i<=10);
+}
+
+int main()
+{
+  int x=3;
+  f();
+  assert(x<=3);
+  assert(g<=10);
+}
@@ -0,0 +1,17 @@
+#include <assert.h>
+
+int g;
+
+void f(int n)
+{
+  g=1;
+  assert(g==1);
+}
+
+int main()
+{
+  int x=3;
+  f(x);
+  assert(x==3);
+  assert(g==1);
+}
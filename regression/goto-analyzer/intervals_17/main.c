@@ -0,0 +1,15 @@
+int main()
+{
+  int i=0, j=0;
+
+  while(i<1000000)
+  {
+    i++;
+    j=i*2;
+  }
+
+  assert(i<=1000000);
+  assert(i>=1000000);
+  assert(j<=2000000);
+  assert(j<2000000);
+}
@@ -0,0 +1,23 @@
+#include <assert.h>
+
+void f(int x)
+{
+  int y=x;
+  y=y*x;
+  assert(y==9);
+}
+
+int main()
+{
+  int a=2;
+  int b=a+1;
+  f(b);
+
+  if(b==3)
+  {
+    int c=b+7;
+    assert(c==10);
+  }
+
+  assert(b==3);
+}
@@ -0,0 +1,23 @@
+int x;
+
+int f(int a)
+{
+  int b=a+1;
+  b=b*2;
+  return b;
+}
+
+int main()
+{
+  int y=x+1;
+  int z=y*2;
+
+  if(z>10)
+  {
+    z=f(y);
+    y=z-1;
+  }
+
+  x=y+z;
+  return 0;
+}
@@ -0,0 +1,20 @@
+#include <assert.h>
+
+int main()
+{
+  int i, j, k=0;
+
+  for(i=0; i<10; i++)
+  {
+    for(j=0; j<10; j++)
+    {
+      assert(j>=0 && j<10);
+      k++;
+    }
+
+    assert(j>=10);
+  }
+
+  assert(i>=10);
+  assert(k>=0);
+}
@@ -11,14 +11,20 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "ai.h"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <list>
 #include <memory>
+#include <set>
 #include <sstream>
 
 #include <util/simplify_expr.h>
 #include <util/std_expr.h>
 #include <util/std_code.h>
 
+#include "call_graph.h"
+#include "dirty.h"
 #include "is_threaded.h"
 
 jsont ai_domain_baset::output_json(
@@ -268,10 +274,13 @@ void ai_baset::initialize(const goto_functionst::goto_functiont &goto_function)
 
 void ai_baset::initialize(const goto_programt &goto_program)
 {
+  find_block_heads(goto_program);
+
   // we mark everything as unreachable as starting point
 
   forall_goto_program_instructions(i_it, goto_program)
-    get_state(i_it).make_bottom();
+    if(is_block_head(i_it))
+      get_state(i_it).make_bottom();
 }
 
 void ai_baset::initialize(const goto_functionst &goto_functions)
@@ -304,13 +313,34 @@ bool ai_baset::fixedpoint(
 {
   working_sett working_set;
 
+  find_widening_points(goto_program);
+  find_block_heads(goto_program);
+
+  if(sparse_states && !sparse_ns)
+    sparse_ns=util_make_unique<namespacet>(ns);
+
   // Put the first location in the working set
   if(!goto_program.empty())
+  {
     put_in_working_set(
       working_set,
       goto_program.instructions.begin());
 
+    iteration_statistics[goto_program.instructions.begin()->function]
+      .fixedpoints++;
+  }
+
   bool new_data=false;
+  const std::size_t previous_widenings=widenings;
+
+  if(weak_topological_order)
+  {
+    const wtot &wto=get_wto(goto_program);
+    stabilise(
+      wto, 0, wto.size(),
+      working_set, goto_program, goto_functions, ns,
+      new_data);
+  }
 
   while(!working_set.empty())
   {
@@ -320,9 +350,424 @@ bool ai_baset::fixedpoint(
       new_data=true;
   }
 
+  if(widenings!=previous_widenings && narrowing_iterations>0 && can_narrow())
+    narrow_states(goto_program, ns);
+
   return new_data;
 }
 
+/// Visit the locations of the entries of \p wto from \p begin up to \p end
+/// that are in the working set, in this order. Components are iterated
+/// until their head is no longer put back into the working set. As any edge
+/// that goes backwards in a weak topological order goes to the head of a
+/// component that contains its source, the working set then contains none
+/// of these locations.
+void ai_baset::stabilise(
+  const wtot &wto,
+  std::size_t begin,
+  std::size_t end,
+  working_sett &working_set,
+  const goto_programt &goto_program,
+  const goto_functionst &goto_functions,
+  const namespacet &ns,
+  bool &new_data)
+{
+  for(std::size_t i=begin; i<end; )
+  {
+    const wto_entryt &entry=wto[i];
+
+    if(entry.component_end==0)
+    {
+      if(working_set.erase(entry.location->location_number)!=0 &&
+         visit(entry.location, working_set, goto_program, goto_functions, ns))
+        new_data=true;
+
+      i++;
+      continue;
+    }
+
+    // elements of the component may also be entered from before its head
+    do
+    {
+      if(working_set.erase(entry.location->location_number)!=0 &&
+         visit(entry.location, working_set, goto_program, goto_functions, ns))
+        new_data=true;
+
+      stabilise(
+        wto, i+1, entry.component_end,
+        working_set, goto_program, goto_functions, ns,
+        new_data);
+    }
+    while(working_set.find(entry.location->location_number)!=
+          working_set.end());
+
+    i=entry.component_end;
+  }
+}
+
+namespace
+{
+// an element of a partition built by the algorithm of Bourdoncle
+struct wto_elementt
+{
+  std::size_t vertex;
+  // the partition of the component with head vertex, if any
+  std::size_t partition;
+};
+
+// a call of visit or of component in the algorithm of Bourdoncle
+struct wto_framet
+{
+  std::size_t vertex;
+  std::size_t partition;
+  std::size_t next_successor;
+  std::size_t head;
+  bool loop;
+  // the partition of the component, once the frame has become a call of
+  // component
+  std::size_t component_partition;
+};
+}
+
+static const std::size_t no_partition=std::numeric_limits<std::size_t>::max();
+
+/// Append the partition \p p, whose elements are in reverse order, to \p wto
+static void flatten_wto(
+  const std::vector<std::vector<std::size_t>> &partitions,
+  const std::vector<wto_elementt> &elements,
+  const std::vector<ai_baset::locationt> &locations,
+  std::size_t p,
+  std::vector<std::pair<ai_baset::locationt, std::size_t>> &wto)
+{
+  for(auto e_it=partitions[p].rbegin(); e_it!=partitions[p].rend(); ++e_it)
+  {
+    const wto_elementt &element=elements[*e_it];
+    const std::size_t index=wto.size();
+    wto.push_back(std::make_pair(locations[element.vertex], 0));
+
+    if(element.partition!=no_partition)
+    {
+      flatten_wto(partitions, elements, locations, element.partition, wto);
+      wto[index].second=wto.size();
+    }
+  }
+}
+
+/// The weak topological order of the instructions of \p goto_program that
+/// are reachable from its beginning, computed with the algorithm of
+/// Bourdoncle. Its recursion is replaced by a stack of frames, as straight
+/// line code can be long.
+const ai_baset::wtot &ai_baset::get_wto(const goto_programt &goto_program)
+{
+  std::pair<std::unordered_map<const goto_programt *, wtot>::iterator, bool>
+    entry=wtos.insert(std::make_pair(&goto_program, wtot()));
+
+  wtot &wto=entry.first->second;
+
+  if(!entry.second || goto_program.empty())
+    return wto;
+
+  std::vector<locationt> locations;
+  std::unordered_map<const goto_programt::instructiont *, std::size_t> index;
+
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    index[&*i_it]=locations.size();
+    locations.push_back(i_it);
+  }
+
+  std::vector<std::vector<std::size_t>> successors(locations.size());
+
+  for(std::size_t v=0; v<locations.size(); v++)
+    for(const auto &successor : goto_program.get_successors(locations[v]))
+      if(successor!=goto_program.instructions.end())
+        successors[v].push_back(index.at(&*successor));
+
+  const std::size_t infinity=std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> dfn(locations.size(), 0);
+  std::vector<std::size_t> stack;
+  std::size_t num=0;
+
+  std::vector<wto_elementt> elements;
+  // partition 0 is the whole order
+  std::vector<std::vector<std::size_t>> partitions(1);
+  std::vector<wto_framet> frames;
+
+  auto start_visit=[&](std::size_t v, std::size_t partition)
+  {
+    stack.push_back(v);
+    dfn[v]=++num;
+    wto_framet frame={ v, partition, 0, dfn[v], false, no_partition };
+    frames.push_back(frame);
+  };
+
+  start_visit(0, 0);
+
+  // the head returned by the visit that has finished last
+  std::size_t returned_head=0;
+  bool returned=false;
+
+  while(!frames.empty())
+  {
+    wto_framet &frame=frames.back();
+    const std::vector<std::size_t> &frame_successors=successors[frame.vertex];
+
+    if(frame.component_partition==no_partition)
+    {
+      // visit
+      if(returned && returned_head<=frame.head)
+      {
+        frame.head=returned_head;
+        frame.loop=true;
+      }
+
+      returned=false;
+
+      if(frame.next_successor<frame_successors.size())
+      {
+        const std::size_t w=frame_successors[frame.next_successor++];
+
+        if(dfn[w]==0)
+          start_visit(w, frame.partition);
+        else if(dfn[w]<=frame.head)
+        {
+          frame.head=dfn[w];
+          frame.loop=true;
+        }
+
+        continue;
+      }
+
+      if(frame.head==dfn[frame.vertex])
+      {
+        dfn[frame.vertex]=infinity;
+        std::size_t element=stack.back();
+        stack.pop_back();
+
+        if(frame.loop)
+        {
+          while(element!=frame.vertex)
+          {
+            dfn[element]=0;
+            element=stack.back();
+            stack.pop_back();
+          }
+
+          // continue as component(vertex)
+          frame.component_partition=partitions.size();
+          frame.next_successor=0;
+          partitions.emplace_back();
+          continue;
+        }
+
+        partitions[frame.partition].push_back(elements.size());
+        elements.push_back(wto_elementt{ frame.vertex, no_partition });
+      }
+    }
+    else
+    {
+      // component, which ignores the heads returned by its visits
+      returned=false;
+
+      if(frame.next_successor<frame_successors.size())
+      {
+        const std::size_t w=frame_successors[frame.next_successor++];
+
+        if(dfn[w]==0)
+          start_visit(w, frame.component_partition);
+
+        continue;
+      }
+
+      partitions[frame.partition].push_back(elements.size());
+      elements.push_back(
+        wto_elementt{ frame.vertex, frame.component_partition });
+    }
+
+    returned_head=frame.head;
+    returned=true;
+    frames.pop_back();
+  }
+
+  std::vector<std::pair<locationt, std::size_t>> flat;
+  flatten_wto(partitions, elements, locations, 0, flat);
+
+  wto.reserve(flat.size());
+  for(const auto &f : flat)
+    wto.push_back(wto_entryt{ f.first, f.second });
+
+  return wto;
+}
+
+/// Loops are cut at the targets of backwards gotos, which include the heads
+/// of all natural loops, and every cycle of the program contains one. With
+/// a weak topological order, they are cut at the heads of its components.
+void ai_baset::find_widening_points(const goto_programt &goto_program)
+{
+  if(!programs_with_widening_points.insert(&goto_program).second)
+    return;
+
+  if(weak_topological_order)
+  {
+    for(const auto &entry : get_wto(goto_program))
+      if(entry.component_end!=0)
+        widening_points.insert(std::make_pair(entry.location, 0));
+
+    return;
+  }
+
+  forall_goto_program_instructions(i_it, goto_program)
+    if(i_it->is_backwards_goto())
+      for(const auto &target : i_it->targets)
+        widening_points.insert(std::make_pair(target, 0));
+}
+
+/// The states of all instructions of a basic block but its head follow
+/// from the state of the head. These heads are the first instruction, the
+/// successors of all instructions that do not just fall through to the next
+/// one, function calls and the instructions after them, and the ends of
+/// functions, whose states are needed for the function call edges.
+void ai_baset::find_block_heads(const goto_programt &goto_program)
+{
+  if(!sparse_states ||
+     goto_program.empty() ||
+     !programs_with_block_heads.insert(&goto_program).second)
+    return;
+
+  block_heads.insert(goto_program.instructions.begin());
+
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    const locationt next=std::next(i_it);
+    const std::list<locationt> successors=goto_program.get_successors(i_it);
+
+    if(i_it->is_function_call() || i_it->is_end_function())
+      block_heads.insert(i_it);
+    else if(successors.size()==1 && successors.front()==next)
+      continue;
+
+    for(const auto &successor : successors)
+      if(successor!=goto_program.instructions.end())
+        block_heads.insert(successor);
+
+    if(next!=goto_program.instructions.end())
+      block_heads.insert(next);
+  }
+}
+
+/// Apply the instructions of the block that starts at \p l but its last
+/// one to the state of \p l, which is stored in \p state unless the block
+/// has a single instruction.
+/// \return The last instruction of the block
+ai_baset::locationt ai_baset::block_end(
+  locationt l,
+  std::unique_ptr<statet> &state,
+  const goto_programt &goto_program,
+  const namespacet &ns)
+{
+  for(locationt next=std::next(l);
+      next!=goto_program.instructions.end() && !is_block_head(next);
+      l=next++)
+  {
+    if(!state)
+      state=make_temporary_state(get_state(l));
+
+    state->transform(l, next, *this, ns);
+  }
+
+  return l;
+}
+
+bool ai_baset::merge_or_widen(const statet &src, locationt from, locationt to)
+{
+  widening_pointst::iterator w_it=widening_points.find(to);
+
+  if(w_it==widening_points.end())
+    return merge(src, from, to);
+
+  if(w_it->second<widening_delay)
+  {
+    if(!merge(src, from, to))
+      return false;
+
+    w_it->second++;
+    return true;
+  }
+
+  if(!widen(src, from, to))
+    return false;
+
+  widenings++;
+  return true;
+}
+
+/// Starting from the fixedpoint, recompute the state of every location of
+/// the program as the join of what its predecessors propagate to it, and
+/// narrow the previous states at widening points with these, until nothing
+/// is narrowed. As the states only decrease and stay a post-fixedpoint, this
+/// is sound for any number of iterations. The states at the beginning of
+/// the program and after function calls depend on other programs and are
+/// kept. With sparse states, this is done for the block heads only.
+void ai_baset::narrow_states(
+  const goto_programt &goto_program,
+  const namespacet &ns)
+{
+  std::map<unsigned, std::vector<locationt>> predecessors;
+
+  forall_goto_program_instructions(i_it, goto_program)
+    for(const auto &successor : goto_program.get_successors(i_it))
+      if(successor!=goto_program.instructions.end())
+        predecessors[successor->location_number].push_back(i_it);
+
+  for(std::size_t iteration=0; iteration<narrowing_iterations; iteration++)
+  {
+    bool narrowed=false;
+
+    forall_goto_program_instructions(l, goto_program)
+    {
+      if(l==goto_program.instructions.begin() || !is_block_head(l))
+        continue;
+
+      const std::vector<locationt> &from=predecessors[l->location_number];
+
+      if(std::any_of(
+           from.begin(),
+           from.end(),
+           [](const locationt &p) { return p->is_function_call(); }))
+        continue;
+
+      std::unique_ptr<statet> previous(make_temporary_state(get_state(l)));
+      get_state(l).make_bottom();
+
+      for(const auto &p : from)
+      {
+        // the state before p follows from the head of its block
+        locationt head=p;
+        while(!is_block_head(head))
+          --head;
+
+        const statet &head_state=head==l?*previous:get_state(head);
+        if(head_state.is_bottom())
+          continue;
+
+        std::unique_ptr<statet> tmp_state(make_temporary_state(head_state));
+        for(; head!=p; ++head)
+          tmp_state->transform(head, std::next(head), *this, ns);
+
+        tmp_state->transform(p, l, *this, ns);
+        merge(*tmp_state, p, l);
+      }
+
+      if(widening_points.find(l)!=widening_points.end() &&
+         narrow(*previous, l))
+        narrowed=true;
+    }
+
+    if(!narrowed)
+      break;
+  }
+}
+
 bool ai_baset::visit(
   locationt l,
   working_sett &working_set,
@@ -332,7 +777,14 @@ bool ai_baset::visit(
 {
   bool new_data=false;
 
-  statet &current=get_state(l);
+  iteration_statistics[l->function].visits++;
+
+  // with sparse states, l is a block head, and we go to the end of its
+  // block first
+  std::unique_ptr<statet> block_state;
+  l=block_end(l, block_state, goto_program, ns);
+
+  const statet &current=block_state?*block_state:get_state(l);
 
   for(const auto &to_l : goto_program.get_successors(l))
   {
@@ -367,7 +819,7 @@ bool ai_baset::visit(
 
       new_values.transform(l, to_l, *this, ns);
 
-      if(merge(new_values, l, to_l))
+      if(merge_or_widen(new_values, l, to_l))
         have_new_values=true;
     }
 
@@ -470,12 +922,15 @@ bool ai_baset::do_function_call_rec(
     if(it==goto_functions.function_map.end())
       throw "failed to find function "+id2string(identifier);
 
-    new_data=do_function_call(
-      l_call, l_return,
-      goto_functions,
-      it,
-      arguments,
-      ns);
+    if(function_modular)
+      new_data=do_summarised_function_call(l_call, l_return, identifier, ns);
+    else
+      new_data=do_function_call(
+        l_call, l_return,
+        goto_functions,
+        it,
+        arguments,
+        ns);
   }
   else if(function.id()==ID_if)
   {
@@ -523,10 +978,213 @@ bool ai_baset::do_function_call_rec(
   return new_data;
 }
 
+/// The call edge of a function-modular analysis, which treats the call like
+/// one of a function without body, and then forgets what the called
+/// function may modify
+bool ai_baset::do_summarised_function_call(
+  locationt l_call, locationt l_return,
+  const irep_idt &identifier,
+  const namespacet &ns)
+{
+  // initialize state, if necessary
+  get_state(l_return);
+
+  std::unique_ptr<statet> tmp_state(make_temporary_state(get_state(l_call)));
+  tmp_state->transform(l_call, l_return, *this, ns);
+
+  const exprt &lhs=to_code_function_call(l_call->code).lhs();
+  if(lhs.is_not_nil())
+  {
+    goto_programt assign_lhs;
+    goto_programt::targett a=assign_lhs.add_instruction(ASSIGN);
+    a->code=code_assignt(lhs, side_effect_expr_nondett(lhs.type()));
+    a->function=l_call->function;
+    tmp_state->transform(a, l_return, *this, ns);
+  }
+
+  std::map<irep_idt, goto_programt>::const_iterator s_it=
+    side_effects.find(identifier);
+
+  if(s_it!=side_effects.end())
+    forall_goto_program_instructions(i_it, s_it->second)
+      tmp_state->transform(i_it, l_return, *this, ns);
+
+  return merge(*tmp_state, l_call, l_return);
+}
+
+/// Collect the symbols that an assignment to \p lhs may modify.
+/// \return true if the assignment may write through a pointer
+static bool assigned_symbols(const exprt &lhs, std::set<irep_idt> &symbols)
+{
+  if(lhs.id()==ID_symbol)
+  {
+    symbols.insert(to_symbol_expr(lhs).get_identifier());
+    return false;
+  }
+  else if(lhs.id()==ID_index ||
+          lhs.id()==ID_member ||
+          lhs.id()==ID_typecast ||
+          lhs.id()==ID_byte_extract_little_endian ||
+          lhs.id()==ID_byte_extract_big_endian)
+    return assigned_symbols(lhs.op0(), symbols);
+  else if(lhs.id()==ID_if)
+  {
+    const bool true_case=assigned_symbols(to_if_expr(lhs).true_case(), symbols);
+    const bool false_case=
+      assigned_symbols(to_if_expr(lhs).false_case(), symbols);
+    return true_case || false_case;
+  }
+  else
+    return true;
+}
+
+/// Compute the strongly connected components of the call graph, callees
+/// first, and summarise what the functions of each component may modify
+/// that their callers can see: variables with static lifetime, including
+/// return values, that they or the functions they call assign, and all
+/// variables whose address is taken if any of them writes through a
+/// pointer.
+void ai_baset::summarise_functions(
+  const goto_functionst &goto_functions,
+  const namespacet &ns)
+{
+  side_effects.clear();
+  components.clear();
+
+  const call_grapht::directed_grapht call_graph=
+    call_grapht(goto_functions).get_directed_graph();
+
+  // functions that neither call nor are called are not in the call graph
+  forall_goto_functions(f_it, goto_functions)
+    if(!call_graph.get_node_index(f_it->first))
+      components.push_back(componentt{ f_it->first });
+
+  // lower numbers are closer to the leaves, i.e., the callees
+  std::vector<call_grapht::directed_grapht::node_indext> component_numbers(
+    call_graph.size());
+  const std::size_t first=components.size();
+  components.resize(first+call_graph.SCCs(component_numbers));
+
+  for(std::size_t n=0; n<call_graph.size(); n++)
+    components[first+component_numbers[n]].push_back(call_graph[n].function);
+
+  const dirtyt dirty(goto_functions);
+  std::map<irep_idt, std::set<irep_idt>> modified;
+
+  for(const auto &component : components)
+  {
+    std::set<irep_idt> assigned, component_modified;
+    bool through_pointer=false;
+
+    for(const auto &identifier : component)
+    {
+      goto_functionst::function_mapt::const_iterator f_it=
+        goto_functions.function_map.find(identifier);
+
+      if(f_it==goto_functions.function_map.end())
+        continue;
+
+      forall_goto_program_instructions(i_it, f_it->second.body)
+      {
+        if(i_it->is_assign())
+        {
+          if(assigned_symbols(to_code_assign(i_it->code).lhs(), assigned))
+            through_pointer=true;
+        }
+        else if(i_it->is_function_call())
+        {
+          const code_function_callt &call=to_code_function_call(i_it->code);
+
+          if(call.lhs().is_not_nil() &&
+             assigned_symbols(call.lhs(), assigned))
+            through_pointer=true;
+
+          // callees in this component are summarised along with it
+          if(call.function().id()==ID_symbol)
+          {
+            const auto m_it=modified.find(
+              to_symbol_expr(call.function()).get_identifier());
+
+            if(m_it!=modified.end())
+              component_modified.insert(
+                m_it->second.begin(), m_it->second.end());
+          }
+        }
+      }
+    }
+
+    // locals of the functions are not visible to their callers
+    for(const auto &identifier : assigned)
+    {
+      const symbolt *symbol;
+      if(!ns.lookup(identifier, symbol) && symbol->is_static_lifetime)
+        component_modified.insert(identifier);
+    }
+
+    if(through_pointer)
+      component_modified.insert(
+        dirty.get_dirty_ids().begin(), dirty.get_dirty_ids().end());
+
+    for(const auto &identifier : component)
+    {
+      goto_programt &effects=side_effects[identifier];
+
+      for(const auto &m : component_modified)
+      {
+        const symbolt *symbol;
+        if(ns.lookup(m, symbol) || symbol->type.id()==ID_code)
+          continue;
+
+        goto_programt::targett a=effects.add_instruction(ASSIGN);
+        a->code=code_assignt(
+          symbol->symbol_expr(), side_effect_expr_nondett(symbol->type));
+        a->function=identifier;
+      }
+
+      modified[identifier]=component_modified;
+    }
+  }
+}
+
+void ai_baset::analyse_component(
+  const componentt &component,
+  const goto_functionst &goto_functions,
+  const namespacet &ns)
+{
+  for(const auto &identifier : component)
+  {
+    goto_functionst::function_mapt::const_iterator f_it=
+      goto_functions.function_map.find(identifier);
+
+    if(f_it==goto_functions.function_map.end() ||
+       !f_it->second.body_available())
+      continue;
+
+    entry_state(f_it->second.body);
+    fixedpoint(f_it->second.body, goto_functions, ns);
+  }
+}
+
+void ai_baset::function_modular_fixedpoint(
+  const goto_functionst &goto_functions,
+  const namespacet &ns)
+{
+  summarise_functions(goto_functions, ns);
+
+  for(const auto &component : components)
+    analyse_component(component, goto_functions, ns);
+}
+
 void ai_baset::sequential_fixedpoint(
   const goto_functionst &goto_functions,
   const namespacet &ns)
 {
+  if(function_modular)
+  {
+    function_modular_fixedpoint(goto_functions, ns);
+    return;
+  }
+
   goto_functionst::function_mapt::const_iterator
     f_it=goto_functions.function_map.find(goto_functions.entry_point());
 
@@ -538,6 +1196,10 @@ void ai_baset::concurrent_fixedpoint(
   const goto_functionst &goto_functions,
   const namespacet &ns)
 {
+  if(sparse_states || function_modular)
+    throw "sparse states and function-modular analysis are not supported "
+      "by concurrent analyses";
+
   sequential_fixedpoint(goto_functions, ns);
 
   is_threadedt is_threaded(goto_functions);
@@ -15,6 +15,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <util/json.h>
 #include <util/xml.h>
@@ -105,6 +109,34 @@ public:
   // PRECONDITION(from.is_dereferenceable(), "Must not be _::end()")
   // PRECONDITION(to.is_dereferenceable(), "Must not be _::end()")
 
+  // Domains with infinite ascending chains should also add
+  //
+  //   bool widen(const T &b, locationt from, locationt to);
+  //   bool narrow(const T &b);
+  //
+  // widen is used instead of merge at widening points, i.e., the targets
+  // of backwards gotos, once their state has changed more often than the
+  // widening delay. It must over-approximate the join, and any sequence of
+  // widenings must stabilize. Return true if "this" has changed.
+  //
+  // narrow is used once the fixedpoint has been reached: "this" is the
+  // state at a widening point and "b" is the join of what its predecessors
+  // propagate to it, which is contained in "this". It must set "this" to a
+  // state between "b" and "this" such that any sequence of narrowings
+  // stabilizes. Return true if "this" has changed.
+  //
+  // Without widen, merge is used; without narrow, there is no narrowing.
+  //
+  // In function-modular mode, "from" may also be an assignment of a
+  // nondeterministic value that stands for a side effect of the function
+  // called at the instruction before "to".
+
+  // States are copied using the copy constructor, for each edge that is
+  // followed and for the states that are recomputed when they are sparse.
+  // Domains with large states should keep them in copy-on-write containers,
+  // such as reference_counting or sharing_mapt, so that copies share what
+  // does not change, as interval_domaint does.
+
   // This method allows an expression to be simplified / evaluated using the
   // current state.  It is used to evaluate assertions and in program
   // simplification
@@ -193,8 +225,111 @@ public:
 
   virtual void clear()
   {
+    widening_points.clear();
+    programs_with_widening_points.clear();
+    widenings=0;
+    block_heads.clear();
+    programs_with_block_heads.clear();
+    sparse_ns.reset();
+    side_effects.clear();
+    components.clear();
+    wtos.clear();
+    iteration_statistics.clear();
+  }
+
+  /// Widen the states at the targets of backwards gotos once these have
+  /// changed \p delay times. This only affects domains that provide widen.
+  void set_widening_delay(std::size_t delay)
+  {
+    widening_delay=delay;
+  }
+
+  /// After reaching the fixedpoint of a function in which states have been
+  /// widened, recompute its states up to \p iterations times, narrowing
+  /// those at the widening points. This only affects domains that provide
+  /// narrow.
+  void set_narrowing_iterations(std::size_t iterations)
+  {
+    narrowing_iterations=iterations;
+  }
+
+  /// Only store the states at the heads of basic blocks, i.e., at the
+  /// beginning of programs, at the targets of jumps, after branches and
+  /// around function calls. The states of the other instructions are
+  /// recomputed from the head of their block when they are asked for. This
+  /// must be set before the analysis is run, and is not supported by
+  /// concurrent analyses.
+  void set_sparse_states(bool sparse)
+  {
+    sparse_states=sparse;
+  }
+
+  /// Analyse each function on its own, starting from the entry state of the
+  /// domain rather than from the states at its call sites. A call then
+  /// takes the state at the call site to the return site by forgetting what
+  /// the called function may modify, which is summarised bottom-up over the
+  /// strongly connected components of the call graph. This is less precise,
+  /// but the components can be analysed independently of their callers. It
+  /// is not supported by concurrent analyses or by dependence_grapht.
+  void set_function_modular(bool modular)
+  {
+    function_modular=modular;
+  }
+
+  /// Iterate in a weak topological order of the instructions of each
+  /// program rather than in the order of their location numbers, as in
+  /// F. Bourdoncle, Efficient chaotic iteration strategies with widenings,
+  /// FMPA 1993. Each component of this order, i.e., each loop, is
+  /// stabilised before the instructions after it are visited, innermost
+  /// first, and the heads of the components are the widening points.
+  void set_weak_topological_order(bool wto)
+  {
+    weak_topological_order=wto;
+  }
+
+  struct iteration_statisticst
+  {
+    // how often the fixedpoint of the function has been computed
+    std::size_t fixedpoints=0;
+    // how often its instructions have been visited
+    std::size_t visits=0;
+  };
+
+  typedef std::map<irep_idt, iteration_statisticst> iteration_statistics_mapt;
+
+  /// The number of iterations for each function, since the last clear()
+  const iteration_statistics_mapt &get_iteration_statistics() const
+  {
+    return iteration_statistics;
+  }
+
+  typedef std::vector<irep_idt> componentt;
+
+  /// Prepare the function-modular analysis of \p goto_functions, computing
+  /// its components and the summaries of its functions, without analysing
+  /// any of them. The components can then be analysed in any order, which
+  /// operator() does callees first.
+  void prepare_function_modular(
+    const goto_functionst &goto_functions,
+    const namespacet &ns)
+  {
+    initialize(goto_functions);
+    summarise_functions(goto_functions, ns);
   }
 
+  /// The strongly connected components of the call graph, callees first, as
+  /// computed by prepare_function_modular
+  const std::vector<componentt> &function_components() const
+  {
+    return components;
+  }
+
+  /// Analyse the functions of a component of a function-modular analysis
+  void analyse_component(
+    const componentt &component,
+    const goto_functionst &goto_functions,
+    const namespacet &ns);
+
   virtual void output(
     const namespacet &ns,
     const goto_functionst &goto_functions,
@@ -343,6 +478,100 @@ protected:
     const goto_functionst &goto_functions,
     const namespacet &ns);
 
+  std::size_t widening_delay=3;
+  std::size_t narrowing_iterations=2;
+
+  // the widening points found so far, with the number of times their state
+  // has changed without widening
+  typedef std::unordered_map<
+    locationt, std::size_t, const_target_hash, pointee_address_equalt>
+    widening_pointst;
+  widening_pointst widening_points;
+  std::unordered_set<const goto_programt *> programs_with_widening_points;
+  std::size_t widenings=0;
+
+  void find_widening_points(const goto_programt &goto_program);
+
+  // true = found something new
+  bool merge_or_widen(const statet &src, locationt from, locationt to);
+
+  void narrow_states(
+    const goto_programt &goto_program,
+    const namespacet &ns);
+
+  bool sparse_states=false;
+
+  typedef std::unordered_set<
+    locationt, const_target_hash, pointee_address_equalt>
+    block_headst;
+  block_headst block_heads;
+  std::unordered_set<const goto_programt *> programs_with_block_heads;
+
+  // to recompute the states that are not stored
+  std::unique_ptr<namespacet> sparse_ns;
+
+  void find_block_heads(const goto_programt &goto_program);
+
+  // all locations are block heads unless the states are sparse
+  bool is_block_head(locationt l) const
+  {
+    return !sparse_states || block_heads.find(l)!=block_heads.end();
+  }
+
+  locationt block_end(
+    locationt l,
+    std::unique_ptr<statet> &state,
+    const goto_programt &goto_program,
+    const namespacet &ns);
+
+  bool weak_topological_order=false;
+
+  // A weak topological order, flattened: a component consists of the
+  // entries from its head up to the end of the component.
+  struct wto_entryt
+  {
+    locationt location;
+    // the index after the last entry of the component of which this is the
+    // head, or zero if this is not the head of a component
+    std::size_t component_end;
+  };
+
+  typedef std::vector<wto_entryt> wtot;
+  std::unordered_map<const goto_programt *, wtot> wtos;
+
+  const wtot &get_wto(const goto_programt &goto_program);
+
+  void stabilise(
+    const wtot &wto,
+    std::size_t begin,
+    std::size_t end,
+    working_sett &working_set,
+    const goto_programt &goto_program,
+    const goto_functionst &goto_functions,
+    const namespacet &ns,
+    bool &new_data);
+
+  iteration_statistics_mapt iteration_statistics;
+
+  bool function_modular=false;
+
+  // what functions may modify, as assignments of nondeterministic values
+  std::map<irep_idt, goto_programt> side_effects;
+  std::vector<componentt> components;
+
+  void summarise_functions(
+    const goto_functionst &goto_functions,
+    const namespacet &ns);
+
+  void function_modular_fixedpoint(
+    const goto_functionst &goto_functions,
+    const namespacet &ns);
+
+  bool do_summarised_function_call(
+    locationt l_call, locationt l_return,
+    const irep_idt &identifier,
+    const namespacet &ns);
+
   // function calls
   bool do_function_call_rec(
     locationt l_call, locationt l_return,
@@ -361,6 +590,19 @@ protected:
   // abstract methods
 
   virtual bool merge(const statet &src, locationt from, locationt to)=0;
+  virtual bool widen(const statet &src, locationt from, locationt to)
+  {
+    return merge(src, from, to);
+  }
+  // replace the state at l by its narrowing with the previous one
+  virtual bool narrow(const statet &previous, locationt l)
+  {
+    return false;
+  }
+  virtual bool can_narrow() const
+  {
+    return false;
+  }
   // for concurrent fixedpoint
   virtual bool merge_shared(
     const statet &src,
@@ -388,7 +630,7 @@ public:
   {
     typename state_mapt::iterator it=state_map.find(l);
     if(it==state_map.end())
-      throw "failed to find state";
+      return recomputed_state(l);
 
     return it->second;
   }
@@ -397,7 +639,7 @@ public:
   {
     typename state_mapt::const_iterator it=state_map.find(l);
     if(it==state_map.end())
-      throw "failed to find state";
+      return recomputed_state(l);
 
     return it->second;
   }
@@ -411,6 +653,8 @@ public:
   void clear() override
   {
     state_map.clear();
+    block_states.clear();
+    block_states_head=nullptr;
     ai_baset::clear();
   }
 
@@ -420,20 +664,61 @@ protected:
       state_mapt;
   state_mapt state_map;
 
+  // With sparse states, the states recomputed for the block that has been
+  // asked for last. References to these stay valid until a state of
+  // another block is recomputed.
+  mutable state_mapt block_states;
+  mutable const goto_programt::instructiont *block_states_head=nullptr;
+
+  domainT &recomputed_state(locationt l) const
+  {
+    typename state_mapt::iterator it=block_states.find(l);
+    if(it!=block_states.end())
+      return it->second;
+
+    if(!sparse_states || is_block_head(l))
+      throw "failed to find state";
+
+    // l is not a block head, so it can only be reached from the instruction
+    // before it, and so can all instructions of its block but the head
+    locationt from=std::prev(l);
+    while(!is_block_head(from) && block_states.find(from)==block_states.end())
+      --from;
+
+    if(is_block_head(from) && block_states_head!=&*from)
+    {
+      block_states.clear();
+      block_states_head=&*from;
+    }
+
+    typename state_mapt::const_iterator from_it=state_map.find(from);
+    domainT state=
+      from_it!=state_map.end()?from_it->second:block_states.at(from);
+
+    ait &ai=const_cast<ait &>(*this);
+
+    for(; from!=l; ++from)
+    {
+      // as without sparse states, unreachable instructions stay bottom, and
+      // the others have been reached by fixedpoint, which sets sparse_ns
+      if(!state.is_bottom())
+        state.transform(from, std::next(from), ai, *sparse_ns);
+      block_states[std::next(from)]=state;
+    }
+
+    return block_states.at(l);
+  }
+
   // this one creates states, if need be
   virtual statet &get_state(locationt l) override
   {
     return state_map[l]; // calls default constructor
   }
 
-  // this one just finds states
+  // this one just finds states, or recomputes them if they are sparse
   const statet &find_state(locationt l) const override
   {
-    typename state_mapt::const_iterator it=state_map.find(l);
-    if(it==state_map.end())
-      throw "failed to find state";
-
-    return it->second;
+    return (*this)[l];
   }
 
   bool merge(const statet &src, locationt from, locationt to) override
@@ -448,6 +733,70 @@ protected:
     return util_make_unique<domainT>(static_cast<const domainT &>(s));
   }
 
+  bool widen(const statet &src, locationt from, locationt to) override
+  {
+    statet &dest=get_state(to);
+    return domain_widen(
+      static_cast<domainT &>(dest),
+      static_cast<const domainT &>(src), from, to, 0);
+  }
+
+  bool narrow(const statet &previous, locationt l) override
+  {
+    domainT &dest=static_cast<domainT &>(get_state(l));
+    domainT result=static_cast<const domainT &>(previous);
+    const bool changed=domain_narrow(result, dest, 0);
+    dest=std::move(result);
+    return changed;
+  }
+
+  bool can_narrow() const override
+  {
+    return has_narrow<domainT>(0);
+  }
+
+  // use the widen and narrow of the domain if it has them
+  template<typename T>
+  static auto domain_widen(
+    T &dest, const T &src, locationt from, locationt to, int)
+    -> decltype(dest.widen(src, from, to))
+  {
+    return dest.widen(src, from, to);
+  }
+
+  template<typename T>
+  static bool domain_widen(
+    T &dest, const T &src, locationt from, locationt to, long)
+  {
+    return dest.merge(src, from, to);
+  }
+
+  template<typename T>
+  static auto domain_narrow(T &dest, const T &src, int)
+    -> decltype(dest.narrow(src))
+  {
+    return dest.narrow(src);
+  }
+
+  template<typename T>
+  static bool domain_narrow(T &, const T &, long)
+  {
+    return false;
+  }
+
+  template<typename T>
+  static constexpr auto has_narrow(int)
+    -> decltype(std::declval<T &>().narrow(std::declval<const T &>()), bool())
+  {
+    return true;
+  }
+
+  template<typename T>
+  static constexpr bool has_narrow(long)
+  {
+    return false;
+  }
+
   void fixedpoint(
     const goto_functionst &goto_functions,
     const namespacet &ns) override
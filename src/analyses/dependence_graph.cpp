@@ -192,6 +192,11 @@ void dep_graph_domaint::transform(
   dependence_grapht *dep_graph=dynamic_cast<dependence_grapht*>(&ai);
   assert(dep_graph!=nullptr);
 
+  // this becomes the state of 'to', which is not stored if the states are
+  // sparse and 'to' is not the head of a basic block
+  has_values=tvt::unknown();
+  node_id=dep_graph->location_node(to);
+
   // propagate control dependencies across function calls
   if(from->is_function_call())
   {
@@ -300,9 +305,9 @@ void dependence_grapht::add_dep(
   goto_programt::const_targett from,
   goto_programt::const_targett to)
 {
-  const node_indext n_from=state_map[from].get_node_id();
+  const node_indext n_from=node_map.at(from);
   assert(n_from<size());
-  const node_indext n_to=state_map[to].get_node_id();
+  const node_indext n_to=node_map.at(to);
   assert(n_to<size());
 
   // add_edge is redundant as the subsequent operations also insert
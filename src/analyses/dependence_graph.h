@@ -15,6 +15,8 @@ Date: August 2013
 #ifndef CPROVER_ANALYSES_DEPENDENCE_GRAPH_H
 #define CPROVER_ANALYSES_DEPENDENCE_GRAPH_H
 
+#include <unordered_map>
+
 #include <util/graph.h>
 #include <util/threeval.h>
 
@@ -205,6 +207,11 @@ public:
 
   void initialize(const goto_programt &goto_program)
   {
+    // with sparse states, not all instructions have a state, but all of
+    // them have a node
+    forall_goto_program_instructions(i_it, goto_program)
+      location_node(i_it);
+
     ait<dep_graph_domaint>::initialize(goto_program);
 
     if(!goto_program.empty())
@@ -217,9 +224,12 @@ public:
 
   void finalize()
   {
-    for(const auto &location_state : state_map)
+    // the nodes are in the order of the instructions, which is the order in
+    // which states that are not stored are best recomputed
+    for(node_indext n=0; n<size(); n++)
     {
-      location_state.second.populate_dep_graph(*this, location_state.first);
+      const goto_programt::const_targett l=nodes[n].PC;
+      (*this)[l].populate_dep_graph(*this, l);
     }
   }
 
@@ -244,11 +254,19 @@ public:
       state_map.insert(std::make_pair(l, dep_graph_domaint()));
 
     if(entry.second)
-    {
-      const node_indext node_id=add_node();
-      entry.first->second.set_node_id(node_id);
-      nodes[node_id].PC=l;
-    }
+      entry.first->second.set_node_id(location_node(l));
+
+    return entry.first->second;
+  }
+
+  /// The node of the instruction \p l, which is added if need be
+  node_indext location_node(goto_programt::const_targett l)
+  {
+    std::pair<node_mapt::iterator, bool> entry=
+      node_map.insert(std::make_pair(l, size()));
+
+    if(entry.second)
+      nodes[add_node()].PC=l;
 
     return entry.first->second;
   }
@@ -256,6 +274,12 @@ public:
 protected:
   const namespacet &ns;
 
+  typedef std::unordered_map<
+    goto_programt::const_targett, node_indext,
+    const_target_hash, pointee_address_equalt>
+    node_mapt;
+  node_mapt node_map;
+
   post_dominators_mapt post_dominators;
   reaching_definitions_analysist rd;
 };
@@ -11,6 +11,9 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "interval_domain.h"
 
+#include <algorithm>
+#include <iterator>
+
 #ifdef DEBUG
 #include <iostream>
 #include <langapi/language_util.h>
@@ -18,6 +21,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <util/simplify_expr.h>
 #include <util/std_expr.h>
+#include <util/std_types.h>
 #include <util/arith_tools.h>
 
 void interval_domaint::output(
@@ -31,7 +35,7 @@ void interval_domaint::output(
     return;
   }
 
-  for(const auto &interval : int_map)
+  for(const auto &interval : int_map.read())
   {
     if(interval.second.is_top())
       continue;
@@ -43,7 +47,7 @@ void interval_domaint::output(
     out << "\n";
   }
 
-  for(const auto &interval : float_map)
+  for(const auto &interval : float_map.read())
   {
     if(interval.second.is_top())
       continue;
@@ -137,45 +141,222 @@ bool interval_domaint::join(
 
   bool result=false;
 
-  for(int_mapt::iterator it=int_map.begin();
-      it!=int_map.end(); ) // no it++
+  // the join of a map with itself does not change it
+  if(int_map.get_d()!=b.int_map.get_d())
   {
-    // search for the variable that needs to be merged
-    // containers have different size and variable order
-    const int_mapt::const_iterator b_it=b.int_map.find(it->first);
-    if(b_it==b.int_map.end())
+    int_mapt &map=int_map.write();
+    const int_mapt &b_map=b.int_map.read();
+
+    for(int_mapt::iterator it=map.begin();
+        it!=map.end(); ) // no it++
     {
-      it=int_map.erase(it);
-      result=true;
+      // search for the variable that needs to be merged
+      // containers have different size and variable order
+      const int_mapt::const_iterator b_it=b_map.find(it->first);
+      if(b_it==b_map.end())
+      {
+        it=map.erase(it);
+        result=true;
+      }
+      else
+      {
+        integer_intervalt previous=it->second;
+        it->second.join(b_it->second);
+        if(it->second!=previous)
+          result=true;
+
+        it++;
+      }
     }
-    else
+  }
+
+  if(float_map.get_d()!=b.float_map.get_d())
+  {
+    float_mapt &map=float_map.write();
+    const float_mapt &b_map=b.float_map.read();
+
+    for(float_mapt::iterator it=map.begin();
+        it!=map.end(); ) // no it++
     {
-      integer_intervalt previous=it->second;
-      it->second.join(b_it->second);
-      if(it->second!=previous)
+      const float_mapt::const_iterator b_it=b_map.find(it->first);
+      if(b_it==b_map.end())
+      {
+        it=map.erase(it);
         result=true;
+      }
+      else
+      {
+        ieee_float_intervalt previous=it->second;
+        it->second.join(b_it->second);
+        if(it->second!=previous)
+          result=true;
 
-      it++;
+        it++;
+      }
     }
   }
 
-  for(float_mapt::iterator it=float_map.begin();
-      it!=float_map.end(); ) // no it++
+  return result;
+}
+
+/// Sets *this to an over-approximation of the join with b that drops the
+/// bounds that b exceeds, so that repeated widening terminates.
+/// \par parameters: The interval domain, b, to widen this domain with.
+/// \return True if *this has changed, False if there is no change.
+bool interval_domaint::widen(
+  const interval_domaint &b,
+  locationt from,
+  locationt to)
+{
+  if(b.bottom)
+    return false;
+  if(bottom)
+  {
+    *this=b;
+    return true;
+  }
+
+  bool result=false;
+
+  // widening a map with itself does not change it either
+  if(int_map.get_d()!=b.int_map.get_d())
   {
-    const float_mapt::const_iterator b_it=b.float_map.begin();
-    if(b_it==b.float_map.end())
+    int_mapt &map=int_map.write();
+    const int_mapt &b_map=b.int_map.read();
+
+    for(int_mapt::iterator it=map.begin();
+        it!=map.end(); ) // no it++
     {
-      it=float_map.erase(it);
-      result=true;
+      const int_mapt::const_iterator b_it=b_map.find(it->first);
+      if(b_it==b_map.end())
+      {
+        it=map.erase(it);
+        result=true;
+        continue;
+      }
+
+      integer_intervalt &i=it->second;
+      const integer_intervalt &b_i=b_it->second;
+
+      if(i.lower_set && (!b_i.lower_set || b_i.lower<i.lower))
+      {
+        i.lower_set=false;
+        result=true;
+      }
+
+      if(i.upper_set && (!b_i.upper_set || b_i.upper>i.upper))
+      {
+        i.upper_set=false;
+        result=true;
+      }
+
+      if(i.is_top())
+        it=map.erase(it);
+      else
+        it++;
     }
-    else
+  }
+
+  if(float_map.get_d()!=b.float_map.get_d())
+  {
+    float_mapt &map=float_map.write();
+    const float_mapt &b_map=b.float_map.read();
+
+    for(float_mapt::iterator it=map.begin();
+        it!=map.end(); ) // no it++
+    {
+      const float_mapt::const_iterator b_it=b_map.find(it->first);
+      if(b_it==b_map.end())
+      {
+        it=map.erase(it);
+        result=true;
+        continue;
+      }
+
+      ieee_float_intervalt &i=it->second;
+      const ieee_float_intervalt &b_i=b_it->second;
+
+      if(i.lower_set && (!b_i.lower_set || b_i.lower<i.lower))
+      {
+        i.lower_set=false;
+        result=true;
+      }
+
+      if(i.upper_set && (!b_i.upper_set || b_i.upper>i.upper))
+      {
+        i.upper_set=false;
+        result=true;
+      }
+
+      if(i.is_top())
+        it=map.erase(it);
+      else
+        it++;
+    }
+  }
+
+  return result;
+}
+
+/// Refines the bounds that widening has dropped with those of b, which must
+/// be contained in *this. The other bounds are kept, so that repeated
+/// narrowing terminates.
+/// \par parameters: The interval domain, b, to narrow this domain with.
+/// \return True if *this has changed, False if there is no change.
+bool interval_domaint::narrow(const interval_domaint &b)
+{
+  if(bottom)
+    return false;
+  if(b.bottom)
+  {
+    make_bottom();
+    return true;
+  }
+
+  bool result=false;
+
+  // narrowing a map with itself does not change it
+  if(int_map.get_d()!=b.int_map.get_d())
+  {
+    int_mapt &map=int_map.write();
+
+    for(const auto &b_interval : b.int_map.read())
     {
-      ieee_float_intervalt previous=it->second;
-      it->second.join(b_it->second);
-      if(it->second!=previous)
+      integer_intervalt &i=map[b_interval.first];
+
+      if(!i.lower_set && b_interval.second.lower_set)
+      {
+        i.make_ge_than(b_interval.second.lower);
         result=true;
+      }
 
-      it++;
+      if(!i.upper_set && b_interval.second.upper_set)
+      {
+        i.make_le_than(b_interval.second.upper);
+        result=true;
+      }
+    }
+  }
+
+  if(float_map.get_d()!=b.float_map.get_d())
+  {
+    float_mapt &map=float_map.write();
+
+    for(const auto &b_interval : b.float_map.read())
+    {
+      ieee_float_intervalt &i=map[b_interval.first];
+
+      if(!i.lower_set && b_interval.second.lower_set)
+      {
+        i.make_ge_than(b_interval.second.lower);
+        result=true;
+      }
+
+      if(!i.upper_set && b_interval.second.upper_set)
+      {
+        i.make_le_than(b_interval.second.upper);
+        result=true;
+      }
     }
   }
 
@@ -184,8 +365,150 @@ bool interval_domaint::join(
 
 void interval_domaint::assign(const code_assignt &code_assign)
 {
-  havoc_rec(code_assign.lhs());
-  assume_rec(code_assign.lhs(), ID_equal, code_assign.rhs());
+  const exprt &lhs=code_assign.lhs();
+
+  if(lhs.id()==ID_symbol && is_int(lhs.type()))
+  {
+    // evaluate before the previous value of lhs is forgotten
+    const integer_intervalt value=get_int_rec(code_assign.rhs());
+
+    havoc_rec(lhs);
+
+    if(!value.is_top())
+      int_map.write()[to_symbol_expr(lhs).get_identifier()]=value;
+    return;
+  }
+
+  havoc_rec(lhs);
+  assume_rec(lhs, ID_equal, code_assign.rhs());
+}
+
+/// The smallest and largest value of the integer type \p type
+static void type_bounds(
+  const typet &type,
+  mp_integer &smallest,
+  mp_integer &largest)
+{
+  if(type.id()==ID_signedbv)
+  {
+    smallest=to_signedbv_type(type).smallest();
+    largest=to_signedbv_type(type).largest();
+  }
+  else
+  {
+    smallest=to_unsignedbv_type(type).smallest();
+    largest=to_unsignedbv_type(type).largest();
+  }
+}
+
+/// The interval of values of an integer expression, with both bounds set
+integer_intervalt interval_domaint::get_bounded_int(const exprt &expr) const
+{
+  PRECONDITION(is_int(expr.type()));
+
+  integer_intervalt result=get_int_rec(expr);
+
+  mp_integer smallest, largest;
+  type_bounds(expr.type(), smallest, largest);
+  result.make_ge_than(smallest);
+  result.make_le_than(largest);
+
+  return result;
+}
+
+/// The interval of values of an integer expression, which is top if the
+/// result may wrap around. An unset bound stands for the limit of the
+/// type, which needs to be taken into account when computing with it.
+integer_intervalt interval_domaint::get_int_rec(const exprt &expr) const
+{
+  integer_intervalt result;
+
+  if(!is_int(expr.type()))
+    return result;
+
+  if(expr.id()==ID_constant)
+  {
+    mp_integer value;
+    if(!to_integer(expr, value))
+      result=integer_intervalt(value);
+  }
+  else if(expr.id()==ID_symbol)
+  {
+    const int_mapt &map=int_map.read();
+    int_mapt::const_iterator it=map.find(to_symbol_expr(expr).get_identifier());
+    if(it!=map.end())
+      result=it->second;
+  }
+  else if(expr.id()==ID_typecast)
+  {
+    const exprt &op=to_typecast_expr(expr).op();
+    if(is_int(op.type()))
+      result=get_bounded_int(op);
+  }
+  else if(expr.id()==ID_plus || expr.id()==ID_minus)
+  {
+    if(expr.operands().empty())
+      return result;
+
+    for(const auto &op : expr.operands())
+      if(!is_int(op.type()))
+        return result;
+
+    result=get_bounded_int(expr.op0());
+
+    for(std::size_t i=1; i<expr.operands().size(); i++)
+    {
+      const integer_intervalt op=get_bounded_int(expr.operands()[i]);
+
+      if(expr.id()==ID_minus)
+      {
+        result.lower-=op.upper;
+        result.upper-=op.lower;
+      }
+      else
+      {
+        result.lower+=op.lower;
+        result.upper+=op.upper;
+      }
+    }
+  }
+  else if(expr.id()==ID_unary_minus)
+  {
+    const exprt &op=to_unary_minus_expr(expr).op();
+    if(!is_int(op.type()))
+      return result;
+
+    const integer_intervalt op_interval=get_bounded_int(op);
+    result=integer_intervalt(-op_interval.upper, -op_interval.lower);
+  }
+  else if(expr.id()==ID_mult && expr.operands().size()==2)
+  {
+    if(!is_int(expr.op0().type()) || !is_int(expr.op1().type()))
+      return result;
+
+    const integer_intervalt a=get_bounded_int(expr.op0());
+    const integer_intervalt b=get_bounded_int(expr.op1());
+    const mp_integer products[]=
+      { a.lower*b.lower, a.lower*b.upper, a.upper*b.lower, a.upper*b.upper };
+    result=integer_intervalt(
+      *std::min_element(std::begin(products), std::end(products)),
+      *std::max_element(std::begin(products), std::end(products)));
+  }
+
+  // values that do not fit into the type wrap around
+  mp_integer smallest, largest;
+  type_bounds(expr.type(), smallest, largest);
+
+  if((result.lower_set && result.lower<smallest) ||
+     (result.upper_set && result.upper>largest))
+    return integer_intervalt();
+
+  // an interval covering the whole type is top
+  if(result.lower_set && result.lower==smallest &&
+     result.upper_set && result.upper==largest)
+    return integer_intervalt();
+
+  return result;
 }
 
 void interval_domaint::havoc_rec(const exprt &lhs)
@@ -199,10 +522,17 @@ void interval_domaint::havoc_rec(const exprt &lhs)
   {
     irep_idt identifier=to_symbol_expr(lhs).get_identifier();
 
+    // only detach the maps from their copies if they change
     if(is_int(lhs.type()))
-      int_map.erase(identifier);
+    {
+      if(int_map.read().find(identifier)!=int_map.read().end())
+        int_map.write().erase(identifier);
+    }
     else if(is_float(lhs.type()))
-      float_map.erase(identifier);
+    {
+      if(float_map.read().find(identifier)!=float_map.read().end())
+        float_map.write().erase(identifier);
+    }
   }
   else if(lhs.id()==ID_typecast)
   {
@@ -256,7 +586,7 @@ void interval_domaint::assume_rec(
       to_integer(rhs, tmp);
       if(id==ID_lt)
         --tmp;
-      integer_intervalt &ii=int_map[lhs_identifier];
+      integer_intervalt &ii=int_map.write()[lhs_identifier];
       ii.make_le_than(tmp);
       if(ii.is_bottom())
         make_bottom();
@@ -266,7 +596,7 @@ void interval_domaint::assume_rec(
       ieee_floatt tmp(to_constant_expr(rhs));
       if(id==ID_lt)
         tmp.decrement();
-      ieee_float_intervalt &fi=float_map[lhs_identifier];
+      ieee_float_intervalt &fi=float_map.write()[lhs_identifier];
       fi.make_le_than(tmp);
       if(fi.is_bottom())
         make_bottom();
@@ -282,7 +612,7 @@ void interval_domaint::assume_rec(
       to_integer(lhs, tmp);
       if(id==ID_lt)
         ++tmp;
-      integer_intervalt &ii=int_map[rhs_identifier];
+      integer_intervalt &ii=int_map.write()[rhs_identifier];
       ii.make_ge_than(tmp);
       if(ii.is_bottom())
         make_bottom();
@@ -292,7 +622,7 @@ void interval_domaint::assume_rec(
       ieee_floatt tmp(to_constant_expr(lhs));
       if(id==ID_lt)
         tmp.increment();
-      ieee_float_intervalt &fi=float_map[rhs_identifier];
+      ieee_float_intervalt &fi=float_map.write()[rhs_identifier];
       fi.make_ge_than(tmp);
       if(fi.is_bottom())
         make_bottom();
@@ -305,8 +635,9 @@ void interval_domaint::assume_rec(
 
     if(is_int(lhs.type()) && is_int(rhs.type()))
     {
-      integer_intervalt &lhs_i=int_map[lhs_identifier];
-      integer_intervalt &rhs_i=int_map[rhs_identifier];
+      int_mapt &map=int_map.write();
+      integer_intervalt &lhs_i=map[lhs_identifier];
+      integer_intervalt &rhs_i=map[rhs_identifier];
       lhs_i.meet(rhs_i);
       rhs_i=lhs_i;
       if(rhs_i.is_bottom())
@@ -314,8 +645,9 @@ void interval_domaint::assume_rec(
     }
     else if(is_float(lhs.type()) && is_float(rhs.type()))
     {
-      ieee_float_intervalt &lhs_i=float_map[lhs_identifier];
-      ieee_float_intervalt &rhs_i=float_map[rhs_identifier];
+      float_mapt &map=float_map.write();
+      ieee_float_intervalt &lhs_i=map[lhs_identifier];
+      ieee_float_intervalt &rhs_i=map[rhs_identifier];
       lhs_i.meet(rhs_i);
       rhs_i=lhs_i;
       if(rhs_i.is_bottom())
@@ -381,8 +713,9 @@ exprt interval_domaint::make_expression(const symbol_exprt &src) const
 {
   if(is_int(src.type()))
   {
-    int_mapt::const_iterator i_it=int_map.find(src.get_identifier());
-    if(i_it==int_map.end())
+    const int_mapt &map=int_map.read();
+    int_mapt::const_iterator i_it=map.find(src.get_identifier());
+    if(i_it==map.end())
       return true_exprt();
 
     const integer_intervalt &interval=i_it->second;
@@ -409,8 +742,9 @@ exprt interval_domaint::make_expression(const symbol_exprt &src) const
   }
   else if(is_float(src.type()))
   {
-    float_mapt::const_iterator i_it=float_map.find(src.get_identifier());
-    if(i_it==float_map.end())
+    const float_mapt &map=float_map.read();
+    float_mapt::const_iterator i_it=map.find(src.get_identifier());
+    if(i_it==map.end())
       return true_exprt();
 
     const ieee_float_intervalt &interval=i_it->second;
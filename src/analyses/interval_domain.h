@@ -12,8 +12,11 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_ANALYSES_INTERVAL_DOMAIN_H
 #define CPROVER_ANALYSES_INTERVAL_DOMAIN_H
 
+#include <map>
+
 #include <util/ieee_float.h>
 #include <util/mp_arith.h>
+#include <util/reference_counting.h>
 
 #include "ai.h"
 #include "interval_template.h"
@@ -53,6 +56,13 @@ public:
     return join(b);
   }
 
+  bool widen(
+    const interval_domaint &b,
+    locationt from,
+    locationt to);
+
+  bool narrow(const interval_domaint &b);
+
   // no states
   void make_bottom() final override
   {
@@ -78,7 +88,8 @@ public:
   {
     #if 0
     // This invariant should hold but is not correctly enforced at the moment.
-    DATA_INVARIANT(!bottom || (int_map.empty() && float_map.empty()),
+    DATA_INVARIANT(
+      !bottom || (int_map.read().empty() && float_map.read().empty()),
                    "If the domain is bottom the value maps must be empty");
     #endif
 
@@ -87,7 +98,7 @@ public:
 
   bool is_top() const override final
   {
-    return !bottom && int_map.empty() && float_map.empty();
+    return !bottom && int_map.read().empty() && float_map.read().empty();
   }
 
   exprt make_expression(const symbol_exprt &) const;
@@ -111,18 +122,32 @@ public:
 protected:
   bool bottom;
 
-  typedef std::map<irep_idt, integer_intervalt> int_mapt;
-  typedef std::map<irep_idt, ieee_float_intervalt> float_mapt;
+  template<class intervalT>
+  class interval_mapt:public std::map<irep_idt, intervalT>
+  {
+  public:
+    static const interval_mapt blank;
+  };
+
+  typedef interval_mapt<integer_intervalt> int_mapt;
+  typedef interval_mapt<ieee_float_intervalt> float_mapt;
 
-  int_mapt int_map;
-  float_mapt float_map;
+  // The states are copied for every edge, and most instructions leave most
+  // intervals alone, so the copies share the maps until they are changed.
+  reference_counting<int_mapt> int_map;
+  reference_counting<float_mapt> float_map;
 
   void havoc_rec(const exprt &);
   void assume_rec(const exprt &, bool negation=false);
   void assume_rec(const exprt &lhs, irep_idt id, const exprt &rhs);
   void assign(const class code_assignt &assignment);
-  integer_intervalt get_int_rec(const exprt &);
+  integer_intervalt get_int_rec(const exprt &) const;
+  integer_intervalt get_bounded_int(const exprt &) const;
   ieee_float_intervalt get_float_rec(const exprt &);
 };
 
+template<class intervalT>
+const interval_domaint::interval_mapt<intervalT>
+  interval_domaint::interval_mapt<intervalT>::blank{};
+
 #endif // CPROVER_ANALYSES_INTERVAL_DOMAIN_H
@@ -11,10 +11,14 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "all_properties_class.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iostream>
+#include <sstream>
 
 #include <util/xml.h>
 #include <util/json.h>
+#include <util/worker_pool.h>
 
 #include <solvers/sat/satcheck.h>
 #include <solvers/prop/literal_expr.h>
@@ -98,6 +102,21 @@ safety_checkert::resultt bmc_all_propertiest::operator()()
 
   do_before_solving();
 
+  goal_literalst goal_literals;
+
+  for(const auto &g : goal_map)
+  {
+    // Our goal is to falsify a property, i.e., we will
+    // add the negation of the property as goal.
+    goal_literals[g.first]=!solver.convert(g.second.as_expr());
+  }
+
+  bool error=false;
+
+  const unsigned jobs=bmc.options.get_unsigned_int_option("properties-jobs");
+  if(jobs>1 && goal_map.size()>1)
+    solve_in_parallel(jobs, goal_literals);
+
   cover_goalst cover_goals(solver);
 
   cover_goals.set_message_handler(get_message_handler());
@@ -105,16 +124,21 @@ safety_checkert::resultt bmc_all_propertiest::operator()()
 
   for(const auto &g : goal_map)
   {
-    // Our goal is to falsify a property, i.e., we will
-    // add the negation of the property as goal.
-    literalt p=!solver.convert(g.second.as_expr());
-    cover_goals.add(p);
+    // Properties that the workers have shown to hold (or have failed on)
+    // are not looked at again. Failed properties are, to obtain a trace.
+    if(g.second.status==goalt::statust::SUCCESS)
+      cover_goals.add(const_literal(false));
+    else if(g.second.status==goalt::statust::ERROR)
+    {
+      error=true;
+      cover_goals.add(const_literal(false));
+    }
+    else
+      cover_goals.add(goal_literals[g.first]);
   }
 
   status() << "Running " << solver.decision_procedure_text() << eom;
 
-  bool error=false;
-
   decision_proceduret::resultt result=cover_goals();
 
   if(result==decision_proceduret::resultt::D_ERROR)
@@ -155,6 +179,122 @@ safety_checkert::resultt bmc_all_propertiest::operator()()
   return safe?safety_checkert::resultt::SAFE:safety_checkert::resultt::UNSAFE;
 }
 
+/// Decide the properties in \p goal_literals using up to \p jobs worker
+/// processes, each of which inherits a copy of the solver with the formula
+/// already converted. The properties are split into several chunks per
+/// worker, such that a hard property only holds up the few others in its
+/// chunk. Properties that are found to hold, or on which a worker fails, have
+/// their status set; properties found to fail are left alone, as the trace is
+/// computed by the caller.
+void bmc_all_propertiest::solve_in_parallel(
+  unsigned jobs,
+  const goal_literalst &goal_literals)
+{
+  const std::size_t chunk_size=
+    std::max<std::size_t>(1, goal_literals.size()/(4*jobs));
+
+  std::vector<goal_chunkt> chunks;
+  for(auto it=goal_literals.begin(); it!=goal_literals.end(); it++)
+  {
+    if(chunks.empty() || chunks.back().size()>=chunk_size)
+      chunks.push_back(goal_chunkt());
+    chunks.back().push_back(it);
+  }
+
+  status() << "Checking " << goal_literals.size() << " properties in "
+           << chunks.size() << " chunks using " << jobs << " workers" << eom;
+
+  // The workers modify their copy of the solver, so they must not be run
+  // in this process.
+  worker_poolt pool(jobs, true, false);
+  std::size_t next_chunk=0;
+  std::size_t decided=0, failed=0;
+
+  while(next_chunk<chunks.size() || !pool.empty())
+  {
+    if(next_chunk<chunks.size() && !pool.full())
+    {
+      const goal_chunkt &chunk=chunks[next_chunk++];
+      pool.start([this, &chunk]() { return solve_chunk(chunk); });
+      continue;
+    }
+
+    worker_poolt::finishedt finished;
+    if(!pool.wait_any(finished))
+      break;
+
+    if(finished.exit_status!=0)
+    {
+      // leave these properties to the sequential check
+      if(finished.exit_status!=worker_poolt::not_run)
+        warning() << "property checking worker " << finished.job_id
+                  << " failed" << eom;
+      continue;
+    }
+
+    std::istringstream output(finished.output);
+    std::string line;
+    while(std::getline(output, line))
+    {
+      const std::size_t space=line.find(' ');
+      if(space==std::string::npos)
+        continue;
+
+      const std::string status_string=line.substr(0, space);
+      const auto g_it=goal_map.find(line.substr(space+1));
+      if(g_it==goal_map.end())
+        continue;
+
+      if(status_string=="SUCCESS")
+        g_it->second.status=goalt::statust::SUCCESS;
+      else if(status_string=="ERROR")
+        g_it->second.status=goalt::statust::ERROR;
+      else if(status_string=="FAILURE")
+        failed++;
+      else
+        continue;
+
+      decided++;
+    }
+
+    status() << "Decided " << decided << " of " << goal_literals.size()
+             << " properties (" << failed << " failed)" << eom;
+  }
+}
+
+/// Runs in a worker process: decide the properties in \p chunk and write
+/// one line per property, giving its status and its ID, to the standard
+/// output
+int bmc_all_propertiest::solve_chunk(const goal_chunkt &chunk)
+{
+  null_message_handlert null_message_handler;
+  solver.set_message_handler(null_message_handler);
+
+  cover_goalst cover_goals(solver);
+  cover_goals.set_message_handler(null_message_handler);
+
+  for(const auto &goal : chunk)
+    cover_goals.add(goal->second);
+
+  const decision_proceduret::resultt result=cover_goals();
+
+  auto cover_goal=cover_goals.goals.begin();
+  for(const auto &goal : chunk)
+  {
+    if(cover_goal->status==cover_goalst::goalt::statust::COVERED)
+      std::cout << "FAILURE";
+    else if(result==decision_proceduret::resultt::D_ERROR)
+      std::cout << "ERROR";
+    else
+      std::cout << "SUCCESS";
+
+    std::cout << ' ' << goal->first << '\n';
+    cover_goal++;
+  }
+
+  return 0;
+}
+
 void bmc_all_propertiest::report(const cover_goalst &cover_goals)
 {
   switch(bmc.ui)
@@ -91,6 +91,13 @@ protected:
 
   virtual void report(const cover_goalst &cover_goals);
   virtual void do_before_solving() {}
+
+  // the literal that is true iff the property fails, by property ID
+  typedef std::map<irep_idt, literalt> goal_literalst;
+  typedef std::vector<goal_literalst::const_iterator> goal_chunkt;
+
+  void solve_in_parallel(unsigned jobs, const goal_literalst &);
+  int solve_chunk(const goal_chunkt &);
 };
 
 #endif // CPROVER_CBMC_ALL_PROPERTIES_CLASS_H
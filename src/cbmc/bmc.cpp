@@ -15,6 +15,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 
 #include <util/exit_codes.h>
@@ -25,7 +26,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/message.h>
 #include <util/json.h>
 #include <util/json_stream.h>
+#include <util/merge_irep.h>
+#include <util/simplify_expr_cache.h>
 #include <util/cprover_prefix.h>
+#include <util/worker_pool.h>
 
 #include <langapi/mode.h>
 #include <langapi/language_util.h>
@@ -38,10 +42,15 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <goto-symex/build_goto_trace.h>
 #include <goto-symex/slice.h>
 #include <goto-symex/slice_by_trace.h>
+#include <goto-symex/word_level_preprocessing.h>
 #include <goto-symex/memory_model_sc.h>
 #include <goto-symex/memory_model_tso.h>
 #include <goto-symex/memory_model_pso.h>
 
+#include <solvers/flattening/boolbv.h>
+#include <solvers/prop/activated_prop_conv.h>
+#include <solvers/sat/cnf_clause_list.h>
+
 #include "cbmc_solvers.h"
 #include "counterexample_beautification.h"
 #include "fault_localization.h"
@@ -159,11 +168,21 @@ bmct::run_decision_procedure(prop_convt &prop_conv)
 
   auto solver_start = std::chrono::steady_clock::now();
 
-  do_conversion();
+  if(options.get_option("unsat-core").empty())
+    do_conversion();
+  else
+    do_conversion_with_selectors();
 
   status() << "Running " << prop_conv.decision_procedure_text() << eom;
 
-  decision_proceduret::resultt dec_result=prop_conv.dec_solve();
+  const unsigned cube_jobs=options.get_unsigned_int_option("cube-jobs");
+  decision_proceduret::resultt dec_result;
+
+  if(cube_jobs>1 && prop_conv.has_set_assumptions() &&
+     unsat_core_selectors.empty())
+    dec_result=cube_and_conquer(prop_conv, cube_jobs);
+  else
+    dec_result=prop_conv.dec_solve();
 
   {
     auto solver_stop = std::chrono::steady_clock::now();
@@ -172,6 +191,19 @@ bmct::run_decision_procedure(prop_convt &prop_conv)
              << "s" << eom;
   }
 
+  const boolbvt *boolbv=dynamic_cast<const boolbvt *>(&prop_conv);
+  if(boolbv!=nullptr)
+  {
+    const boolbvt::bv_cache_statisticst &s=
+      boolbv->get_bv_cache_statistics();
+    const std::size_t lookups=s.node_hits+s.structural_hits+s.misses;
+    const std::size_t hits=s.node_hits+s.structural_hits;
+
+    debug() << "bit-blasting cache: " << hits << " hits ("
+            << s.node_hits << " by node), " << s.misses << " misses, "
+            << (lookups==0?0:(100*hits)/lookups) << "% hit rate" << eom;
+  }
+
   return dec_result;
 }
 
@@ -368,7 +400,30 @@ safety_checkert::resultt bmct::execute(
       return goto_model.get_goto_function(id);
     };
 
-    perform_symbolic_execution(get_goto_function);
+    if(options.get_bool_option("stream-formula") && can_stream_formula())
+    {
+      prop_conv.set_message_handler(get_message_handler());
+      equation.stream_to(prop_conv, ns);
+    }
+
+    if(options.get_bool_option("hash-cons"))
+    {
+      // the store lives as long as symbolic execution, the nodes that the
+      // equation refers to are kept alive by it
+      hash_consing_scopet hash_consing;
+      perform_symbolic_execution(get_goto_function);
+
+      const merge_full_irept &store=hash_consing.get_store();
+      const merge_irep_statisticst &s=store.get_statistics();
+      const std::size_t shared=s.nodes_shared+s.already_merged;
+      const std::size_t total=s.nodes_looked_up+s.already_merged;
+      statistics() << "hash consing: " << store.size()
+                   << " distinct nodes, " << shared << " of " << total
+                   << " nodes shared ("
+                   << (total==0?0:(100*shared)/total) << "%)" << eom;
+    }
+    else
+      perform_symbolic_execution(get_goto_function);
 
     // Borrow a reference to the goto functions map. This reference, or
     // iterators pointing into it, must not be stored by this function or its
@@ -397,6 +452,21 @@ safety_checkert::resultt bmct::execute(
                << equation.SSA_steps.size()
                << " steps" << eom;
 
+    if(const simplify_expr_cachet *cache=symex.get_simplify_cache())
+    {
+      const simplify_expr_cache_statisticst &s=cache->get_statistics();
+      progress() << "simplifier cache: " << s.hits << " hits, " << s.misses
+              << " misses, " << s.evictions << " evictions, "
+              << cache->size() << " entries" << eom;
+    }
+
+    if(const bdd_guard_managert *guards=symex.get_guard_manager())
+    {
+      progress() << "BDD guards: " << guards->number_of_atoms()
+                 << " atoms, " << guards->number_of_nodes() << " nodes"
+                 << eom;
+    }
+
     slice();
 
     // coverage report
@@ -444,6 +514,9 @@ safety_checkert::resultt bmct::execute(
       return safety_checkert::resultt::SAFE;
     }
 
+    if(options.get_bool_option("word-level-preprocessing"))
+      word_level_preprocessing();
+
     return decide(goto_functions, prop_conv);
   }
 
@@ -483,7 +556,12 @@ void bmct::slice()
         equation);
   }
   // any properties to check at all?
-  if(equation.has_threads())
+  if(equation.is_streaming())
+  {
+    // the steps have been converted already
+    statistics() << "no slicing of streamed formula" << eom;
+  }
+  else if(equation.has_threads())
   {
     // we should build a thread-aware SSA slicer
     statistics() << "no slicing due to threads" << eom;
@@ -514,6 +592,91 @@ void bmct::slice()
                << " remaining after simplification" << eom;
 }
 
+/// The number of variables and clauses of the propositional formula for
+/// \p equation, including the constraints added by post-processing. A copy
+/// of the equation is converted into a solver that merely collects the
+/// clauses.
+static std::pair<std::size_t, std::size_t> formula_size(
+  const symex_target_equationt &equation,
+  const namespacet &ns)
+{
+  symex_target_equationt copy(equation);
+  cnf_clause_listt cnf;
+  bv_cbmct bv_cbmc(ns, cnf);
+
+  copy.convert(bv_cbmc);
+
+  // post-processes, and then fails, as the clauses aren't solved
+  bv_cbmc.dec_solve();
+
+  return std::make_pair(cnf.no_variables()-1, cnf.no_clauses());
+}
+
+void bmct::word_level_preprocessing()
+{
+  // the formula is converted twice more to show how its size changes,
+  // which is only worth it when debugging, as the statistics are shown by
+  // default
+  const bool measure=
+    get_message_handler().get_verbosity()>=messaget::M_DEBUG;
+  std::pair<std::size_t, std::size_t> before;
+
+  if(measure)
+    before=formula_size(equation, ns);
+
+  const word_level_preprocessing_statisticst s=
+    ::word_level_preprocessing(equation, ns);
+
+  statistics() << "word-level preprocessing: " << s.substitutions
+               << " substitutions, " << s.constants << " constants, "
+               << s.decided << " comparisons decided, "
+               << s.narrowings.size() << " operations narrowed" << eom;
+
+  if(!measure)
+    return;
+
+  const std::pair<std::size_t, std::size_t> after=formula_size(equation, ns);
+
+  debug() << "word-level preprocessing changes the formula from "
+          << before.first << " variables and " << before.second
+          << " clauses to " << after.first << " variables and "
+          << after.second << " clauses" << eom;
+}
+
+/// Whether the options admit converting the formula while it is built by
+/// symbolic execution: anything that needs the complete formula rules this
+/// out
+bool bmct::can_stream_formula()
+{
+  const char *conflicting=nullptr;
+
+  if(options.get_bool_option("paths"))
+    conflicting="paths";
+  else if(options.get_bool_option("show-vcc"))
+    conflicting="show-vcc";
+  else if(options.get_bool_option("program-only"))
+    conflicting="program-only";
+  else if(options.get_bool_option("slice-formula"))
+    conflicting="slice-formula";
+  else if(!options.get_option("slice-by-trace").empty())
+    conflicting="slice-by-trace";
+  else if(options.get_bool_option("word-level-preprocessing"))
+    conflicting="word-level-preprocessing";
+  else if(!options.get_list_option("cover").empty())
+    conflicting="cover";
+  else if(!options.get_option("localize-faults").empty())
+    conflicting="localize-faults";
+  else if(!options.get_option("unsat-core").empty())
+    conflicting="unsat-core";
+
+  if(conflicting==nullptr)
+    return true;
+
+  warning() << "--stream-formula is not supported with --" << conflicting
+            << ", converting the formula after symbolic execution" << eom;
+  return false;
+}
+
 safety_checkert::resultt bmct::run(
   abstract_goto_modelt &goto_model)
 {
@@ -554,6 +717,8 @@ safety_checkert::resultt bmct::stop_on_fail(prop_convt &prop_conv)
   case decision_proceduret::resultt::D_UNSATISFIABLE:
     report_success();
     output_graphml(resultt::SAFE);
+    if(!options.get_option("unsat-core").empty())
+      output_unsat_core();
     return resultt::SAFE;
 
   case decision_proceduret::resultt::D_SATISFIABLE:
@@ -618,6 +783,241 @@ void bmct::setup_unwind()
     symex.set_unwind_limit(options.get_unsigned_int_option("unwind"));
 }
 
+/// \brief One solver for all paths explored by a process
+///
+/// With `--paths-incremental`, the formulas of all paths are added to a
+/// single SAT solver, each under its own activation literal (see
+/// activated_prop_convt). A path shares the SSA steps before its branch
+/// point with the path it was saved from; as the names of these steps are
+/// the same, their encoding is taken from the cache of the solver rather than
+/// being redone, and clauses learned while solving earlier paths remain
+/// available.
+class incremental_path_solvert
+{
+public:
+  incremental_path_solvert(
+    const optionst &_options,
+    const symbol_tablet &symbol_table,
+    const ui_message_handlert::uit &ui,
+    message_handlert &message_handler):
+    options(_options),
+    solvers(options, symbol_table, message_handler),
+    ns(symbol_table),
+    solver_conv(nullptr),
+    path_count(0)
+  {
+    // the preprocessor of the SAT solver could eliminate variables that
+    // later paths refer to
+    options.set_option("sat-preprocessor", false);
+    solvers.set_ui(ui);
+    solver=solvers.get_solver();
+    solver_conv=dynamic_cast<prop_conv_solvert *>(&solver->prop_conv());
+    INVARIANT(
+      solver_conv!=nullptr,
+      "incremental path exploration requires a propositional solver");
+  }
+
+  /// A fresh context for the formula of the next path
+  std::unique_ptr<activated_prop_convt> new_path()
+  {
+    return std::unique_ptr<activated_prop_convt>(
+      new activated_prop_convt(
+        ns,
+        *solver_conv,
+        "cbmc::path_activation::"+std::to_string(path_count++)));
+  }
+
+  /// Whether the solver can decide a path under its activation literal,
+  /// which requires solving under assumptions
+  bool has_set_assumptions() const
+  {
+    return solver_conv->has_set_assumptions();
+  }
+
+  /// Whether the options admit using a single solver for all paths
+  static bool is_supported(const optionst &options, messaget &message)
+  {
+    for(const char *option :
+          { "dimacs", "refine", "refine-strings", "smt1", "smt2",
+            "beautify" })
+    {
+      if(options.get_bool_option(option))
+      {
+        message.warning() << "--paths-incremental is not supported with --"
+                          << option << ", using a fresh solver for each path"
+                          << message.eom;
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+protected:
+  optionst options;
+  cbmc_solverst solvers;
+  namespacet ns;
+  std::unique_ptr<cbmc_solverst::solvert> solver;
+  prop_conv_solvert *solver_conv;
+  std::size_t path_count;
+};
+
+/// Symbolically execute and model-check the path that starts at the branch
+/// point that the strategy of \p worklist selects, and remove that branch
+/// point from the worklist. Branch points encountered along the way are
+/// appended to \p worklist. The path is checked using \p incremental_solver
+/// if that is given, and using a fresh solver otherwise.
+static safety_checkert::resultt explore_saved_path(
+  const optionst &opts,
+  abstract_goto_modelt &model,
+  const ui_message_handlert::uit &ui,
+  messaget &message,
+  goto_symext::branch_worklistt &worklist,
+  std::function<void(bmct &, const symbol_tablet &)> driver_configure_bmc,
+  std::function<bool(void)> callback_after_symex,
+  incremental_path_solvert *incremental_solver = nullptr)
+{
+  const symbol_tablet &symbol_table = model.get_symbol_table();
+  message_handlert &mh = message.get_message_handler();
+
+  message.status() << "___________________________\n"
+                   << "Starting new path (" << worklist.size()
+                   << " to go)\n"
+                   << message.eom;
+  std::unique_ptr<cbmc_solverst> solvers;
+  std::unique_ptr<cbmc_solverst::solvert> cbmc_solver;
+  std::unique_ptr<activated_prop_convt> path_conv;
+  if(incremental_solver)
+    path_conv = incremental_solver->new_path();
+  else
+  {
+    solvers = std::unique_ptr<cbmc_solverst>(
+      new cbmc_solverst(opts, symbol_table, mh));
+    solvers->set_ui(ui);
+    cbmc_solver = solvers->get_solver();
+  }
+  prop_convt &pc = path_conv ? *path_conv : cbmc_solver->prop_conv();
+  goto_symext::branch_pointt &resume = worklist.next();
+  path_explorert pe(
+    opts,
+    symbol_table,
+    mh,
+    pc,
+    resume.equation,
+    resume.state,
+    worklist,
+    callback_after_symex);
+  if(driver_configure_bmc)
+    driver_configure_bmc(pe, symbol_table);
+  safety_checkert::resultt result = pe.run(model);
+  worklist.pop_next();
+  if(path_conv)
+    path_conv->retire();
+  return result;
+}
+
+/// Explore the subtrees rooted at the branch points in \p worklist in up to
+/// \p jobs concurrent worker processes. Each worker owns one saved branch
+/// point, picked by the strategy of \p worklist, and explores all paths that
+/// branch off it, using its own solver instances and a fresh copy of the
+/// strategy. The output of the workers is replayed, and their results are
+/// merged, in the order in which the branch points were handed out, which
+/// makes the outcome independent of scheduling. With \p incremental, each
+/// worker uses a single incremental_path_solvert for its paths.
+/// \return the worst result over all explored paths
+static safety_checkert::resultt explore_paths_in_parallel(
+  const unsigned jobs,
+  const bool incremental,
+  const optionst &opts,
+  abstract_goto_modelt &model,
+  const ui_message_handlert::uit &ui,
+  messaget &message,
+  goto_symext::branch_worklistt &worklist,
+  std::function<void(bmct &, const symbol_tablet &)> driver_configure_bmc,
+  std::function<bool(void)> callback_after_symex)
+{
+  safety_checkert::resultt result = safety_checkert::resultt::SAFE;
+
+  message.status() << "Exploring " << worklist.size()
+                   << " saved branch points using " << jobs << " workers"
+                   << message.eom;
+
+  worker_poolt pool(jobs, true);
+  std::map<std::size_t, worker_poolt::finishedt> finished_jobs;
+  std::size_t next_to_report = 0;
+
+  while(!worklist.empty() || !pool.empty())
+  {
+    if(!worklist.empty() && !pool.full())
+    {
+      // The worker inherits a copy of this subtree; the parent doesn't need
+      // it anymore.
+      goto_symext::branch_worklistt subtree(
+        worklist.get_strategy().clone());
+      worklist.move_next_to(subtree);
+
+      pool.start([&]() {
+        safety_checkert::resultt subtree_result =
+          safety_checkert::resultt::SAFE;
+        std::unique_ptr<incremental_path_solvert> incremental_solver;
+        if(incremental)
+          incremental_solver = std::unique_ptr<incremental_path_solvert>(
+            new incremental_path_solvert(
+              opts,
+              model.get_symbol_table(),
+              ui,
+              message.get_message_handler()));
+        while(!subtree.empty())
+        {
+          subtree_result &= explore_saved_path(
+            opts,
+            model,
+            ui,
+            message,
+            subtree,
+            driver_configure_bmc,
+            callback_after_symex,
+            incremental_solver.get());
+        }
+        return static_cast<int>(subtree_result);
+      });
+
+      continue;
+    }
+
+    worker_poolt::finishedt finished;
+    if(!pool.wait_any(finished))
+      break;
+
+    const std::size_t job_id = finished.job_id;
+    finished_jobs.insert(std::make_pair(job_id, std::move(finished)));
+
+    for(auto it = finished_jobs.find(next_to_report);
+        it != finished_jobs.end();
+        it = finished_jobs.find(++next_to_report))
+    {
+      std::cout << it->second.output << std::flush;
+
+      switch(it->second.exit_status)
+      {
+      case static_cast<int>(safety_checkert::resultt::SAFE):
+        break;
+      case static_cast<int>(safety_checkert::resultt::UNSAFE):
+        result &= safety_checkert::resultt::UNSAFE;
+        break;
+      default:
+        message.error() << "path exploration worker " << it->first
+                        << " failed" << message.eom;
+        result &= safety_checkert::resultt::ERROR;
+      }
+
+      finished_jobs.erase(it);
+    }
+  }
+
+  return result;
+}
+
 /// Perform core BMC, using an abstract model to supply GOTO function bodies
 /// (perhaps created on demand).
 /// \param opts: command-line options affecting BMC
@@ -640,20 +1040,44 @@ int bmct::do_language_agnostic_bmc(
   const symbol_tablet &symbol_table = model.get_symbol_table();
   message_handlert &mh = message.get_message_handler();
   safety_checkert::resultt result;
-  goto_symext::branch_worklistt worklist;
+  goto_symext::branch_worklistt worklist(
+    get_path_strategy(opts.get_option("paths-strategy")));
   try
   {
+    std::unique_ptr<incremental_path_solvert> incremental_solver;
+    if(
+      opts.get_bool_option("paths") &&
+      opts.get_bool_option("paths-incremental") &&
+      incremental_path_solvert::is_supported(opts, message))
+    {
+      incremental_solver = std::unique_ptr<incremental_path_solvert>(
+        new incremental_path_solvert(opts, symbol_table, ui, mh));
+      if(!incremental_solver->has_set_assumptions())
+      {
+        message.warning() << "--paths-incremental requires a solver that "
+                          << "supports assumptions, using a fresh solver for "
+                          << "each path" << message.eom;
+        incremental_solver.reset();
+      }
+    }
+
     {
       cbmc_solverst solvers(opts, symbol_table, message.get_message_handler());
       solvers.set_ui(ui);
       std::unique_ptr<cbmc_solverst::solvert> cbmc_solver;
-      cbmc_solver = solvers.get_solver();
-      prop_convt &pc = cbmc_solver->prop_conv();
+      std::unique_ptr<activated_prop_convt> path_conv;
+      if(incremental_solver)
+        path_conv = incremental_solver->new_path();
+      else
+        cbmc_solver = solvers.get_solver();
+      prop_convt &pc = path_conv ? *path_conv : cbmc_solver->prop_conv();
       bmct bmc(opts, symbol_table, mh, pc, worklist, callback_after_symex);
       bmc.set_ui(ui);
       if(driver_configure_bmc)
         driver_configure_bmc(bmc, symbol_table);
       result = bmc.run(model);
+      if(path_conv)
+        path_conv->retire();
     }
     INVARIANT(
       opts.get_bool_option("paths") || worklist.empty(),
@@ -676,31 +1100,43 @@ int bmct::do_language_agnostic_bmc(
     // difference between the implementations of perform_symbolic_exection()
     // in bmct and path_explorert, for more information.
 
+    const unsigned paths_jobs=opts.get_unsigned_int_option("paths-jobs");
+
+    if(paths_jobs>1 && !worklist.empty())
+    {
+      if(ui==ui_message_handlert::uit::PLAIN)
+      {
+        // each worker sets up its own incremental solver
+        const bool incremental = incremental_solver != nullptr;
+        incremental_solver.reset();
+        result &= explore_paths_in_parallel(
+          paths_jobs,
+          incremental,
+          opts,
+          model,
+          ui,
+          message,
+          worklist,
+          driver_configure_bmc,
+          callback_after_symex);
+      }
+      else
+        message.warning() << "--paths-jobs is only supported with plain "
+                          << "text output, exploring paths sequentially"
+                          << message.eom;
+    }
+
     while(!worklist.empty())
     {
-      message.status() << "___________________________\n"
-                       << "Starting new path (" << worklist.size()
-                       << " to go)\n"
-                       << message.eom;
-      cbmc_solverst solvers(opts, symbol_table, message.get_message_handler());
-      solvers.set_ui(ui);
-      std::unique_ptr<cbmc_solverst::solvert> cbmc_solver;
-      cbmc_solver = solvers.get_solver();
-      prop_convt &pc = cbmc_solver->prop_conv();
-      goto_symext::branch_pointt &resume = worklist.front();
-      path_explorert pe(
+      result &= explore_saved_path(
         opts,
-        symbol_table,
-        mh,
-        pc,
-        resume.equation,
-        resume.state,
+        model,
+        ui,
+        message,
         worklist,
-        callback_after_symex);
-      if(driver_configure_bmc)
-        driver_configure_bmc(pe, symbol_table);
-      result &= pe.run(model);
-      worklist.pop_front();
+        driver_configure_bmc,
+        callback_after_symex,
+        incremental_solver.get());
     }
   }
   catch(const char *error_msg)
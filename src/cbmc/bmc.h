@@ -187,6 +187,21 @@ protected:
   virtual decision_proceduret::resultt
     run_decision_procedure(prop_convt &prop_conv);
 
+  decision_proceduret::resultt cube_and_conquer(
+    prop_convt &prop_conv,
+    unsigned jobs);
+  static int solve_cube(prop_convt &prop_conv, const bvt &cube);
+  bvt split_literals(std::size_t count) const;
+
+  void word_level_preprocessing();
+
+  // the selector literal of each step that may be in an unsat core
+  std::vector<std::pair<literalt, symex_target_equationt::SSA_stepst::iterator>>
+    unsat_core_selectors;
+
+  void do_conversion_with_selectors();
+  void output_unsat_core();
+
   virtual resultt decide(
     const goto_functionst &,
     prop_convt &);
@@ -198,6 +213,8 @@ protected:
 
   virtual void freeze_program_variables();
 
+  bool can_stream_formula();
+
   virtual void show_vcc();
   virtual void show_vcc_plain(std::ostream &out);
   virtual void show_vcc_json(std::ostream &out);
@@ -300,19 +317,45 @@ private:
   "(show-loops)"                                                               \
   "(show-vcc)"                                                                 \
   "(slice-formula)"                                                            \
+  "(hash-cons)"                                                                \
+  "(bdd-guards)"                                                               \
+  "(simplify-cache):"                                                          \
+  "(stream-formula)"                                                           \
+  "(word-level-preprocessing)"                                                 \
   "(unwinding-assertions)"                                                     \
   "(no-unwinding-assertions)"                                                  \
   "(no-pretty-names)"                                                          \
   "(partial-loops)"                                                            \
   "(paths)"                                                                    \
+  "(paths-jobs):"                                                              \
+  "(paths-incremental)"                                                        \
+  "(paths-strategy):"                                                          \
+  "(properties-jobs):"                                                         \
+  "(cube-jobs):"                                                               \
+  "(cube-vars):"                                                               \
   "(depth):"                                                                   \
   "(unwind):"                                                                  \
   "(unwindset):"                                                               \
   "(graphml-witness):"                                                         \
+  "(unsat-core):"                                                              \
   "(unwindset):"
 
 #define HELP_BMC                                                               \
   " --paths                      explore paths one at a time\n"                \
+  " --paths-jobs n               with --paths, explore paths in n parallel\n"  \
+  "                              worker processes\n"                           \
+  " --paths-incremental          with --paths, use a single SAT solver for\n"  \
+  "                              all paths explored by a process\n"            \
+  " --paths-strategy s           with --paths, resume saved paths in the\n"    \
+  "                              order given by s: fifo (breadth-first, the\n" \
+  "                              default), lifo (depth-first), random or\n"    \
+  "                              coverage (least-explored target first)\n"     \
+  " --properties-jobs n          check properties in n parallel worker\n"      \
+  "                              processes (unless --stop-on-fail is given)\n" \
+  " --cube-jobs n                with --stop-on-fail, split the formula\n"     \
+  "                              into cubes over guards, which are solved\n"   \
+  "                              in n parallel worker processes\n"             \
+  " --cube-vars k                with --cube-jobs, split on k guards\n"        \
   " --program-only               only show program expression\n"               \
   " --show-loops                 show the loops in the program\n"              \
   " --depth nr                   limit search depth\n"                         \
@@ -321,11 +364,24 @@ private:
   "                              (use --show-loops to get the loop IDs)\n"     \
   " --show-vcc                   show the verification conditions\n"           \
   " --slice-formula              remove assignments unrelated to property\n"   \
+  " --stream-formula             pass the formula to the solver while it is\n" \
+  "                              built, retaining only what traces need\n"     \
+  " --word-level-preprocessing   narrow arithmetic and simplify the formula\n" \
+  "                              using ranges of values\n"                     \
   " --unwinding-assertions       generate unwinding assertions\n"              \
   " --partial-loops              permit paths with partial loops\n"            \
   " --no-pretty-names            do not simplify identifiers\n"                \
+  " --hash-cons                  share equal expressions built by symbolic\n"  \
+  "                              execution and the simplifier\n"               \
+  " --bdd-guards                 keep path conditions in canonical form,\n"    \
+  "                              using BDDs to merge them\n"                   \
+  " --simplify-cache n           remember the results of simplifying up to\n"  \
+  "                              n expressions\n"                              \
   " --graphml-witness filename   write the witness in GraphML format to "      \
-  "filename\n" // NOLINT(*)
+  "filename\n"                                                                 \
+  " --unsat-core filename        if the properties hold, write the steps of\n" \
+  "                              the formula needed to show this as JSON to\n" \
+  "                              filename\n" // NOLINT(*)
 };
 
 #endif // CPROVER_CBMC_BMC_H
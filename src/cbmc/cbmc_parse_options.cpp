@@ -53,6 +53,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <goto-symex/rewrite_union.h>
 #include <goto-symex/adjust_float_expressions.h>
+#include <goto-symex/path_storage.h>
 
 #include <goto-instrument/reachability_slicer.h>
 #include <goto-instrument/full_slicer.h>
@@ -61,6 +62,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <pointer-analysis/add_failed_symbols.h>
 
+#include <solvers/flattening/bv_utils.h>
+
 #include <langapi/mode.h>
 
 #include "version.h"
@@ -111,6 +114,41 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
   if(cmdline.isset("paths"))
     options.set_option("paths", true);
 
+  if(cmdline.isset("paths-jobs"))
+    options.set_option("paths-jobs", cmdline.get_value("paths-jobs"));
+
+  if(cmdline.isset("paths-incremental"))
+  {
+    if(!cmdline.isset("paths"))
+    {
+      error() << "--paths-incremental requires --paths" << eom;
+      exit(CPROVER_EXIT_USAGE_ERROR);
+    }
+    options.set_option("paths-incremental", true);
+  }
+
+  if(cmdline.isset("properties-jobs"))
+    options.set_option(
+      "properties-jobs", cmdline.get_value("properties-jobs"));
+
+  if(cmdline.isset("cube-jobs"))
+    options.set_option("cube-jobs", cmdline.get_value("cube-jobs"));
+
+  if(cmdline.isset("cube-vars"))
+    options.set_option("cube-vars", cmdline.get_value("cube-vars"));
+
+  if(cmdline.isset("paths-strategy"))
+  {
+    const std::string strategy=cmdline.get_value("paths-strategy");
+    if(!get_path_strategy(strategy))
+    {
+      error() << "unknown path strategy `" << strategy
+              << "' -- use one of " << path_strategy_names() << eom;
+      exit(CPROVER_EXIT_USAGE_ERROR);
+    }
+    options.set_option("paths-strategy", strategy);
+  }
+
   if(cmdline.isset("program-only"))
     options.set_option("program-only", true);
 
@@ -234,6 +272,23 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
     "slice-formula",
     cmdline.isset("slice-formula"));
 
+  // convert the formula while symex builds it
+  if(cmdline.isset("stream-formula"))
+    options.set_option("stream-formula", true);
+
+  if(cmdline.isset("word-level-preprocessing"))
+    options.set_option("word-level-preprocessing", true);
+
+  if(cmdline.isset("hash-cons"))
+    options.set_option("hash-cons", true);
+
+  if(cmdline.isset("bdd-guards"))
+    options.set_option("bdd-guards", true);
+
+  if(cmdline.isset("simplify-cache"))
+    options.set_option(
+      "simplify-cache", cmdline.get_value("simplify-cache"));
+
   // simplify if conditions and branches
   if(cmdline.isset("no-simplify-if"))
     options.set_option("simplify-if", false);
@@ -247,6 +302,35 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
   else
     options.set_option("arrays-uf", "auto");
 
+  if(cmdline.isset("arrays-lazy-axioms"))
+    options.set_option("arrays-lazy-axioms", true);
+
+  if(cmdline.isset("multiplier"))
+  {
+    const std::string encoding=cmdline.get_value("multiplier");
+    bv_utilst::multipliert unused;
+    if(!get_multiplier_encoding(encoding, unused))
+    {
+      error() << "unknown multiplier encoding `" << encoding
+              << "' -- use one of " << multiplier_encoding_names() << eom;
+      exit(CPROVER_EXIT_USAGE_ERROR);
+    }
+    options.set_option("multiplier", encoding);
+  }
+
+  if(cmdline.isset("divider"))
+  {
+    const std::string encoding=cmdline.get_value("divider");
+    bv_utilst::dividert unused;
+    if(!get_divider_encoding(encoding, unused))
+    {
+      error() << "unknown divider encoding `" << encoding
+              << "' -- use one of " << divider_encoding_names() << eom;
+      exit(CPROVER_EXIT_USAGE_ERROR);
+    }
+    options.set_option("divider", encoding);
+  }
+
   if(cmdline.isset("dimacs"))
     options.set_option("dimacs", true);
 
@@ -286,6 +370,12 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
   if(cmdline.isset("aig"))
     options.set_option("aig", true);
 
+  if(cmdline.isset("aig-optimize"))
+  {
+    options.set_option("aig", true);
+    options.set_option("aig-optimize", true);
+  }
+
   // SMT Options
   bool version_set=false;
 
@@ -307,6 +397,9 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
   if(cmdline.isset("fpa"))
     options.set_option("fpa", true);
 
+  if(cmdline.isset("smt2-interactive"))
+    options.set_option("smt2-interactive", true);
+
 
   bool solver_set=false;
 
@@ -390,6 +483,12 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
   else
     options.set_option("sat-preprocessor", true);
 
+  if(cmdline.isset("cnf-preprocessing"))
+    options.set_option("cnf-preprocessing", true);
+
+  if(cmdline.isset("sat-portfolio"))
+    options.set_option("sat-portfolio", cmdline.get_value("sat-portfolio"));
+
   options.set_option(
     "pretty-names",
     !cmdline.isset("no-pretty-names"));
@@ -404,6 +503,13 @@ void cbmc_parse_optionst::get_command_line_options(optionst &options)
     options.set_option("trace", true);
   }
 
+  // the core is of the formula of all properties
+  if(cmdline.isset("unsat-core"))
+  {
+    options.set_option("unsat-core", cmdline.get_value("unsat-core"));
+    options.set_option("stop-on-fail", true);
+  }
+
   if(cmdline.isset("symex-coverage-report"))
     options.set_option(
       "symex-coverage-report",
@@ -975,6 +1081,7 @@ void cbmc_parse_optionst::help()
     " --cvc4                       use CVC4\n"
     " --yices                      use Yices\n"
     " --z3                         use Z3\n"
+    " --smt2-interactive           keep the SMT2 solver running between queries\n" // NOLINT(*)
     " --refine                     use refinement procedure (experimental)\n"
     " --refine-strings             use string refinement (experimental)\n"
     " --string-printable           add constraint that strings are printable (experimental)\n" // NOLINT(*)
@@ -983,6 +1090,15 @@ void cbmc_parse_optionst::help()
     " --outfile filename           output formula to given file\n"
     " --arrays-uf-never            never turn arrays into uninterpreted functions\n" // NOLINT(*)
     " --arrays-uf-always           always turn arrays into uninterpreted functions\n" // NOLINT(*)
+    " --arrays-lazy-axioms         add array axioms only once a model violates them\n" // NOLINT(*)
+    " --cnf-preprocessing          simplify the CNF before passing it to the SAT solver\n" // NOLINT(*)
+    " --aig                        convert the formula into an and-inverter graph\n" // NOLINT(*)
+    " --aig-optimize               also rewrite and sweep the graph (implies --aig)\n" // NOLINT(*)
+    " --sat-portfolio n            run n configurations of the SAT solver in parallel\n" // NOLINT(*)
+    " --multiplier encoding        encoding of multiplication: shift-add (default),\n" // NOLINT(*)
+    "                              auto, wallace, dadda or karatsuba\n"
+    " --divider encoding           encoding of division: multiplicative (default)\n" // NOLINT(*)
+    "                              or restoring\n"
     "\n"
     "Other options:\n"
     " --version                    show version and exit\n"
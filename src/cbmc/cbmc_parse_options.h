@@ -46,14 +46,15 @@ class optionst;
   "(no-built-in-assertions)" \
   "(xml-ui)(xml-interface)(json-ui)" \
   "(smt1)(smt2)(fpa)(cvc3)(cvc4)(boolector)(yices)(z3)(opensmt)(mathsat)" \
-  "(no-sat-preprocessor)" \
+  "(smt2-interactive)" \
+  "(no-sat-preprocessor)(cnf-preprocessing)(sat-portfolio):" \
   "(beautify)" \
   "(dimacs)(refine)(max-node-refinement):(refine-arrays)(refine-arithmetic)"\
   "(refine-strings)" \
   "(string-printable)" \
   "(string-max-length):" \
   "(string-max-input-length):" \
-  "(aig)(16)(32)(64)(LP64)(ILP64)(LLP64)(ILP32)(LP32)" \
+  "(aig)(aig-optimize)(16)(32)(64)(LP64)(ILP64)(LLP64)(ILP32)(LP32)" \
   "(little-endian)(big-endian)" \
   OPT_SHOW_GOTO_FUNCTIONS \
   OPT_SHOW_PROPERTIES \
@@ -68,7 +69,8 @@ class optionst;
   OPT_TIMESTAMP \
   "(i386-linux)(i386-macos)(i386-win32)(win32)(winx64)(gcc)" \
   "(ppc-macos)(unsigned-char)" \
-  "(arrays-uf-always)(arrays-uf-never)" \
+  "(arrays-uf-always)(arrays-uf-never)(arrays-lazy-axioms)" \
+  "(multiplier):(divider):" \
   "(string-abstraction)(no-arch)(arch):" \
   "(round-to-nearest)(round-to-plus-inf)(round-to-minus-inf)(round-to-zero)" \
   "(localize-faults)(localize-faults-method):" \
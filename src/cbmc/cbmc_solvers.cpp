@@ -19,10 +19,13 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/make_unique.h>
 
 #include <solvers/sat/satcheck.h>
+#include <solvers/sat/satcheck_portfolio.h>
+#include <solvers/sat/cnf_preprocessor.h>
 #include <solvers/refinement/bv_refinement.h>
 #include <solvers/refinement/string_refinement.h>
 #include <solvers/smt1/smt1_dec.h>
 #include <solvers/smt2/smt2_dec.h>
+#include <solvers/smt2/smt2_pipe_dec.h>
 #include <solvers/cvc/cvc_dec.h>
 #include <solvers/prop/aig_prop.h>
 #include <solvers/sat/dimacs_cnf.h>
@@ -91,17 +94,40 @@ smt2_dect::solvert cbmc_solverst::get_smt2_solver_type() const
 std::unique_ptr<cbmc_solverst::solvert> cbmc_solverst::get_default()
 {
   auto solver=util_make_unique<solvert>();
+  std::unique_ptr<propt> sat_solver;
 
-  if(options.get_bool_option("beautify") ||
-     !options.get_bool_option("sat-preprocessor")) // no simplifier
+  // simplifier won't work with beautification
+  const bool simplifier=
+    !options.get_bool_option("beautify") &&
+    options.get_bool_option("sat-preprocessor");
+
+  const unsigned portfolio_size=
+    options.get_unsigned_int_option("sat-portfolio");
+
+  std::unique_ptr<satcheck_portfoliot> portfolio;
+  if(portfolio_size>1)
   {
-    // simplifier won't work with beautification
-    solver->set_prop(util_make_unique<satcheck_no_simplifiert>());
+    portfolio=default_sat_portfolio(portfolio_size, simplifier);
+    if(portfolio==nullptr)
+      warning() << "the SAT solver does not support --sat-portfolio" << eom;
   }
-  else // with simplifier
+
+  if(portfolio!=nullptr)
+    sat_solver=cnf_preprocessing(std::move(portfolio));
+  else if(simplifier)
+    sat_solver=cnf_preprocessing(util_make_unique<satcheckt>());
+  else
+    sat_solver=cnf_preprocessing(util_make_unique<satcheck_no_simplifiert>());
+
+  if(options.get_bool_option("aig"))
   {
-    solver->set_prop(util_make_unique<satcheckt>());
+    auto aig_prop=util_make_unique<aig_prop_solvert>(std::move(sat_solver));
+    if(options.get_bool_option("aig-optimize"))
+      aig_prop->optimize();
+    solver->set_prop(std::move(aig_prop));
   }
+  else
+    solver->set_prop(std::move(sat_solver));
 
   solver->prop().set_message_handler(get_message_handler());
 
@@ -112,11 +138,36 @@ std::unique_ptr<cbmc_solverst::solvert> cbmc_solverst::get_default()
   else if(options.get_option("arrays-uf")=="always")
     bv_cbmc->unbounded_array=bv_cbmct::unbounded_arrayt::U_ALL;
 
+  bv_cbmc->lazy_array_axioms=options.get_bool_option("arrays-lazy-axioms");
+  set_arithmetic_encodings(*bv_cbmc);
+
   solver->set_prop_conv(std::move(bv_cbmc));
 
   return solver;
 }
 
+std::unique_ptr<propt> cbmc_solverst::cnf_preprocessing(
+  std::unique_ptr<cnft> sat_solver)
+{
+  if(!options.get_bool_option("cnf-preprocessing"))
+    return std::move(sat_solver);
+
+  return util_make_unique<cnf_preprocessing_solvert>(std::move(sat_solver));
+}
+
+void cbmc_solverst::set_arithmetic_encodings(boolbvt &boolbv)
+{
+  bv_utilst::multipliert multiplier;
+
+  if(get_multiplier_encoding(options.get_option("multiplier"), multiplier))
+    boolbv.set_multiplier_encoding(multiplier);
+
+  bv_utilst::dividert divider;
+
+  if(get_divider_encoding(options.get_option("divider"), divider))
+    boolbv.set_divider_encoding(divider);
+}
+
 std::unique_ptr<cbmc_solverst::solvert> cbmc_solverst::get_dimacs()
 {
   no_beautification();
@@ -128,6 +179,7 @@ std::unique_ptr<cbmc_solverst::solvert> cbmc_solverst::get_dimacs()
   std::string filename=options.get_option("outfile");
 
   auto cbmc_dimacs=util_make_unique<cbmc_dimacst>(ns, *prop, filename);
+  set_arithmetic_encodings(*cbmc_dimacs);
   return util_make_unique<solvert>(std::move(cbmc_dimacs), std::move(prop));
 }
 
@@ -139,9 +191,9 @@ std::unique_ptr<cbmc_solverst::solvert> cbmc_solverst::get_bv_refinement()
     if(options.get_bool_option("sat-preprocessor"))
     {
       no_beautification();
-      return util_make_unique<satcheckt>();
+      return cnf_preprocessing(util_make_unique<satcheckt>());
     }
-    return util_make_unique<satcheck_no_simplifiert>();
+    return cnf_preprocessing(util_make_unique<satcheck_no_simplifiert>());
   }();
 
   prop->set_message_handler(get_message_handler());
@@ -274,6 +326,30 @@ std::unique_ptr<cbmc_solverst::solvert> cbmc_solverst::get_smt2(
       throw 0;
     }
 
+    if(options.get_bool_option("smt2-interactive"))
+    {
+      if(smt2_pipe_dect::is_supported(solver))
+      {
+        auto smt2_dec=
+          util_make_unique<smt2_pipe_dect>(
+            ns,
+            "cbmc",
+            "Generated by CBMC " CBMC_VERSION,
+            "QF_AUFBV",
+            solver);
+
+        if(options.get_bool_option("fpa"))
+          smt2_dec->use_FPA_theory=true;
+
+        smt2_dec->set_message_handler(get_message_handler());
+
+        return util_make_unique<solvert>(std::move(smt2_dec));
+      }
+
+      warning() << "--smt2-interactive is not supported by this solver, "
+                << "running it on a file for each query" << eom;
+    }
+
     auto smt2_dec=
       util_make_unique<smt2_dect>(
         ns,
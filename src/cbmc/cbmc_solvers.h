@@ -143,6 +143,12 @@ protected:
   smt1_dect::solvert get_smt1_solver_type() const;
   smt2_dect::solvert get_smt2_solver_type() const;
 
+  // apply the --cnf-preprocessing option
+  std::unique_ptr<propt> cnf_preprocessing(std::unique_ptr<cnft> sat_solver);
+
+  // apply the --multiplier and --divider options
+  void set_arithmetic_encodings(boolbvt &);
+
   // consistency checks during solver creation
   void no_beautification();
   void no_incremental_check();
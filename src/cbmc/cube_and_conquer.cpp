@@ -0,0 +1,287 @@
+/*******************************************************************\
+
+Module: Cube-and-Conquer for a Single Formula
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Cube-and-Conquer for a Single Formula
+
+#include "bmc.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <util/worker_pool.h>
+
+/// The conditions that \p guard is a conjunction of, without negations,
+/// sorted
+static std::vector<exprt> guard_conditions(const exprt &guard)
+{
+  std::vector<exprt> result;
+
+  for(const auto &conjunct :
+        guard.id()==ID_and?guard.operands():exprt::operandst{ guard })
+  {
+    result.push_back(
+      conjunct.id()==ID_not && conjunct.operands().size()==1?
+      conjunct.op0():conjunct);
+  }
+
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/// Choose up to \p count literals to split the formula on. These are the
+/// guard literals that occur in most steps of the equation, i.e., the
+/// conditions of the branches that enclose the largest parts of the
+/// program. A guard over a subset or superset of the conditions of a guard
+/// that is already chosen is skipped: one of the branches is nested in the
+/// other, which would make some of the cubes trivially unsatisfiable.
+bvt bmct::split_literals(std::size_t count) const
+{
+  std::unordered_map<literalt::var_not, std::size_t> occurrences;
+  std::unordered_map<literalt::var_not, const exprt *> guards;
+  bvt candidates;
+
+  for(const auto &step : equation.SSA_steps)
+  {
+    if(step.ignore || step.guard_literal.is_constant())
+      continue;
+
+    if(occurrences[step.guard_literal.var_no()]++==0)
+    {
+      candidates.push_back(step.guard_literal);
+      guards[step.guard_literal.var_no()]=&step.guard;
+    }
+  }
+
+  // most frequent first, and earlier ones among those with equal count
+  std::stable_sort(
+    candidates.begin(),
+    candidates.end(),
+    [&occurrences](literalt a, literalt b)
+    {
+      return occurrences[a.var_no()]>occurrences[b.var_no()];
+    });
+
+  bvt result;
+  std::vector<std::vector<exprt>> chosen;
+
+  for(const auto &candidate : candidates)
+  {
+    if(result.size()>=count)
+      break;
+
+    const std::vector<exprt> conditions=
+      guard_conditions(*guards[candidate.var_no()]);
+
+    const bool nested=std::any_of(
+      chosen.begin(),
+      chosen.end(),
+      [&conditions](const std::vector<exprt> &other)
+      {
+        return
+          std::includes(
+            other.begin(), other.end(), conditions.begin(), conditions.end())||
+          std::includes(
+            conditions.begin(), conditions.end(), other.begin(), other.end());
+      });
+
+    if(!nested)
+    {
+      result.push_back(candidate);
+      chosen.push_back(conditions);
+    }
+  }
+
+  return result;
+}
+
+/// Runs in a worker process: decide the formula in \p prop_conv under the
+/// assumptions in \p cube, and write SATISFIABLE, UNSATISFIABLE or ERROR
+/// to the standard output. SATISFIABLE is followed by the model, as the
+/// literals of all variables that are true in it, if \p prop_conv is
+/// propositional.
+int bmct::solve_cube(prop_convt &prop_conv, const bvt &cube)
+{
+  null_message_handlert null_message_handler;
+  prop_conv.set_message_handler(null_message_handler);
+
+  prop_conv.set_assumptions(cube);
+
+  switch(prop_conv.dec_solve())
+  {
+  case decision_proceduret::resultt::D_SATISFIABLE:
+    std::cout << "SATISFIABLE\n";
+    if(const prop_conv_solvert *solver=
+         dynamic_cast<const prop_conv_solvert *>(&prop_conv))
+    {
+      const std::size_t variables=solver->get_number_of_solver_variables();
+      for(std::size_t v=1; v<variables; v++)
+      {
+        const literalt l(static_cast<literalt::var_not>(v), false);
+        std::cout << (prop_conv.l_get(l).is_true()?"":"-") << v << ' ';
+      }
+      std::cout << '\n';
+    }
+    break;
+  case decision_proceduret::resultt::D_UNSATISFIABLE:
+    std::cout << "UNSATISFIABLE\n";
+    break;
+  case decision_proceduret::resultt::D_ERROR:
+    std::cout << "ERROR\n";
+    break;
+  }
+
+  return 0;
+}
+
+/// The model that solve_cube wrote to \p output, restricted to the
+/// variables that \p prop_conv has now, which post-processing may extend
+static bvt read_model(const std::string &output, const prop_convt &prop_conv)
+{
+  bvt model;
+  const prop_conv_solvert *solver=
+    dynamic_cast<const prop_conv_solvert *>(&prop_conv);
+
+  if(solver==nullptr)
+    return model;
+
+  const std::size_t variables=solver->get_number_of_solver_variables();
+  std::istringstream in(output);
+  std::string result_string;
+  long long literal;
+
+  in >> result_string;
+  while(in >> literal)
+  {
+    const std::size_t v=static_cast<std::size_t>(std::llabs(literal));
+    if(v>0 && v<variables)
+      model.push_back(
+        literalt(static_cast<literalt::var_not>(v), literal<0));
+  }
+
+  return model;
+}
+
+/// Decide the formula in \p prop_conv by splitting it into cubes over the
+/// literals chosen by split_literals, which are solved as assumptions in up
+/// to \p jobs worker processes. Solving stops as soon as one cube is
+/// satisfiable. The model the worker found is then assumed in this process,
+/// which leaves the solver only to check it; should that fail, the cube is
+/// solved again. If any worker fails, or no worker process can be created,
+/// the formula is solved as a whole.
+decision_proceduret::resultt bmct::cube_and_conquer(
+  prop_convt &prop_conv,
+  unsigned jobs)
+{
+  std::size_t vars=options.get_unsigned_int_option("cube-vars");
+
+  // four cubes per worker by default
+  if(vars==0)
+    while((std::size_t(1)<<vars)<4*jobs)
+      vars++;
+
+  vars=std::min<std::size_t>(vars, 16);
+
+  const bvt split=split_literals(vars);
+
+  if(split.empty())
+    return prop_conv.dec_solve();
+
+  // the simplifier of the SAT solver must not eliminate these
+  prop_conv.set_frozen(split);
+
+  std::vector<bvt> cubes(std::size_t(1)<<split.size(), split);
+  for(std::size_t c=0; c<cubes.size(); c++)
+    for(std::size_t i=0; i<split.size(); i++)
+      if((c>>i)&1)
+        cubes[c][i]=!split[i];
+
+  status() << "Solving " << cubes.size() << " cubes over " << split.size()
+           << " guard literals using " << jobs << " workers" << eom;
+
+  // The workers modify their copy of the solver, so they must not be run
+  // in this process. Each reports its result on its standard output.
+  worker_poolt pool(jobs, true, false);
+  std::size_t next_cube=0, unsatisfiable=0;
+  bool satisfiable=false, failed=false;
+  bvt satisfiable_cube;
+  std::string satisfiable_output;
+
+  while(!satisfiable && !failed &&
+        (next_cube<cubes.size() || !pool.empty()))
+  {
+    if(next_cube<cubes.size() && !pool.full())
+    {
+      const bvt &cube=cubes[next_cube++];
+      pool.start([&prop_conv, &cube]()
+      {
+        return solve_cube(prop_conv, cube);
+      });
+      continue;
+    }
+
+    worker_poolt::finishedt finished;
+    if(!pool.wait_any(finished))
+      break;
+
+    std::string result_string;
+    if(finished.exit_status==0)
+      std::istringstream(finished.output) >> result_string;
+
+    if(result_string=="SATISFIABLE")
+    {
+      satisfiable=true;
+      satisfiable_cube=cubes[finished.job_id];
+      satisfiable_output=finished.output;
+    }
+    else if(result_string=="UNSATISFIABLE")
+      unsatisfiable++;
+    else
+      failed=true;
+  }
+
+  pool.kill_all();
+
+  if(satisfiable)
+  {
+    status() << "Found satisfiable cube after " << unsatisfiable
+             << " unsatisfiable ones" << eom;
+
+    // the simplifier of the SAT solver must not eliminate assumed variables
+    const bvt model=read_model(satisfiable_output, prop_conv);
+    prop_conv.set_frozen(model);
+
+    bvt assumptions=satisfiable_cube;
+    assumptions.insert(assumptions.end(), model.begin(), model.end());
+    prop_conv.set_assumptions(assumptions);
+    decision_proceduret::resultt result=prop_conv.dec_solve();
+
+    if(result!=decision_proceduret::resultt::D_SATISFIABLE)
+    {
+      warning() << "the model of the cube does not apply, solving the cube "
+                << "again" << eom;
+      prop_conv.set_assumptions(satisfiable_cube);
+      result=prop_conv.dec_solve();
+    }
+
+    prop_conv.set_assumptions(bvt());
+    return result;
+  }
+
+  if(failed || unsatisfiable<cubes.size())
+  {
+    warning() << "cube-and-conquer failed, solving the formula as a whole"
+              << eom;
+    return prop_conv.dec_solve();
+  }
+
+  return decision_proceduret::resultt::D_UNSATISFIABLE;
+}
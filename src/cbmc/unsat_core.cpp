@@ -0,0 +1,204 @@
+/*******************************************************************\
+
+Module: Unsat Cores for SAFE Results
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unsat Cores for SAFE Results
+
+#include "bmc.h"
+
+#include <fstream>
+#include <iostream>
+
+#include <util/json_expr.h>
+#include <util/std_expr.h>
+
+#include <solvers/prop/literal_expr.h>
+
+/// Convert the equation such that each assignment, assumption and
+/// constraint only holds if a selector literal of its own is true. The
+/// selectors are passed to the solver as assumptions, and those that are in
+/// conflict once the formula is found to be unsatisfiable give an unsat
+/// core. This is not minimal: it consists of the steps that the solver used
+/// to refute the formula. If the solver cannot solve under assumptions, the
+/// formula is converted as usual.
+void bmct::do_conversion_with_selectors()
+{
+  unsat_core_selectors.clear();
+
+  if(!prop_conv.has_set_assumptions() || !prop_conv.has_is_in_conflict())
+  {
+    warning() << "unsat cores are not supported by "
+              << prop_conv.decision_procedure_text() << eom;
+    do_conversion();
+    return;
+  }
+
+  // convert HDL (hook for hw-cbmc)
+  do_unwind_module();
+
+  status() << "converting SSA with selectors for an unsat core" << eom;
+
+  equation.convert_guards(prop_conv);
+
+  bvt selectors;
+
+  for(auto it=equation.SSA_steps.begin(); it!=equation.SSA_steps.end(); ++it)
+  {
+    auto &step=*it;
+
+    if(!step.is_assignment() && !step.is_assume() && !step.is_constraint())
+      continue;
+
+    if(step.ignore)
+    {
+      if(step.is_assume())
+        step.cond_literal=const_literal(true);
+      continue;
+    }
+
+    const literalt selector=prop_conv.convert(
+      symbol_exprt(
+        "unsat_core::selector::"+std::to_string(selectors.size()),
+        bool_typet()));
+    prop_conv.set_frozen(selector);
+    selectors.push_back(selector);
+    unsat_core_selectors.push_back(std::make_pair(selector, it));
+
+    const implies_exprt premise(literal_exprt(selector), step.cond_expr);
+
+    if(step.is_assume())
+      step.cond_literal=prop_conv.convert(premise);
+    else
+      prop_conv.set_to_true(premise);
+  }
+
+  equation.convert_decls(prop_conv);
+
+  // As in symex_target_equationt::convert_assertions, but the assumptions
+  // are always taken from their literals, which include the selectors.
+  or_exprt::operandst disjuncts;
+  exprt assumption=true_exprt();
+
+  for(auto &step : equation.SSA_steps)
+  {
+    if(step.is_assert())
+    {
+      step.cond_literal=
+        prop_conv.convert(implies_exprt(assumption, step.cond_expr));
+      disjuncts.push_back(literal_exprt(!step.cond_literal));
+    }
+    else if(step.is_assume())
+    {
+      // avoid deep nesting of ID_and expressions
+      if(assumption.id()==ID_and)
+        assumption.copy_to_operands(literal_exprt(step.cond_literal));
+      else
+        assumption=and_exprt(assumption, literal_exprt(step.cond_literal));
+    }
+  }
+
+  // the below is 'true' if there are no assertions
+  prop_conv.set_to_true(disjunction(disjuncts));
+
+  equation.convert_goto_instructions(prop_conv);
+  equation.convert_io(prop_conv);
+
+  // the 'extra constraints'
+  if(!bmc_constraints.empty())
+  {
+    status() << "converting constraints" << eom;
+
+    for(const auto &constraint : bmc_constraints)
+      prop_conv.set_to_true(constraint);
+  }
+  // hook for cegis to freeze synthesis program vars
+  freeze_program_variables();
+
+  prop_conv.set_assumptions(selectors);
+}
+
+static const char *step_type(const symex_target_equationt::SSA_stept &step)
+{
+  if(step.is_assignment())
+    return "assignment";
+  else if(step.is_assume())
+    return "assumption";
+  else
+    return "constraint";
+}
+
+/// Write the steps whose selectors are in conflict, after the formula
+/// converted by do_conversion_with_selectors has been found to be
+/// unsatisfiable, as JSON to the file given by the option `unsat-core`,
+/// or to the standard output if that is `-`. The core is of the formula of
+/// all properties together, and is meant for inspection: no tool reads it
+/// back.
+void bmct::output_unsat_core()
+{
+  if(!prop_conv.has_set_assumptions() || !prop_conv.has_is_in_conflict())
+    return;
+
+  json_arrayt json_steps;
+  std::size_t step_number=0;
+  auto selector=unsat_core_selectors.begin();
+
+  for(auto it=equation.SSA_steps.begin();
+      it!=equation.SSA_steps.end();
+      ++it, ++step_number)
+  {
+    if(selector==unsat_core_selectors.end() || selector->second!=it)
+      continue;
+
+    const bool in_core=prop_conv.is_in_conflict(selector->first);
+    ++selector;
+
+    if(!in_core)
+      continue;
+
+    const auto &step=*it;
+
+    json_objectt &json_step=json_steps.push_back().make_object();
+    json_step["stepType"]=json_stringt(step_type(step));
+    json_step["step"]=json_numbert(std::to_string(step_number));
+    json_step["hidden"]=jsont::json_boolean(step.hidden);
+
+    if(step.is_assignment())
+      json_step["lhs"]=json_stringt(id2string(step.ssa_lhs.get_identifier()));
+
+    const source_locationt &source_location=
+      step.source.pc->source_location;
+    if(source_location.is_not_nil())
+      json_step["sourceLocation"]=json(source_location);
+  }
+
+  status() << "unsat core: " << json_steps.array.size() << " of "
+           << unsat_core_selectors.size() << " steps" << eom;
+
+  json_objectt json_result;
+  json_result["coreSize"]=
+    json_numbert(std::to_string(json_steps.array.size()));
+  json_result["selectedSteps"]=
+    json_numbert(std::to_string(unsat_core_selectors.size()));
+
+  json_result["unsatCore"]=std::move(json_steps);
+
+  const std::string &filename=options.get_option("unsat-core");
+
+  if(filename=="-")
+    std::cout << json_result << '\n';
+  else
+  {
+    std::ofstream out(filename);
+    if(!out)
+    {
+      error() << "failed to write unsat core to " << filename << eom;
+      return;
+    }
+    out << json_result << '\n';
+  }
+}
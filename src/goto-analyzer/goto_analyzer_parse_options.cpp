@@ -286,6 +286,27 @@ void goto_analyzer_parse_optionst::get_command_line_options(optionst &options)
       options.set_option("domain set", true);
     }
 
+    if(cmdline.isset("widening-delay"))
+      options.set_option("widening-delay", cmdline.get_value("widening-delay"));
+
+    if(cmdline.isset("narrowing-iterations"))
+    {
+      options.set_option(
+        "narrowing-iterations", cmdline.get_value("narrowing-iterations"));
+    }
+
+    if(cmdline.isset("sparse-states"))
+      options.set_option("sparse-states", true);
+
+    if(cmdline.isset("weak-topological-order"))
+      options.set_option("weak-topological-order", true);
+
+    if(cmdline.isset("function-modular"))
+      options.set_option("function-modular", true);
+
+    if(cmdline.isset("jobs"))
+      options.set_option("jobs", cmdline.get_value("jobs"));
+
     // Reachability questions, when given with a domain swap from specific
     // to general tasks so that they can use the domain & parameterisations.
     if(reachability_task)
@@ -366,9 +387,59 @@ ai_baset *goto_analyzer_parse_optionst::build_analyzer(
 #endif
   }
 
+  if(domain!=nullptr)
+  {
+    if(!options.get_option("widening-delay").empty())
+      domain->set_widening_delay(
+        options.get_unsigned_int_option("widening-delay"));
+
+    if(!options.get_option("narrowing-iterations").empty())
+      domain->set_narrowing_iterations(
+        options.get_unsigned_int_option("narrowing-iterations"));
+
+    if(options.get_bool_option("sparse-states"))
+      domain->set_sparse_states(true);
+
+    if(options.get_bool_option("weak-topological-order"))
+      domain->set_weak_topological_order(true);
+
+    if(options.get_bool_option("function-modular"))
+    {
+      // the dependence graph needs the post-dominators of the function of
+      // every instruction it is given
+      if(options.get_bool_option("dependence-graph"))
+        warning() << "--function-modular is ignored with --dependence-graph"
+                  << eom;
+      else
+        domain->set_function_modular(true);
+    }
+  }
+
   return domain;
 }
 
+/// Report how often the fixedpoint of each function has been computed and
+/// how often its instructions have been visited
+void goto_analyzer_parse_optionst::show_iteration_statistics(
+  const ai_baset &analyzer)
+{
+  ai_baset::iteration_statisticst total;
+
+  for(const auto &entry : analyzer.get_iteration_statistics())
+  {
+    statistics() << "Iterations in " << entry.first << ": "
+                 << entry.second.fixedpoints << " fixedpoints, "
+                 << entry.second.visits << " visits" << eom;
+
+    total.fixedpoints+=entry.second.fixedpoints;
+    total.visits+=entry.second.visits;
+  }
+
+  statistics() << "Iterations in total: "
+               << total.fixedpoints << " fixedpoints, "
+               << total.visits << " visits" << eom;
+}
+
 /// invoke main modules
 int goto_analyzer_parse_optionst::doit()
 {
@@ -630,9 +701,21 @@ int goto_analyzer_parse_optionst::perform_analysis(const optionst &options)
     }
 
 
+    // A function-modular analysis can be verified in parallel, with each
+    // worker analysing the functions whose assertions it checks.
+    const bool parallel_verify=
+      options.get_bool_option("verify") &&
+      options.get_bool_option("function-modular") &&
+      !options.get_bool_option("dependence-graph") &&
+      options.get_unsigned_int_option("jobs")>1;
+
     // Run
-    status() << "Computing abstract states" << eom;
-    (*analyzer)(goto_model);
+    if(!parallel_verify)
+    {
+      status() << "Computing abstract states" << eom;
+      (*analyzer)(goto_model);
+      show_iteration_statistics(*analyzer);
+    }
 
     // Perform the task
     status() << "Performing task" << eom;
@@ -645,6 +728,15 @@ int goto_analyzer_parse_optionst::perform_analysis(const optionst &options)
                                   get_message_handler(),
                                   out);
     }
+    else if(parallel_verify)
+    {
+      result = parallel_static_verifier(goto_model,
+                                        *analyzer,
+                                        options.get_unsigned_int_option("jobs"),
+                                        options,
+                                        get_message_handler(),
+                                        out);
+    }
     else if(options.get_bool_option("verify"))
     {
       result = static_verifier(goto_model,
@@ -840,6 +932,17 @@ void goto_analyzer_parse_optionst::help()
     // NOLINTNEXTLINE(whitespace/line_length)
     " --location-sensitive         use location-sensitive abstract interpreter\n"
     " --concurrent                 use concurrency-aware abstract interpreter\n"
+    // NOLINTNEXTLINE(whitespace/line_length)
+    " --widening-delay n           widen at loop heads after n changes (default: 3)\n"
+    " --narrowing-iterations n     narrow up to n times after widening\n"
+    "                              (default: 2)\n"
+    " --sparse-states              only store the states at basic block heads\n"
+    " --weak-topological-order     visit the instructions in a weak topological\n"
+    "                              order, stabilising inner loops first\n"
+    // NOLINTNEXTLINE(whitespace/line_length)
+    " --function-modular           analyse functions independently of their callers\n"
+    " --jobs n                     with --function-modular --verify, analyse\n"
+    "                              the functions in n worker processes\n"
     "\n"
     "Domain options:\n"
     " --constants                  constant domain\n"
@@ -148,6 +148,9 @@ class optionst;
   "(dependence-graph)" \
   "(show)(verify)(simplify):" \
   "(location-sensitive)(concurrent)" \
+  "(widening-delay):(narrowing-iterations):" \
+  "(sparse-states)(weak-topological-order)" \
+  "(function-modular)(jobs):" \
   "(no-simplify-slicing)" \
   JAVA_BYTECODE_LANGUAGE_OPTIONS
 // clang-format on
@@ -177,6 +180,8 @@ protected:
 
   ai_baset *build_analyzer(const optionst &, const namespacet &ns);
 
+  void show_iteration_statistics(const ai_baset &analyzer);
+
   void eval_verbosity();
 
   ui_message_handlert::uit get_ui()
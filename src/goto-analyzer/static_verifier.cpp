@@ -8,72 +8,104 @@ Author: Martin Brain, martin.brain@cs.ox.ac.uk
 
 #include "static_verifier.h"
 
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
 #include <util/xml.h>
 #include <util/xml_expr.h>
 #include <util/json.h>
 #include <util/json_expr.h>
+#include <util/worker_pool.h>
 
+enum class ai_verifier_statust
+{
+  SUCCESS,
+  FAILURE_IF_REACHABLE,
+  SUCCESS_UNREACHABLE,
+  UNKNOWN
+};
 
-/// Runs the analyzer and then prints out the domain
-/// \param goto_model: the program analyzed
-/// \param ai: the abstract interpreter after it has been run to fix point
-/// \param options: the parsed user options
-/// \param message_handler: the system message handler
-/// \param out: output stream for the printing
-/// \return: false on success with the domain printed to out
-bool static_verifier(
-  const goto_modelt &goto_model,
+// the results of the assertions of each function, in program order
+typedef std::map<irep_idt, std::vector<ai_verifier_statust>>
+  ai_verifier_resultst;
+
+static ai_verifier_statust check_assertion(
   const ai_baset &ai,
+  goto_programt::const_targett assertion,
+  const namespacet &ns)
+{
+  exprt e(assertion->guard);
+  const ai_domain_baset &domain(ai.abstract_state_before(assertion));
+  domain.ai_simplify(e, ns);
+
+  if(e.is_true())
+    return ai_verifier_statust::SUCCESS;
+  else if(e.is_false())
+    return ai_verifier_statust::FAILURE_IF_REACHABLE;
+  else if(domain.is_bottom())
+    return ai_verifier_statust::SUCCESS_UNREACHABLE;
+  else
+    return ai_verifier_statust::UNKNOWN;
+}
+
+static void check_assertions(
+  const goto_functionst::goto_functiont &goto_function,
+  const ai_baset &ai,
+  const namespacet &ns,
+  std::vector<ai_verifier_statust> &results)
+{
+  forall_goto_program_instructions(i_it, goto_function.body)
+    if(i_it->is_assert())
+      results.push_back(check_assertion(ai, i_it, ns));
+}
+
+/// Print the results of the assertions in the format given by \p options
+static void output_results(
+  const goto_modelt &goto_model,
+  const ai_verifier_resultst &results,
   const optionst &options,
-  message_handlert &message_handler,
+  messaget &m,
   std::ostream &out)
 {
   std::size_t pass=0, fail=0, unknown=0;
 
-  namespacet ns(goto_model.symbol_table);
-
-  messaget m(message_handler);
-  m.status() << "Checking assertions" << messaget::eom;
-
   if(options.get_bool_option("json"))
   {
     json_arrayt json_result;
 
     forall_goto_functions(f_it, goto_model.goto_functions)
     {
-      m.progress() << "Checking " << f_it->first << messaget::eom;
-
-      if(!f_it->second.body.has_assertion())
+      ai_verifier_resultst::const_iterator r_it=results.find(f_it->first);
+      if(r_it==results.end())
         continue;
 
+      auto status=r_it->second.begin();
+
       forall_goto_program_instructions(i_it, f_it->second.body)
       {
         if(!i_it->is_assert())
           continue;
 
-        exprt e(i_it->guard);
-        const ai_domain_baset &domain(ai.abstract_state_before(i_it));
-        domain.ai_simplify(e, ns);
-
         json_objectt &j=json_result.push_back().make_object();
 
-        if(e.is_true())
+        switch(*status++)
         {
+        case ai_verifier_statust::SUCCESS:
           j["status"]=json_stringt("SUCCESS");
           ++pass;
-        }
-        else if(e.is_false())
-        {
+          break;
+        case ai_verifier_statust::FAILURE_IF_REACHABLE:
           j["status"]=json_stringt("FAILURE (if reachable)");
           ++fail;
-        }
-        else if(domain.is_bottom())
-        {
+          break;
+        case ai_verifier_statust::SUCCESS_UNREACHABLE:
           j["status"]=json_stringt("SUCCESS (unreachable)");
           ++pass;
-        }
-        else
-        {
+          break;
+        case ai_verifier_statust::UNKNOWN:
           j["status"]=json_stringt("UNKNOWN");
           ++unknown;
         }
@@ -90,39 +122,34 @@ bool static_verifier(
 
     forall_goto_functions(f_it, goto_model.goto_functions)
     {
-      m.progress() << "Checking " << f_it->first << messaget::eom;
-
-      if(!f_it->second.body.has_assertion())
+      ai_verifier_resultst::const_iterator r_it=results.find(f_it->first);
+      if(r_it==results.end())
         continue;
 
+      auto status=r_it->second.begin();
+
       forall_goto_program_instructions(i_it, f_it->second.body)
       {
         if(!i_it->is_assert())
           continue;
 
-        exprt e(i_it->guard);
-        const ai_domain_baset &domain(ai.abstract_state_before(i_it));
-        domain.ai_simplify(e, ns);
-
         xmlt &x=xml_result.new_element("result");
 
-        if(e.is_true())
+        switch(*status++)
         {
+        case ai_verifier_statust::SUCCESS:
           x.set_attribute("status", "SUCCESS");
           ++pass;
-        }
-        else if(e.is_false())
-        {
+          break;
+        case ai_verifier_statust::FAILURE_IF_REACHABLE:
           x.set_attribute("status", "FAILURE (if reachable)");
           ++fail;
-        }
-        else if(domain.is_bottom())
-        {
+          break;
+        case ai_verifier_statust::SUCCESS_UNREACHABLE:
           x.set_attribute("status", "SUCCESS (unreachable)");
           ++pass;
-        }
-        else
-        {
+          break;
+        case ai_verifier_statust::UNKNOWN:
           x.set_attribute("status", "UNKNOWN");
           ++unknown;
         }
@@ -144,11 +171,12 @@ bool static_verifier(
 
     forall_goto_functions(f_it, goto_model.goto_functions)
     {
-      m.progress() << "Checking " << f_it->first << messaget::eom;
-
-      if(!f_it->second.body.has_assertion())
+      ai_verifier_resultst::const_iterator r_it=results.find(f_it->first);
+      if(r_it==results.end())
         continue;
 
+      auto status=r_it->second.begin();
+
       out << "******** Function " << f_it->first << '\n';
 
       forall_goto_program_instructions(i_it, f_it->second.body)
@@ -156,10 +184,6 @@ bool static_verifier(
         if(!i_it->is_assert())
           continue;
 
-        exprt e(i_it->guard);
-        const ai_domain_baset &domain(ai.abstract_state_before(i_it));
-        domain.ai_simplify(e, ns);
-
         out << '[' << i_it->source_location.get_property_id()
             << ']' << ' ';
 
@@ -170,23 +194,21 @@ bool static_verifier(
 
         out << ": ";
 
-        if(e.is_true())
+        switch(*status++)
         {
+        case ai_verifier_statust::SUCCESS:
           out << "Success";
           pass++;
-        }
-        else if(e.is_false())
-        {
+          break;
+        case ai_verifier_statust::FAILURE_IF_REACHABLE:
           out << "Failure (if reachable)";
           fail++;
-        }
-        else if(domain.is_bottom())
-        {
+          break;
+        case ai_verifier_statust::SUCCESS_UNREACHABLE:
           out << "Success (unreachable)";
           pass++;
-        }
-        else
-        {
+          break;
+        case ai_verifier_statust::UNKNOWN:
           out << "Unknown";
           unknown++;
         }
@@ -202,6 +224,206 @@ bool static_verifier(
              << pass << " pass, "
              << fail << " fail if reachable, "
              << unknown << " unknown\n";
+}
+
+/// Runs the analyzer and then prints out the domain
+/// \param goto_model: the program analyzed
+/// \param ai: the abstract interpreter after it has been run to fix point
+/// \param options: the parsed user options
+/// \param message_handler: the system message handler
+/// \param out: output stream for the printing
+/// \return: false on success with the domain printed to out
+bool static_verifier(
+  const goto_modelt &goto_model,
+  const ai_baset &ai,
+  const optionst &options,
+  message_handlert &message_handler,
+  std::ostream &out)
+{
+  namespacet ns(goto_model.symbol_table);
+
+  messaget m(message_handler);
+  m.status() << "Checking assertions" << messaget::eom;
+
+  ai_verifier_resultst results;
+
+  forall_goto_functions(f_it, goto_model.goto_functions)
+  {
+    m.progress() << "Checking " << f_it->first << messaget::eom;
+
+    if(!f_it->second.body.has_assertion())
+      continue;
+
+    check_assertions(f_it->second, ai, ns, results[f_it->first]);
+  }
+
+  output_results(goto_model, results, options, m, out);
+
+  return false;
+}
+
+// marks the lines of the output of a worker that carry results
+static const char results_marker[]="static-verifier-results";
+
+/// Runs a function-modular analysis in up to \p jobs worker processes and
+/// then prints out the results of the assertions as static_verifier does.
+/// Each worker analyses some of the components of the call graph that
+/// contain assertions and writes the results of these to its standard
+/// output. The components of workers that fail are analysed in this
+/// process.
+/// \param goto_model: the program analyzed
+/// \param ai: the abstract interpreter, which has not been run yet
+/// \param jobs: the maximum number of worker processes
+/// \param options: the parsed user options
+/// \param message_handler: the system message handler
+/// \param out: output stream for the printing
+/// \return: false on success with the results printed to out
+bool parallel_static_verifier(
+  const goto_modelt &goto_model,
+  ai_baset &ai,
+  std::size_t jobs,
+  const optionst &options,
+  message_handlert &message_handler,
+  std::ostream &out)
+{
+  namespacet ns(goto_model.symbol_table);
+  const goto_functionst &goto_functions=goto_model.goto_functions;
+
+  messaget m(message_handler);
+
+  ai.set_function_modular(true);
+  ai.prepare_function_modular(goto_functions, ns);
+
+  // the components with assertions, which are all that need to be analysed
+  std::vector<const ai_baset::componentt *> components;
+
+  for(const auto &component : ai.function_components())
+  {
+    if(std::any_of(
+         component.begin(),
+         component.end(),
+         [&goto_functions](const irep_idt &identifier)
+         {
+           goto_functionst::function_mapt::const_iterator f_it=
+             goto_functions.function_map.find(identifier);
+           return f_it!=goto_functions.function_map.end() &&
+                  f_it->second.body.has_assertion();
+         }))
+      components.push_back(&component);
+  }
+
+  // a few batches of components per worker, as the components of a
+  // program are many and mostly small
+  const std::size_t batch_size=
+    std::max<std::size_t>(1, components.size()/(4*jobs));
+  std::vector<std::vector<const ai_baset::componentt *>> batches;
+
+  for(std::size_t i=0; i<components.size(); i+=batch_size)
+    batches.emplace_back(
+      components.begin()+i,
+      components.begin()+std::min(i+batch_size, components.size()));
+
+  m.status() << "Analysing " << components.size() << " components in "
+             << batches.size() << " batches using " << jobs << " workers"
+             << messaget::eom;
+
+  auto check_batch=[&](
+    const std::vector<const ai_baset::componentt *> &batch,
+    ai_verifier_resultst &results)
+  {
+    for(const auto component : batch)
+    {
+      ai.analyse_component(*component, goto_functions, ns);
+
+      for(const auto &identifier : *component)
+      {
+        goto_functionst::function_mapt::const_iterator f_it=
+          goto_functions.function_map.find(identifier);
+
+        if(f_it!=goto_functions.function_map.end() &&
+           f_it->second.body.has_assertion())
+          check_assertions(f_it->second, ai, ns, results[identifier]);
+      }
+    }
+  };
+
+  ai_verifier_resultst results;
+  std::vector<std::size_t> failed;
+
+  {
+    // workers must not change the analysis of this process
+    worker_poolt pool(jobs, true, false);
+    std::size_t next_batch=0;
+
+    while(next_batch<batches.size() || !pool.empty())
+    {
+      if(next_batch<batches.size() && !pool.full())
+      {
+        const auto &batch=batches[next_batch++];
+        pool.start([&check_batch, &batch]()
+        {
+          ai_verifier_resultst batch_results;
+          check_batch(batch, batch_results);
+
+          for(const auto &r : batch_results)
+          {
+            std::cout << results_marker << ' ';
+            for(const auto status : r.second)
+              std::cout << static_cast<int>(status);
+            std::cout << ' ' << r.first << '\n';
+          }
+
+          return 0;
+        });
+        continue;
+      }
+
+      worker_poolt::finishedt finished;
+      if(!pool.wait_any(finished))
+        break;
+
+      if(finished.exit_status!=0)
+      {
+        failed.push_back(finished.job_id);
+        continue;
+      }
+
+      std::istringstream lines(finished.output);
+      std::string line;
+
+      while(std::getline(lines, line))
+      {
+        std::istringstream fields(line);
+        std::string marker, statuses, identifier;
+
+        if(!(fields >> marker >> statuses) || marker!=results_marker)
+          continue;
+
+        fields.get();
+        std::getline(fields, identifier);
+
+        std::vector<ai_verifier_statust> &function_results=
+          results[identifier];
+
+        for(const char status : statuses)
+          function_results.push_back(
+            static_cast<ai_verifier_statust>(status-'0'));
+      }
+    }
+  }
+
+  if(!failed.empty())
+  {
+    m.warning() << failed.size() << " batches could not be analysed in "
+                << "workers, analysing them in this process" << messaget::eom;
+
+    for(const auto batch : failed)
+      check_batch(batches[batch], results);
+  }
+
+  m.status() << "Checking assertions" << messaget::eom;
+
+  output_results(goto_model, results, options, m, out);
 
   return false;
 }
@@ -25,4 +25,12 @@ bool static_verifier(
   message_handlert &,
   std::ostream &);
 
+bool parallel_static_verifier(
+  const goto_modelt &,
+  ai_baset &,
+  std::size_t jobs,
+  const optionst &,
+  message_handlert &,
+  std::ostream &);
+
 #endif // CPROVER_GOTO_ANALYZER_STATIC_VERIFIER_H
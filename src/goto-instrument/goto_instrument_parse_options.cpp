@@ -269,10 +269,9 @@ int goto_instrument_parse_optionst::doit()
       // recalculate numbers, etc.
       goto_model.goto_functions.update();
 
-      status() << "Pointer Analysis" << eom;
       namespacet ns(goto_model.symbol_table);
       value_set_analysist value_set_analysis(ns);
-      value_set_analysis(goto_model.goto_functions);
+      do_value_set_analysis(value_set_analysis);
       show_value_sets(get_ui(), goto_model, value_set_analysis);
       return CPROVER_EXIT_SUCCESS;
     }
@@ -451,9 +450,8 @@ int goto_instrument_parse_optionst::doit()
         goto_model.goto_functions.update();
       }
 
-      status() << "Pointer Analysis" << eom;
       value_set_analysist value_set_analysis(ns);
-      value_set_analysis(goto_model.goto_functions);
+      do_value_set_analysis(value_set_analysis);
 
       const symbolt &symbol=ns.lookup(ID_main);
       symbol_exprt main(symbol.name, symbol.type);
@@ -892,6 +890,57 @@ void goto_instrument_parse_optionst::do_remove_returns()
   remove_returns(goto_model);
 }
 
+/// Run the pointer analysis on the goto program. With --value-set-cache,
+/// the value sets of the functions that have not changed since the cache
+/// file was written are taken from there, and the file is updated with the
+/// results afterwards.
+void goto_instrument_parse_optionst::do_value_set_analysis(
+  value_set_analysist &value_set_analysis)
+{
+  status() << "Pointer Analysis" << eom;
+
+  if(!cmdline.isset("value-set-cache"))
+  {
+    value_set_analysis(goto_model.goto_functions);
+    return;
+  }
+
+  const std::string filename=cmdline.get_value("value-set-cache");
+  const namespacet ns(goto_model.symbol_table);
+  value_set_cachet cache;
+
+  std::ifstream in(filename, std::ios::binary);
+  if(in && cache.read(in))
+    warning() << "ignoring value-set cache `" << filename
+              << "' of another version" << eom;
+  in.close();
+
+  std::size_t functions=0;
+  forall_goto_functions(f_it, goto_model.goto_functions)
+    if(f_it->second.body_available())
+      functions++;
+
+  const std::size_t reused=
+    cache.reusable_functions(goto_model.goto_functions, ns).size();
+
+  statistics() << "Value sets of " << reused << " of " << functions
+               << " functions taken from `" << filename << "'" << eom;
+
+  value_set_analysis(goto_model.goto_functions, cache);
+
+  value_set_analysis.store(goto_model.goto_functions, cache);
+
+  std::ofstream out(filename, std::ios::binary);
+  if(!out)
+  {
+    warning() << "failed to write value-set cache `" << filename << "'"
+              << eom;
+    return;
+  }
+
+  cache.write(out);
+}
+
 void goto_instrument_parse_optionst::get_goto_program()
 {
   status() << "Reading GOTO program from `" << cmdline.args[0] << "'" << eom;
@@ -1201,9 +1250,8 @@ void goto_instrument_parse_optionst::instrument_goto_program()
   {
     do_indirect_call_and_rtti_removal();
 
-    status() << "Pointer Analysis" << eom;
     value_set_analysist value_set_analysis(ns);
-    value_set_analysis(goto_model.goto_functions);
+    do_value_set_analysis(value_set_analysis);
 
     if(cmdline.isset("remove-pointers"))
     {
@@ -1521,6 +1569,8 @@ void goto_instrument_parse_optionst::help()
     " --nondet-static              add nondeterministic initialization of variables with static lifetime\n" // NOLINT(*)
     " --check-invariant function   instruments invariant checking function\n"
     " --remove-pointers            converts pointer arithmetic to base+offset expressions\n" // NOLINT(*)
+    " --value-set-cache <file>     reuse the pointer analysis of unchanged functions\n" // NOLINT(*)
+    "                              from file, and update it\n"
     " --splice-call caller,callee  prepends a call to callee in the body of caller\n"  // NOLINT(*)
     // NOLINTNEXTLINE(whitespace/line_length)
     " --undefined-function-is-assume-false\n" // NOLINTNEXTLINE(whitespace/line_length)
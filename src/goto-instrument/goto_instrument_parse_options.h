@@ -24,6 +24,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <analyses/goto_check.h>
 
+#include <pointer-analysis/value_set_analysis.h>
+
 // clang-format off
 #define GOTO_INSTRUMENT_OPTIONS \
   "(all)" \
@@ -56,7 +58,7 @@ Author: Daniel Kroening, kroening@kroening.com
   OPT_SHOW_GOTO_FUNCTIONS \
   OPT_SHOW_PROPERTIES \
   "(drop-unused-functions)" \
-  "(show-value-sets)" \
+  "(show-value-sets)(value-set-cache):" \
   "(show-global-may-alias)" \
   "(show-local-bitvector-analysis)(show-custom-bitvector-analysis)" \
   "(show-escape-analysis)(escape-analysis)" \
@@ -120,6 +122,7 @@ protected:
   void do_remove_const_function_pointers_only();
   void do_partial_inlining();
   void do_remove_returns();
+  void do_value_set_analysis(value_set_analysist &value_set_analysis);
 
   bool function_pointer_removal_done;
   bool partial_inlining_done;
@@ -98,8 +98,7 @@ void goto_symext::trigger_auto_object(
       if(has_prefix(id2string(symbol.base_name), "auto_object"))
       {
         // done already?
-        if(state.level2.current_names.find(ssa_expr.get_identifier())==
-           state.level2.current_names.end())
+        if(!state.level2.has_name(ssa_expr.get_identifier()))
         {
           initialize_auto_object(expr, state);
         }
@@ -0,0 +1,127 @@
+/*******************************************************************\
+
+Module: Symbolic Execution
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Canonical Guards Using BDDs
+
+#include "bdd_guard_manager.h"
+
+#include <iterator>
+
+#include <util/std_expr.h>
+
+guardt bdd_guard_managert::disjunction(const guardt &g1, const guardt &g2)
+{
+  if(g1.is_true() || g2.is_false())
+    return g1;
+  if(g2.is_true() || g1.is_false())
+    return g2;
+
+  guardt result;
+  result=as_expr(from_expr(g1)|from_expr(g2));
+  return result;
+}
+
+guardt bdd_guard_managert::canonical(const guardt &guard)
+{
+  guardt result;
+  result=as_expr(from_expr(guard));
+  return result;
+}
+
+mini_bddt bdd_guard_managert::from_expr(const exprt &expr)
+{
+  PRECONDITION(expr.type().id()==ID_bool);
+
+  if(expr.is_true())
+    return bdd_mgr.True();
+  else if(expr.is_false())
+    return bdd_mgr.False();
+
+  const auto canonical_entry=canonical_exprs.find(&expr.read());
+  if(canonical_entry!=canonical_exprs.end())
+    return canonical_entry->second;
+
+  if(expr.id()==ID_not && expr.operands().size()==1)
+    return !from_expr(expr.op0());
+  else if((expr.id()==ID_and || expr.id()==ID_or) && expr.has_operands())
+  {
+    mini_bddt result=from_expr(expr.op0());
+    for(auto it=std::next(expr.operands().begin());
+        it!=expr.operands().end();
+        it++)
+    {
+      if(expr.id()==ID_and)
+        result=result&from_expr(*it);
+      else
+        result=result|from_expr(*it);
+    }
+    return result;
+  }
+  else if(expr.id()==ID_implies && expr.operands().size()==2)
+    return (!from_expr(expr.op0()))|from_expr(expr.op1());
+  else if(expr.id()==ID_if && expr.type().id()==ID_bool)
+  {
+    const if_exprt &if_expr=to_if_expr(expr);
+    const mini_bddt cond=from_expr(if_expr.cond());
+    return (cond&from_expr(if_expr.true_case()))|
+           ((!cond)&from_expr(if_expr.false_case()));
+  }
+
+  // anything else is an atomic condition
+  const auto entry=atoms.insert(std::make_pair(expr, mini_bddt()));
+  if(entry.second)
+  {
+    entry.first->second=bdd_mgr.Var(std::to_string(atom_exprs.size()));
+    atom_exprs.push_back(expr);
+  }
+  return entry.first->second;
+}
+
+exprt bdd_guard_managert::as_expr(const mini_bddt &bdd)
+{
+  if(bdd.is_true())
+    return true_exprt();
+  else if(bdd.is_false())
+    return false_exprt();
+
+  const auto entry=node_exprs.find(bdd.node_number());
+  if(entry!=node_exprs.end())
+    return entry->second.expr;
+
+  // miniBDD numbers the variables from 1, in the order of creation
+  PRECONDITION(bdd.var()>=1 && bdd.var()<=atom_exprs.size());
+  const exprt &atom=atom_exprs[bdd.var()-1];
+
+  exprt result;
+
+  if(bdd.low().is_false())
+  {
+    result=bdd.high().is_true()?
+      atom:static_cast<exprt>(and_exprt(atom, as_expr(bdd.high())));
+  }
+  else if(bdd.high().is_false())
+  {
+    result=bdd.low().is_true()?
+      static_cast<exprt>(not_exprt(atom)):
+      static_cast<exprt>(and_exprt(not_exprt(atom), as_expr(bdd.low())));
+  }
+  else if(bdd.low().is_true())
+    result=or_exprt(not_exprt(atom), as_expr(bdd.high()));
+  else if(bdd.high().is_true())
+    result=or_exprt(atom, as_expr(bdd.low()));
+  else
+    result=if_exprt(atom, as_expr(bdd.high()), as_expr(bdd.low()));
+
+  node_exprt &node_expr=node_exprs[bdd.node_number()];
+  node_expr.bdd=bdd;
+  node_expr.expr=result;
+  canonical_exprs.insert(std::make_pair(&node_expr.expr.read(), bdd));
+
+  return result;
+}
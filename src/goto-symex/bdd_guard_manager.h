@@ -0,0 +1,80 @@
+/*******************************************************************\
+
+Module: Symbolic Execution
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Canonical Guards Using BDDs
+
+#ifndef CPROVER_GOTO_SYMEX_BDD_GUARD_MANAGER_H
+#define CPROVER_GOTO_SYMEX_BDD_GUARD_MANAGER_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <util/guard.h>
+
+#include <solvers/miniBDD/miniBDD.h>
+
+/// \brief Keeps guards in a canonical form
+///
+/// The disjunction of guards that guardt::operator|= computes at merge
+/// points only factors out a common prefix of conjuncts, and the resulting
+/// or-expressions keep growing with the nesting depth of the branches. This
+/// class computes the disjunction on BDDs over the atomic conditions
+/// instead, and turns the result back into an expression in which every BDD
+/// node is represented by the same, shared expression. Equivalent guards
+/// thus become equal, and unsatisfiable ones become false.
+///
+/// Guards are looked up by the address of their expression first, which
+/// makes converting a guard this class produced a constant-time operation.
+class bdd_guard_managert
+{
+public:
+  /// \return the disjunction of \p g1 and \p g2, in canonical form
+  guardt disjunction(const guardt &g1, const guardt &g2);
+
+  /// \return \p guard in canonical form
+  guardt canonical(const guardt &guard);
+
+  /// number of atomic conditions
+  std::size_t number_of_atoms() const
+  {
+    return atoms.size();
+  }
+
+  /// number of BDD nodes
+  std::size_t number_of_nodes() const
+  {
+    return bdd_mgr.number_of_nodes();
+  }
+
+protected:
+  mini_bdd_mgrt bdd_mgr;
+
+  // the atomic conditions, which are the BDD variables
+  typedef std::unordered_map<exprt, mini_bddt, irep_hash> atomst;
+  atomst atoms;
+  std::vector<exprt> atom_exprs;
+
+  // The expression for each BDD node that has been converted. Holding
+  // the BDD keeps the node, and thus its number, alive.
+  struct node_exprt
+  {
+    mini_bddt bdd;
+    exprt expr;
+  };
+  std::unordered_map<unsigned, node_exprt> node_exprs;
+
+  // the BDDs of the expressions in node_exprs, by the address of the
+  // expression's data
+  std::unordered_map<const void *, mini_bddt> canonical_exprs;
+
+  mini_bddt from_expr(const exprt &);
+  exprt as_expr(const mini_bddt &);
+};
+
+#endif // CPROVER_GOTO_SYMEX_BDD_GUARD_MANAGER_H
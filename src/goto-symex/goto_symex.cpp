@@ -11,7 +11,9 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "goto_symex.h"
 
+#include <util/merge_irep.h>
 #include <util/simplify_expr.h>
+#include <util/simplify_expr_class.h>
 
 unsigned goto_symext::nondet_count=0;
 unsigned goto_symext::dynamic_counter=0;
@@ -19,7 +21,24 @@ unsigned goto_symext::dynamic_counter=0;
 void goto_symext::do_simplify(exprt &expr)
 {
   if(options.get_bool_option("simplify"))
-    simplify(expr, ns);
+  {
+    simplify_exprt simplifier(ns);
+    simplifier.cache=simplify_cache.get();
+    simplifier.simplify(expr);
+  }
+  else
+    hash_cons(expr);
+}
+
+void goto_symext::reset_simplify_cache()
+{
+  const unsigned capacity=options.get_unsigned_int_option("simplify-cache");
+
+  if(capacity==0)
+    simplify_cache.reset();
+  else
+    simplify_cache=std::unique_ptr<simplify_expr_cachet>(
+      new simplify_expr_cachet(capacity));
 }
 
 void goto_symext::replace_nondet(exprt &expr)
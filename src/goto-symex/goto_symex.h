@@ -12,13 +12,18 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_GOTO_SYMEX_GOTO_SYMEX_H
 #define CPROVER_GOTO_SYMEX_GOTO_SYMEX_H
 
+#include <memory>
+
 #include <util/options.h>
 #include <util/message.h>
 #include <util/byte_operators.h>
+#include <util/simplify_expr_cache.h>
 
 #include <goto-programs/goto_functions.h>
 
+#include "bdd_guard_manager.h"
 #include "goto_symex_state.h"
+#include "path_storage.h"
 #include "symex_target_equation.h"
 
 class typet;
@@ -47,24 +52,8 @@ class goto_symext
 public:
   typedef goto_symex_statet statet;
 
-  /// \brief Information saved at a conditional goto to resume execution
-  struct branch_pointt
-  {
-    symex_target_equationt equation;
-    statet state;
-
-    explicit branch_pointt(const symex_target_equationt &e, const statet &s)
-      : equation(e), state(s, &equation)
-    {
-    }
-
-    explicit branch_pointt(const branch_pointt &other)
-      : equation(other.equation), state(other.state, &equation)
-    {
-    }
-  };
-
-  typedef std::list<branch_pointt> branch_worklistt;
+  typedef ::branch_pointt branch_pointt;
+  typedef path_storaget branch_worklistt;
 
   goto_symext(
     message_handlert &mh,
@@ -213,6 +202,18 @@ public:
 
   optionst options;
 
+  /// \return the cache of do_simplify, or nullptr if there is none
+  const simplify_expr_cachet *get_simplify_cache() const
+  {
+    return simplify_cache.get();
+  }
+
+  /// \return the manager of canonical guards, or nullptr if there is none
+  const bdd_guard_managert *get_guard_manager() const
+  {
+    return guard_manager.get();
+  }
+
   /// language_mode: ID_java, ID_C or another language identifier
   /// if we know the source language in use, irep_idt() otherwise.
   irep_idt language_mode;
@@ -314,6 +315,10 @@ protected:
     const statet::goto_statet &goto_state,
     statet &);
 
+  /// Canonical guards for merge points, created on first use if the
+  /// "bdd-guards" option is set
+  std::unique_ptr<bdd_guard_managert> guard_manager;
+
   void merge_value_sets(
     const statet::goto_statet &goto_state,
     statet &dest);
@@ -382,6 +387,11 @@ protected:
 
   virtual void do_simplify(exprt &);
 
+  /// Results of do_simplify, if the "simplify-cache" option is set. The
+  /// results depend on `ns`, so the cache is replaced whenever `ns` is.
+  std::unique_ptr<simplify_expr_cachet> simplify_cache;
+  void reset_simplify_cache();
+
   void symex_assign(statet &, const code_assignt &);
 
   // havocs the given object
@@ -71,12 +71,14 @@ void goto_symex_statet::level1t::operator()(ssa_exprt &ssa_expr)
 
   const irep_idt l0_name=ssa_expr.get_l1_object_identifier();
 
-  current_namest::const_iterator it=current_names.find(l0_name);
-  if(it==current_names.end())
+  // look up via a const reference such that nothing is unshared
+  const current_namest &names=current_names;
+  const auto entry=names.find(l0_name);
+  if(!entry.second)
     return;
 
   // rename!
-  ssa_expr.set_level_1(it->second.second);
+  ssa_expr.set_level_1(entry.first.second);
 }
 
 /// This function determines what expressions are to be propagated as
@@ -331,8 +333,8 @@ void goto_symex_statet::assignment(
   #endif
 
   // do the l2 renaming
-  if(level2.current_names.find(l1_identifier)==level2.current_names.end())
-    level2.current_names[l1_identifier]=std::make_pair(lhs, 0);
+  if(!level2.has_name(l1_identifier))
+    level2.set_name(l1_identifier, lhs, 0);
   level2.increase_counter(l1_identifier);
   set_ssa_indices(lhs, ns, L2);
 
@@ -601,8 +603,8 @@ bool goto_symex_statet::l2_thread_read_encoding(
 
     if(a_s_read.second.empty())
     {
-      if(level2.current_names.find(l1_identifier)==level2.current_names.end())
-        level2.current_names[l1_identifier]=std::make_pair(ssa_l1, 0);
+      if(!level2.has_name(l1_identifier))
+        level2.set_name(l1_identifier, ssa_l1, 0);
       level2.increase_counter(l1_identifier);
       a_s_read.first=level2.current_count(l1_identifier);
     }
@@ -639,8 +641,8 @@ bool goto_symex_statet::l2_thread_read_encoding(
     return true;
   }
 
-  if(level2.current_names.find(l1_identifier)==level2.current_names.end())
-    level2.current_names[l1_identifier]=std::make_pair(ssa_l1, 0);
+  if(!level2.has_name(l1_identifier))
+    level2.set_name(l1_identifier, ssa_l1, 0);
 
   // No event and no fresh index, but avoid constant propagation
   if(!record_events)
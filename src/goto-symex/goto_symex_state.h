@@ -22,6 +22,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/std_expr.h>
 #include <util/ssa_expr.h>
 #include <util/make_unique.h>
+#include <util/sharing_map.h>
 
 #include <pointer-analysis/value_set.h>
 #include <goto-programs/goto_functions.h>
@@ -68,28 +69,50 @@ public:
   {
     virtual ~renaming_levelt() { }
 
-    typedef std::map<irep_idt, std::pair<ssa_exprt, unsigned> > current_namest;
+    /// Copies of a renaming level share all unchanged entries, which keeps
+    /// saving states (at branch points, or goto_statet instances waiting to
+    /// be merged) cheap, and allows phi_function to visit only those entries
+    /// that differ between two states.
+    typedef sharing_mapt<
+      irep_idt,
+      std::pair<ssa_exprt, unsigned>,
+      irep_id_hash> current_namest;
     current_namest current_names;
 
     unsigned current_count(const irep_idt &identifier) const
     {
-      current_namest::const_iterator it=
-        current_names.find(identifier);
-      return it==current_names.end()?0:it->second.second;
+      const auto entry=current_names.find(identifier);
+      return entry.second?entry.first.second:0;
+    }
+
+    bool has_name(const irep_idt &identifier) const
+    {
+      return current_names.has_key(identifier);
+    }
+
+    /// Add \p identifier with the given name and counter, or replace the
+    /// name and counter if \p identifier is already present
+    void set_name(
+      const irep_idt &identifier,
+      const ssa_exprt &ssa,
+      unsigned count)
+    {
+      const auto entry=current_names.place(identifier, std::make_pair(ssa, 0));
+      entry.first=std::make_pair(ssa, count);
     }
 
     void increase_counter(const irep_idt &identifier)
     {
-      PRECONDITION(current_names.find(identifier) != current_names.end());
-      ++current_names[identifier].second;
+      PRECONDITION(has_name(identifier));
+      ++current_names.find(identifier).first.second;
     }
 
     void get_variables(std::unordered_set<ssa_exprt, irep_hash> &vars) const
     {
-      for(current_namest::const_iterator it=current_names.begin();
-          it!=current_names.end();
-          it++)
-        vars.insert(it->second.first);
+      current_namest::viewt view;
+      current_names.get_view(view);
+      for(const auto &entry : view)
+        vars.insert(entry.second.first);
     }
   };
 
@@ -115,22 +138,13 @@ public:
 
     void restore_from(const current_namest &other)
     {
-      current_namest::iterator it=current_names.begin();
-      for(current_namest::const_iterator
-          ito=other.begin();
-          ito!=other.end();
-          ++ito)
+      current_namest::viewt view;
+      other.get_view(view);
+      for(const auto &entry : view)
       {
-        while(it!=current_names.end() && it->first<ito->first)
-          ++it;
-        if(it==current_names.end() || ito->first<it->first)
-          current_names.insert(it, *ito);
-        else if(it!=current_names.end())
-        {
-          PRECONDITION(it->first == ito->first);
-          it->second=ito->second;
-          ++it;
-        }
+        const auto existing=current_names.place(entry.first, entry.second);
+        if(!existing.second)
+          existing.first=entry.second;
       }
     }
 
@@ -226,18 +240,16 @@ public:
     void level2_get_variables(
       std::unordered_set<ssa_exprt, irep_hash> &vars) const
     {
-      for(level2t::current_namest::const_iterator
-          it=level2_current_names.begin();
-          it!=level2_current_names.end();
-          it++)
-        vars.insert(it->second.first);
+      level2t::current_namest::viewt view;
+      level2_current_names.get_view(view);
+      for(const auto &entry : view)
+        vars.insert(entry.second.first);
     }
 
     unsigned level2_current_count(const irep_idt &identifier) const
     {
-      level2t::current_namest::const_iterator it=
-        level2_current_names.find(identifier);
-      return it==level2_current_names.end()?0:it->second.second;
+      const auto entry=level2_current_names.find(identifier);
+      return entry.second?entry.first.second:0;
     }
   };
 
@@ -0,0 +1,105 @@
+/*******************************************************************\
+
+Module: Path Storage
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Storage of saved branch points for path exploration, and the strategies
+/// that decide which saved path is resumed next
+
+#include "path_storage.h"
+
+#include <util/invariant.h>
+
+path_strategyt::pathst::iterator path_randomt::select(pathst &paths)
+{
+  std::uniform_int_distribution<std::size_t> distribution(
+    0, paths.size()-1);
+  return std::next(paths.begin(), distribution(generator));
+}
+
+path_strategyt::pathst::iterator path_coverage_guidedt::select(pathst &paths)
+{
+  pathst::iterator best=paths.end();
+  std::size_t best_count=0;
+
+  // walk backwards such that, among equally covered targets, the most
+  // recently saved branch point wins
+  for(auto it=paths.end(); it!=paths.begin();)
+  {
+    --it;
+    const auto entry=resumed.find(it->state.saved_target->location_number);
+    const std::size_t count=entry==resumed.end()?0:entry->second;
+
+    if(best==paths.end() || count<best_count)
+    {
+      best=it;
+      best_count=count;
+    }
+  }
+
+  ++resumed[best->state.saved_target->location_number];
+
+  return best;
+}
+
+path_storaget::path_storaget():
+  path_storaget(std::unique_ptr<path_strategyt>(new path_fifot()))
+{
+}
+
+path_storaget::path_storaget(std::unique_ptr<path_strategyt> _strategy):
+  strategy(std::move(_strategy)),
+  has_selected(false)
+{
+  PRECONDITION(strategy);
+}
+
+branch_pointt &path_storaget::next()
+{
+  PRECONDITION(!empty());
+
+  if(!has_selected)
+  {
+    selected=strategy->select(paths);
+    has_selected=true;
+  }
+
+  return *selected;
+}
+
+void path_storaget::pop_next()
+{
+  PRECONDITION(has_selected);
+  paths.erase(selected);
+  has_selected=false;
+}
+
+void path_storaget::move_next_to(path_storaget &dest)
+{
+  next();
+  dest.paths.splice(dest.paths.end(), paths, selected);
+  has_selected=false;
+}
+
+std::unique_ptr<path_strategyt> get_path_strategy(const std::string &name)
+{
+  if(name.empty() || name=="fifo")
+    return std::unique_ptr<path_strategyt>(new path_fifot());
+  else if(name=="lifo")
+    return std::unique_ptr<path_strategyt>(new path_lifot());
+  else if(name=="random")
+    return std::unique_ptr<path_strategyt>(new path_randomt(0));
+  else if(name=="coverage")
+    return std::unique_ptr<path_strategyt>(new path_coverage_guidedt());
+  else
+    return nullptr;
+}
+
+std::string path_strategy_names()
+{
+  return "fifo, lifo, random, coverage";
+}
@@ -0,0 +1,194 @@
+/*******************************************************************\
+
+Module: Path Storage
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Storage of saved branch points for path exploration, and the strategies
+/// that decide which saved path is resumed next
+
+#ifndef CPROVER_GOTO_SYMEX_PATH_STORAGE_H
+#define CPROVER_GOTO_SYMEX_PATH_STORAGE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "goto_symex_state.h"
+#include "symex_target_equation.h"
+
+/// \brief Information saved at a conditional goto to resume execution
+struct branch_pointt
+{
+  symex_target_equationt equation;
+  goto_symex_statet state;
+
+  explicit branch_pointt(
+    const symex_target_equationt &e,
+    const goto_symex_statet &s)
+    : equation(e), state(s, &equation)
+  {
+  }
+
+  explicit branch_pointt(const branch_pointt &other)
+    : equation(other.equation), state(other.state, &equation)
+  {
+  }
+};
+
+/// \brief Decides which saved branch point is resumed next
+class path_strategyt
+{
+public:
+  typedef std::list<branch_pointt> pathst;
+
+  virtual ~path_strategyt()
+  {
+  }
+
+  /// Choose one of the (non-empty) list of saved branch points
+  virtual pathst::iterator select(pathst &paths)=0;
+
+  /// Create a strategy of the same kind in its initial state, e.g., for
+  /// a worker that explores part of the paths
+  virtual std::unique_ptr<path_strategyt> clone() const=0;
+};
+
+/// \brief Breadth-first exploration: resume the oldest saved branch point
+class path_fifot:public path_strategyt
+{
+public:
+  pathst::iterator select(pathst &paths) override
+  {
+    return paths.begin();
+  }
+
+  std::unique_ptr<path_strategyt> clone() const override
+  {
+    return std::unique_ptr<path_strategyt>(new path_fifot());
+  }
+};
+
+/// \brief Depth-first exploration: resume the most recently saved branch
+/// point. The number of saved branch points is bounded by the depth of the
+/// current path.
+class path_lifot:public path_strategyt
+{
+public:
+  pathst::iterator select(pathst &paths) override
+  {
+    return std::prev(paths.end());
+  }
+
+  std::unique_ptr<path_strategyt> clone() const override
+  {
+    return std::unique_ptr<path_strategyt>(new path_lifot());
+  }
+};
+
+/// \brief Random restarts: resume a saved branch point chosen uniformly at
+/// random, using a fixed seed so that runs are reproducible
+class path_randomt:public path_strategyt
+{
+public:
+  explicit path_randomt(unsigned _seed):seed(_seed), generator(_seed)
+  {
+  }
+
+  pathst::iterator select(pathst &paths) override;
+
+  std::unique_ptr<path_strategyt> clone() const override
+  {
+    return std::unique_ptr<path_strategyt>(new path_randomt(seed));
+  }
+
+protected:
+  unsigned seed;
+  std::mt19937 generator;
+};
+
+/// \brief Coverage-guided exploration: resume the saved branch point whose
+/// target instruction has been resumed from least often, preferring the most
+/// recently saved one among those
+class path_coverage_guidedt:public path_strategyt
+{
+public:
+  pathst::iterator select(pathst &paths) override;
+
+  std::unique_ptr<path_strategyt> clone() const override
+  {
+    return std::unique_ptr<path_strategyt>(new path_coverage_guidedt());
+  }
+
+protected:
+  // number of times we resumed from a branch point, by location number of
+  // the saved target instruction
+  std::map<unsigned, std::size_t> resumed;
+};
+
+/// \brief Saved branch points of path exploration
+///
+/// The order in which paths are resumed is determined by a path_strategyt.
+/// The branch point returned by next() stays valid (and in particular, is not
+/// affected by further calls to push_back()) until it is removed by
+/// pop_next().
+class path_storaget
+{
+public:
+  /// Breadth-first exploration
+  path_storaget();
+
+  explicit path_storaget(std::unique_ptr<path_strategyt> _strategy);
+
+  path_storaget(const path_storaget &)=delete;
+
+  void push_back(const branch_pointt &branch_point)
+  {
+    paths.push_back(branch_point);
+  }
+
+  /// The branch point that is to be resumed next
+  branch_pointt &next();
+
+  /// Remove the branch point returned by the last call to next()
+  void pop_next();
+
+  /// Move the branch point that would be resumed next into \p dest
+  void move_next_to(path_storaget &dest);
+
+  bool empty() const
+  {
+    return paths.empty();
+  }
+
+  std::size_t size() const
+  {
+    return paths.size();
+  }
+
+  const path_strategyt &get_strategy() const
+  {
+    return *strategy;
+  }
+
+protected:
+  path_strategyt::pathst paths;
+  std::unique_ptr<path_strategyt> strategy;
+
+  path_strategyt::pathst::iterator selected;
+  bool has_selected;
+};
+
+/// Create the path strategy with the given name
+/// \return nullptr if there is no such strategy
+std::unique_ptr<path_strategyt> get_path_strategy(const std::string &name);
+
+/// Comma-separated names of the available path strategies
+std::string path_strategy_names();
+
+#endif // CPROVER_GOTO_SYMEX_PATH_STORAGE_H
@@ -329,26 +329,27 @@ void goto_symext::pop_frame(statet &state)
     state.level1.restore_from(frame.old_level1);
 
     // clear function-locals from L2 renaming
-    for(goto_symex_statet::renaming_levelt::current_namest::iterator
-        c_it=state.level2.current_names.begin();
-        c_it!=state.level2.current_names.end();
-       ) // no ++c_it
+    goto_symex_statet::renaming_levelt::current_namest::viewt view;
+    state.level2.current_names.get_view(view);
+    std::vector<irep_idt> keys_to_erase;
+
+    for(const auto &c : view)
     {
-      const irep_idt l1_o_id=c_it->second.first.get_l1_object_identifier();
+      const irep_idt l1_o_id=c.second.first.get_l1_object_identifier();
       // could use iteration over local_objects as l1_o_id is prefix
       if(
         frame.local_objects.find(l1_o_id) == frame.local_objects.end() ||
         (state.threads.size() > 1 &&
-         state.dirty(c_it->second.first.get_object_name())))
+         state.dirty(c.second.first.get_object_name())))
       {
-        ++c_it;
         continue;
       }
-      goto_symex_statet::renaming_levelt::current_namest::iterator
-        cur=c_it;
-      ++c_it;
-      state.level2.current_names.erase(cur);
+      keys_to_erase.push_back(c.first);
     }
+
+    // the view refers into the map, so don't erase while walking it
+    for(const irep_idt &key : keys_to_erase)
+      state.level2.current_names.erase(key);
   }
 
   state.pop_frame();
@@ -393,18 +394,22 @@ void goto_symext::locality(
     const irep_idt l0_name=ssa.get_identifier();
 
     // save old L1 name for popping the frame
-    statet::level1t::current_namest::const_iterator c_it=
-      state.level1.current_names.find(l0_name);
+    const statet::level1t::current_namest &level1_names=
+      state.level1.current_names;
+    const auto c_it=level1_names.find(l0_name);
 
-    if(c_it!=state.level1.current_names.end())
-      frame.old_level1[l0_name]=c_it->second;
+    if(c_it.second)
+    {
+      const auto old=frame.old_level1.place(l0_name, c_it.first);
+      if(!old.second)
+        old.first=c_it.first;
+    }
 
     // do L1 renaming -- these need not be unique, as
     // identifiers may be shared among functions
     // (e.g., due to inlining or other code restructuring)
 
-    state.level1.current_names[l0_name]=
-      std::make_pair(ssa, frame_nr);
+    state.level1.set_name(l0_name, ssa, frame_nr);
     state.rename(ssa, ns, goto_symex_statet::L1);
 
     irep_idt l1_name=ssa.get_identifier();
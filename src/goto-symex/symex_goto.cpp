@@ -325,7 +325,16 @@ void goto_symext::merge_goto(
   merge_value_sets(goto_state, state);
 
   // adjust guard
-  state.guard|=goto_state.guard;
+  if(options.get_bool_option("bdd-guards"))
+  {
+    if(!guard_manager)
+      guard_manager=std::unique_ptr<bdd_guard_managert>(
+        new bdd_guard_managert());
+
+    state.guard=guard_manager->disjunction(state.guard, goto_state.guard);
+  }
+  else
+    state.guard|=goto_state.guard;
 
   // adjust depth
   state.depth=std::min(state.depth, goto_state.depth);
@@ -348,11 +357,27 @@ void goto_symext::phi_function(
   const statet::goto_statet &goto_state,
   statet &dest_state)
 {
-  // go over all variables to see what changed
+  // go over all variables to see what changed; the renaming maps share
+  // the entries that neither state has touched since they were split, and
+  // the delta views skip those
   std::unordered_set<ssa_exprt, irep_hash> variables;
 
-  goto_state.level2_get_variables(variables);
-  dest_state.level2.get_variables(variables);
+  {
+    statet::level2t::current_namest::delta_viewt delta_view;
+    goto_state.level2_current_names.get_delta_view(
+      dest_state.level2.current_names, delta_view, false);
+    for(const auto &delta_item : delta_view)
+      variables.insert(delta_item.m.first);
+  }
+
+  {
+    statet::level2t::current_namest::delta_viewt delta_view;
+    dest_state.level2.current_names.get_delta_view(
+      goto_state.level2_current_names, delta_view, false);
+    for(const auto &delta_item : delta_view)
+      if(!delta_item.in_both)
+        variables.insert(delta_item.m.first);
+  }
 
   guardt diff_guard;
 
@@ -193,6 +193,7 @@ void goto_symext::symex_with_state(
   // `state`'s symbol table and the symbol table of the original
   // goto-program.
   ns = namespacet(outer_symbol_table, state.symbol_table);
+  reset_simplify_cache();
 
   PRECONDITION(state.top().end_of_function->is_end_function());
 
@@ -251,6 +252,7 @@ void goto_symext::symex_instruction_range(
 {
   initialize_entry_point(state, get_goto_function, first, limit);
   ns = namespacet(outer_symbol_table, state.symbol_table);
+  reset_simplify_cache();
   while(state.source.pc->function!=limit->function || state.source.pc!=limit)
     symex_threaded_step(state, get_goto_function);
 }
@@ -51,26 +51,32 @@ void goto_symext::symex_start_thread(statet &state)
   // create a copy of the local variables for the new thread
   statet::framet &frame=state.top();
 
-  for(goto_symex_statet::renaming_levelt::current_namest::const_iterator
-      c_it=state.level2.current_names.begin();
-      c_it!=state.level2.current_names.end();
-      ++c_it)
+  // The assignments below modify the L2 renaming, so collect the current
+  // names first. Sort them to make the order of assignments deterministic.
+  std::map<irep_idt, ssa_exprt> level2_names;
   {
-    const irep_idt l1_o_id=c_it->second.first.get_l1_object_identifier();
+    goto_symex_statet::renaming_levelt::current_namest::viewt view;
+    state.level2.current_names.get_view(view);
+    for(const auto &entry : view)
+      level2_names.insert(std::make_pair(entry.first, entry.second.first));
+  }
+
+  for(const auto &c : level2_names)
+  {
+    const irep_idt l1_o_id=c.second.get_l1_object_identifier();
     // could use iteration over local_objects as l1_o_id is prefix
     if(frame.local_objects.find(l1_o_id)==frame.local_objects.end())
       continue;
 
     // get original name
-    ssa_exprt lhs(c_it->second.first.get_original_expr());
+    ssa_exprt lhs(c.second.get_original_expr());
 
     // get L0 name for current thread
     lhs.set_level_0(t);
 
     // set up L1 name
     if(!state.level1.current_names.insert(
-        std::make_pair(lhs.get_l1_object_identifier(),
-                       std::make_pair(lhs, 0))).second)
+        lhs.get_l1_object_identifier(), std::make_pair(lhs, 0)).second)
       UNREACHABLE;
     state.rename(lhs, ns, goto_symex_statet::L1);
     const irep_idt l1_name=lhs.get_l1_object_identifier();
@@ -79,7 +85,7 @@ void goto_symext::symex_start_thread(statet &state)
     new_thread.call_stack.back().local_objects.insert(l1_name);
 
     // make copy
-    ssa_exprt rhs=c_it->second.first;
+    ssa_exprt rhs=c.second;
 
     guardt guard;
     const bool record_events=state.record_events;
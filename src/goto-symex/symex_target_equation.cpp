@@ -11,7 +11,9 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "symex_target_equation.h"
 
+#include <util/namespace.h>
 #include <util/std_expr.h>
+#include <util/symbol.h>
 
 #include <langapi/language_util.h>
 #include <solvers/prop/prop_conv.h>
@@ -36,7 +38,7 @@ void symex_target_equationt::shared_read(
   SSA_step.atomic_section_id=atomic_section_id;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// write to a sharedvariable
@@ -55,7 +57,7 @@ void symex_target_equationt::shared_write(
   SSA_step.atomic_section_id=atomic_section_id;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// spawn a new thread
@@ -69,7 +71,7 @@ void symex_target_equationt::spawn(
   SSA_step.type=goto_trace_stept::typet::SPAWN;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 void symex_target_equationt::memory_barrier(
@@ -82,7 +84,7 @@ void symex_target_equationt::memory_barrier(
   SSA_step.type=goto_trace_stept::typet::MEMORY_BARRIER;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// start an atomic section
@@ -98,7 +100,7 @@ void symex_target_equationt::atomic_begin(
   SSA_step.atomic_section_id=atomic_section_id;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// end an atomic section
@@ -114,7 +116,7 @@ void symex_target_equationt::atomic_end(
   SSA_step.atomic_section_id=atomic_section_id;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// write to a variable
@@ -145,7 +147,7 @@ void symex_target_equationt::assignment(
                    assignment_type!=assignment_typet::VISIBLE_ACTUAL_PARAMETER);
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// declare a fresh variable
@@ -172,7 +174,7 @@ void symex_target_equationt::decl(
   // there so we see the symbols
   SSA_step.cond_expr=equal_exprt(SSA_step.ssa_lhs, SSA_step.ssa_lhs);
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// declare a fresh variable
@@ -196,7 +198,7 @@ void symex_target_equationt::location(
   SSA_step.type=goto_trace_stept::typet::LOCATION;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// just record a location
@@ -213,7 +215,7 @@ void symex_target_equationt::function_call(
   SSA_step.source=source;
   SSA_step.identifier=identifier;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// just record a location
@@ -230,7 +232,7 @@ void symex_target_equationt::function_return(
   SSA_step.source=source;
   SSA_step.identifier=identifier;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// just record output
@@ -249,7 +251,7 @@ void symex_target_equationt::output(
   SSA_step.io_args=args;
   SSA_step.io_id=output_id;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// just record formatted output
@@ -271,7 +273,7 @@ void symex_target_equationt::output_fmt(
   SSA_step.formatted=true;
   SSA_step.format_string=fmt;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// just record input
@@ -290,7 +292,7 @@ void symex_target_equationt::input(
   SSA_step.io_args=args;
   SSA_step.io_id=input_id;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// record an assumption
@@ -307,7 +309,7 @@ void symex_target_equationt::assumption(
   SSA_step.type=goto_trace_stept::typet::ASSUME;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// record an assertion
@@ -326,7 +328,7 @@ void symex_target_equationt::assertion(
   SSA_step.source=source;
   SSA_step.comment=msg;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// record a goto instruction
@@ -343,7 +345,7 @@ void symex_target_equationt::goto_instruction(
   SSA_step.type=goto_trace_stept::typet::GOTO;
   SSA_step.source=source;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 /// record a constraint
@@ -362,12 +364,28 @@ void symex_target_equationt::constraint(
   SSA_step.source=source;
   SSA_step.comment=msg;
 
-  merge_ireps(SSA_step);
+  step_recorded(SSA_step);
 }
 
 void symex_target_equationt::convert(
   prop_convt &prop_conv)
 {
+  if(streaming_prop_conv!=nullptr)
+  {
+    PRECONDITION(&prop_conv==streaming_prop_conv);
+
+    // all steps have been converted already, only the assertions remain
+    // to be combined
+    or_exprt::operandst disjuncts;
+    disjuncts.reserve(streamed_assertions.size());
+    for(const auto &l : streamed_assertions)
+      disjuncts.push_back(literal_exprt(!l));
+
+    // the below is 'true' if there are no assertions
+    prop_conv.set_to_true(disjunction(disjuncts));
+    return;
+  }
+
   convert_guards(prop_conv);
   convert_assignments(prop_conv);
   convert_decls(prop_conv);
@@ -573,6 +591,128 @@ void symex_target_equationt::convert_io(
 }
 
 
+void symex_target_equationt::stream_to(
+  prop_convt &prop_conv,
+  const namespacet &ns)
+{
+  PRECONDITION(SSA_steps.empty());
+  streaming_prop_conv=&prop_conv;
+  streaming_ns=&ns;
+  streamed_assumption=const_literal(true);
+  streamed_io_count=0;
+}
+
+void symex_target_equationt::step_recorded(SSA_stept &SSA_step)
+{
+  if(streaming_prop_conv==nullptr)
+    merge_ireps(SSA_step);
+  else
+    stream(SSA_step);
+}
+
+/// Whether \p expr refers to a dynamically allocated object, which marks
+/// an assignment as internal in a trace
+static bool has_dynamic_object(const exprt &expr, const namespacet &ns)
+{
+  if(expr.id()==ID_symbol)
+  {
+    const symbolt *symbol;
+    return
+      expr.get_bool(ID_C_SSA_symbol) &&
+      !ns.lookup(to_ssa_expr(expr).get_original_name(), symbol) &&
+      symbol->type.get_bool("#dynamic");
+  }
+
+  forall_operands(it, expr)
+    if(has_dynamic_object(*it, ns))
+      return true;
+
+  return false;
+}
+
+/// Convert the step that has just been recorded, in the same way convert()
+/// does for all steps, and then reduce it to what build_goto_trace needs, or
+/// drop it altogether
+void symex_target_equationt::stream(SSA_stept &SSA_step)
+{
+  prop_convt &prop_conv=*streaming_prop_conv;
+
+  if(SSA_step.source.thread_nr!=0 || SSA_step.is_spawn())
+    throw "formula streaming does not support multi-threaded programs";
+
+  SSA_step.guard_literal=prop_conv.convert(SSA_step.guard);
+
+  if(SSA_step.is_assignment())
+    prop_conv.set_to_true(SSA_step.cond_expr);
+  else if(SSA_step.is_decl())
+    prop_conv.convert(SSA_step.cond_expr);
+  else if(SSA_step.is_assume())
+  {
+    SSA_step.cond_literal=prop_conv.convert(SSA_step.cond_expr);
+    streamed_assumption=
+      prop_conv.convert(
+        and_exprt(
+          literal_exprt(streamed_assumption),
+          literal_exprt(SSA_step.cond_literal)));
+  }
+  else if(SSA_step.is_assert())
+  {
+    SSA_step.cond_literal=
+      prop_conv.convert(
+        implies_exprt(
+          literal_exprt(streamed_assumption),
+          SSA_step.cond_expr));
+    streamed_assertions.push_back(SSA_step.cond_literal);
+  }
+  else if(SSA_step.is_goto())
+    SSA_step.cond_literal=prop_conv.convert(SSA_step.cond_expr);
+  else if(SSA_step.is_constraint())
+    prop_conv.set_to_true(SSA_step.cond_expr);
+
+  for(const auto &arg : SSA_step.io_args)
+  {
+    if(arg.is_constant() ||
+       arg.id()==ID_string_constant)
+      SSA_step.converted_io_args.push_back(arg);
+    else
+    {
+      symbol_exprt symbol;
+      symbol.type()=arg.type();
+      symbol.set_identifier(
+        "symex::io::"+std::to_string(streamed_io_count++));
+
+      prop_conv.set_to_true(equal_exprt(arg, symbol));
+      SSA_step.converted_io_args.push_back(symbol);
+    }
+  }
+
+  // Constraints, and PHI and GUARD assignments, never show up in a trace;
+  // neither does anything that is unreachable.
+  if(SSA_step.is_constraint() ||
+     (SSA_step.guard_literal.is_false() && !SSA_step.is_assert()) ||
+     (SSA_step.is_assignment() &&
+      (SSA_step.assignment_type==assignment_typet::PHI ||
+       SSA_step.assignment_type==assignment_typet::GUARD)))
+  {
+    SSA_steps.pop_back();
+    return;
+  }
+
+  // keep a placeholder for guards that aren't constant, as coverage
+  // reporting distinguishes these
+  if(!SSA_step.guard.is_constant())
+    SSA_step.guard=literal_exprt(SSA_step.guard_literal);
+
+  if(SSA_step.is_assignment())
+  {
+    SSA_step.cond_expr.make_nil();
+    if(!has_dynamic_object(SSA_step.ssa_rhs, *streaming_ns))
+      SSA_step.ssa_rhs.make_nil();
+  }
+
+  SSA_step.io_args.clear();
+}
+
 void symex_target_equationt::merge_ireps(SSA_stept &SSA_step)
 {
   merge_irep(SSA_step.guard);
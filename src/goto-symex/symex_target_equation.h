@@ -156,6 +156,20 @@ public:
     unsigned atomic_section_id,
     const sourcet &source);
 
+  /// Convert each step to \p prop_conv as soon as it is recorded rather
+  /// than in convert(), and keep only what is needed to build a trace.
+  /// Convert() then merely adds the final constraint on the assertions.
+  /// The equation must still be empty. As the steps are compacted, neither
+  /// slicing nor output of the formula are possible.
+  /// \param prop_conv: the solver, which must outlive the equation
+  /// \param ns: namespace, used to find dynamically allocated objects
+  void stream_to(prop_convt &prop_conv, const namespacet &ns);
+
+  bool is_streaming() const
+  {
+    return streaming_prop_conv!=nullptr;
+  }
+
   void convert(prop_convt &prop_conv);
   void convert_assignments(decision_proceduret &decision_procedure) const;
   void convert_decls(prop_convt &prop_conv) const;
@@ -320,6 +334,18 @@ protected:
   // for enforcing sharing in the expressions stored
   merge_irept merge_irep;
   void merge_ireps(SSA_stept &SSA_step);
+
+  // for streaming the formula into a solver
+  prop_convt *streaming_prop_conv=nullptr;
+  const namespacet *streaming_ns=nullptr;
+  // conjunction of the assumptions recorded so far
+  literalt streamed_assumption;
+  bvt streamed_assertions;
+  std::size_t streamed_io_count=0;
+
+  /// Called once \p SSA_step, the last step, has been filled in
+  void step_recorded(SSA_stept &SSA_step);
+  void stream(SSA_stept &SSA_step);
 };
 
 inline bool operator<(
@@ -0,0 +1,966 @@
+/*******************************************************************\
+
+Module: Word-level Preprocessing of the SSA Equation
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Word-level Preprocessing of the SSA Equation
+
+#include "word_level_preprocessing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+
+#include <util/arith_tools.h>
+#include <util/simplify_expr.h>
+#include <util/std_expr.h>
+#include <util/std_types.h>
+#include <util/threeval.h>
+
+static bool is_integer_bv(const typet &type)
+{
+  return type.id()==ID_unsignedbv || type.id()==ID_signedbv;
+}
+
+static std::size_t width(const typet &type)
+{
+  return to_bitvector_type(type).get_width();
+}
+
+/// The bits of a two's complement representation of \p width bits
+static uint64_t mask(std::size_t width)
+{
+  return width>=64?~uint64_t(0):(uint64_t(1)<<width)-1;
+}
+
+static bool is_relation(const exprt &expr)
+{
+  return
+    (expr.id()==ID_lt || expr.id()==ID_le ||
+     expr.id()==ID_gt || expr.id()==ID_ge ||
+     expr.id()==ID_equal || expr.id()==ID_notequal) &&
+    expr.operands().size()==2 &&
+    is_integer_bv(expr.op0().type()) &&
+    expr.op0().type()==expr.op1().type();
+}
+
+/// The relation that holds if and only if \p id does not
+static irep_idt negate_relation(const irep_idt &id)
+{
+  if(id==ID_lt)
+    return ID_ge;
+  else if(id==ID_le)
+    return ID_gt;
+  else if(id==ID_gt)
+    return ID_le;
+  else if(id==ID_ge)
+    return ID_lt;
+  else if(id==ID_equal)
+    return ID_notequal;
+  else
+    return ID_equal;
+}
+
+/// The relation that holds for swapped operands if \p id does
+static irep_idt swap_relation(const irep_idt &id)
+{
+  if(id==ID_lt)
+    return ID_gt;
+  else if(id==ID_le)
+    return ID_ge;
+  else if(id==ID_gt)
+    return ID_lt;
+  else if(id==ID_ge)
+    return ID_le;
+  else
+    return id;
+}
+
+class word_level_preprocessort
+{
+public:
+  explicit word_level_preprocessort(const namespacet &_ns):ns(_ns)
+  {
+  }
+
+  void operator()(symex_target_equationt &equation);
+
+  word_level_preprocessing_statisticst statistics;
+
+protected:
+  const namespacet &ns;
+
+  /// What is known about the value of an expression of integer bit-vector
+  /// type: its range, and the bits of its two's complement representation
+  /// that are known, which are only tracked for up to 64 bits
+  struct valuet
+  {
+    mp_integer lower, upper;
+    uint64_t known, bits;
+  };
+
+  // learnt from assignments, assumptions and constraints
+  std::unordered_map<irep_idt, valuet, irep_id_hash> values;
+  std::unordered_map<irep_idt, exprt, irep_id_hash> substitutions;
+
+  /// A cached value or rewriting, together with the symbols whose values
+  /// or substitutions it has been computed from
+  template<typename T>
+  struct cachedt
+  {
+    T result;
+    std::vector<irep_idt> dependencies;
+  };
+
+  std::unordered_map<exprt, cachedt<valuet>, irep_hash> value_cache;
+  std::unordered_map<exprt, cachedt<exprt>, irep_hash> rewrite_cache;
+
+  // the expressions in the caches that depend on each symbol, which are
+  // dropped when something new is learnt about the symbol
+  std::unordered_map<irep_idt, std::vector<exprt>, irep_id_hash> dependents;
+
+  // collects the dependencies of the value or rewriting being computed
+  std::vector<irep_idt> *dependencies=nullptr;
+
+  void depends_on(const irep_idt &identifier)
+  {
+    if(dependencies!=nullptr)
+      dependencies->push_back(identifier);
+  }
+
+  void depends_on(const std::vector<irep_idt> &identifiers)
+  {
+    if(dependencies!=nullptr)
+      dependencies->insert(
+        dependencies->end(), identifiers.begin(), identifiers.end());
+  }
+
+  template<typename T>
+  T cached(
+    std::unordered_map<exprt, cachedt<T>, irep_hash> &cache,
+    const exprt &expr,
+    std::function<T()> compute);
+
+  void forget(const irep_idt &identifier);
+
+  static valuet top(const typet &type);
+  static valuet singleton(const mp_integer &value, const typet &type);
+  static void normalize(valuet &value, const typet &type);
+  static bool fits(
+    const mp_integer &lower,
+    const mp_integer &upper,
+    const typet &type);
+  static std::size_t required_width(
+    const mp_integer &lower,
+    const mp_integer &upper,
+    bool is_signed);
+
+  valuet value_of(const exprt &expr);
+  valuet compute_value(const exprt &expr);
+  tvt decide(const exprt &relation);
+
+  exprt rewrite(const exprt &expr);
+  exprt rewrite_rec(const exprt &expr);
+  void narrow(exprt &expr);
+  exprt narrow_operand(const exprt &operand, const typet &type) const;
+
+  void learn(const exprt &condition);
+  void refine(
+    const symbol_exprt &symbol,
+    const irep_idt &relation,
+    const mp_integer &constant);
+};
+
+word_level_preprocessort::valuet word_level_preprocessort::top(
+  const typet &type)
+{
+  const std::size_t w=width(type);
+  valuet value;
+
+  if(type.id()==ID_signedbv)
+  {
+    value.lower=-power(2, w-1);
+    value.upper=power(2, w-1)-1;
+  }
+  else
+  {
+    value.lower=0;
+    value.upper=power(2, w)-1;
+  }
+
+  value.known=0;
+  value.bits=0;
+
+  return value;
+}
+
+word_level_preprocessort::valuet word_level_preprocessort::singleton(
+  const mp_integer &v,
+  const typet &type)
+{
+  valuet value=top(type);
+  value.lower=v;
+  value.upper=v;
+  normalize(value, type);
+  return value;
+}
+
+bool word_level_preprocessort::fits(
+  const mp_integer &lower,
+  const mp_integer &upper,
+  const typet &type)
+{
+  const valuet range=top(type);
+  return lower>=range.lower && upper<=range.upper;
+}
+
+std::size_t word_level_preprocessort::required_width(
+  const mp_integer &lower,
+  const mp_integer &upper,
+  bool is_signed)
+{
+  std::size_t result=1;
+  mp_integer bound=is_signed?1:2;
+
+  while(upper>=bound || (is_signed && lower<-bound))
+  {
+    result++;
+    bound*=2;
+  }
+
+  return result;
+}
+
+/// Make the range and the known bits of \p value agree with each other,
+/// unless they contradict each other
+void word_level_preprocessort::normalize(valuet &value, const typet &type)
+{
+  const std::size_t w=width(type);
+
+  if(w>64)
+    return;
+
+  const uint64_t m=mask(w);
+  const mp_integer modulus=power(2, w);
+
+  // the leading bits of all values in a range that does not include both
+  // negative and non-negative values are those the bounds agree on
+  if(value.lower>=0 || value.upper<0)
+  {
+    const uint64_t lower=
+      integer2ulong(value.lower<0?value.lower+modulus:value.lower);
+    const uint64_t upper=
+      integer2ulong(value.upper<0?value.upper+modulus:value.upper);
+
+    uint64_t prefix=m;
+    for(uint64_t diff=lower^upper; diff!=0; diff>>=1)
+      prefix<<=1;
+    prefix&=m;
+
+    if((value.known&prefix&(value.bits^lower))==0)
+    {
+      value.known|=prefix;
+      value.bits|=lower&prefix;
+    }
+  }
+
+  mp_integer lower=
+    mp_integer(static_cast<mp_integer::ullong_t>(value.bits));
+  mp_integer upper=
+    mp_integer(static_cast<mp_integer::ullong_t>(value.bits|(~value.known&m)));
+
+  if(type.id()==ID_signedbv)
+  {
+    const uint64_t sign=uint64_t(1)<<(w-1);
+
+    if((value.known&sign)==0)
+      return;
+
+    if((value.bits&sign)!=0)
+    {
+      lower-=modulus;
+      upper-=modulus;
+    }
+  }
+
+  mp_max(lower, value.lower);
+  mp_min(upper, value.upper);
+
+  if(lower<=upper)
+  {
+    value.lower=lower;
+    value.upper=upper;
+  }
+}
+
+word_level_preprocessort::valuet word_level_preprocessort::value_of(
+  const exprt &expr)
+{
+  PRECONDITION(is_integer_bv(expr.type()));
+
+  return cached<valuet>(value_cache, expr, [this, &expr]()
+  {
+    valuet value=compute_value(expr);
+    normalize(value, expr.type());
+    return value;
+  });
+}
+
+/// Look up \p expr in \p cache, or compute and cache its result while
+/// recording the symbols that the computation depends on. Either way, these
+/// are added to the dependencies of the computation in progress.
+template<typename T>
+T word_level_preprocessort::cached(
+  std::unordered_map<exprt, cachedt<T>, irep_hash> &cache,
+  const exprt &expr,
+  std::function<T()> compute)
+{
+  auto entry=cache.find(expr);
+
+  if(entry==cache.end())
+  {
+    std::vector<irep_idt> *outer=dependencies;
+    std::vector<irep_idt> expr_dependencies;
+    dependencies=&expr_dependencies;
+    T result=compute();
+    dependencies=outer;
+
+    std::sort(expr_dependencies.begin(), expr_dependencies.end());
+    expr_dependencies.erase(
+      std::unique(expr_dependencies.begin(), expr_dependencies.end()),
+      expr_dependencies.end());
+
+    for(const auto &identifier : expr_dependencies)
+      dependents[identifier].push_back(expr);
+
+    entry=cache.emplace(
+      expr, cachedt<T>{ result, std::move(expr_dependencies) }).first;
+  }
+
+  depends_on(entry->second.dependencies);
+  return entry->second.result;
+}
+
+/// Drop the cached values and rewritings that depend on the value or the
+/// substitution of \p identifier
+void word_level_preprocessort::forget(const irep_idt &identifier)
+{
+  auto entry=dependents.find(identifier);
+  if(entry==dependents.end())
+    return;
+
+  for(const auto &expr : entry->second)
+  {
+    value_cache.erase(expr);
+    rewrite_cache.erase(expr);
+  }
+
+  dependents.erase(entry);
+}
+
+word_level_preprocessort::valuet word_level_preprocessort::compute_value(
+  const exprt &expr)
+{
+  const typet &type=expr.type();
+  const std::size_t w=width(type);
+  valuet result=top(type);
+
+  for(const auto &op : expr.operands())
+    if(op.type()!=type &&
+       expr.id()!=ID_typecast && expr.id()!=ID_if &&
+       expr.id()!=ID_shl && expr.id()!=ID_lshr && expr.id()!=ID_ashr)
+    {
+      return result;
+    }
+
+  if(expr.is_constant())
+  {
+    mp_integer v;
+    if(!to_integer(expr, v))
+      return singleton(v, type);
+  }
+  else if(expr.id()==ID_symbol)
+  {
+    const irep_idt &identifier=to_symbol_expr(expr).get_identifier();
+    depends_on(identifier);
+
+    auto entry=values.find(identifier);
+    if(entry!=values.end())
+      return entry->second;
+  }
+  else if(expr.id()==ID_typecast)
+  {
+    const exprt &op=to_typecast_expr(expr).op();
+
+    if(op.type().id()==ID_bool)
+    {
+      result.lower=0;
+      result.upper=1;
+    }
+    else if(is_integer_bv(op.type()))
+    {
+      const valuet v=value_of(op);
+
+      if(fits(v.lower, v.upper, type))
+      {
+        result.lower=v.lower;
+        result.upper=v.upper;
+      }
+
+      // extending and truncating both keep the least significant bits
+      if(w<=64 && width(op.type())<=64)
+      {
+        const uint64_t low=mask(std::min(w, width(op.type())));
+        result.known=v.known&low;
+        result.bits=v.bits&low;
+      }
+    }
+  }
+  else if(expr.id()==ID_plus || expr.id()==ID_mult)
+  {
+    const bool plus=expr.id()==ID_plus;
+    mp_integer lower=plus?0:1, upper=lower;
+
+    for(const auto &op : expr.operands())
+    {
+      const valuet v=value_of(op);
+
+      if(plus)
+      {
+        lower+=v.lower;
+        upper+=v.upper;
+      }
+      else
+      {
+        const mp_integer products[]=
+          { lower*v.lower, lower*v.upper, upper*v.lower, upper*v.upper };
+        lower=*std::min_element(std::begin(products), std::end(products));
+        upper=*std::max_element(std::begin(products), std::end(products));
+      }
+    }
+
+    // the result is exact unless it wraps around
+    if(fits(lower, upper, type))
+    {
+      result.lower=lower;
+      result.upper=upper;
+    }
+  }
+  else if(expr.id()==ID_minus && expr.operands().size()==2)
+  {
+    const valuet a=value_of(expr.op0()), b=value_of(expr.op1());
+    const mp_integer lower=a.lower-b.upper, upper=a.upper-b.lower;
+
+    if(fits(lower, upper, type))
+    {
+      result.lower=lower;
+      result.upper=upper;
+    }
+  }
+  else if(expr.id()==ID_unary_minus)
+  {
+    const valuet a=value_of(expr.op0());
+
+    if(fits(-a.upper, -a.lower, type))
+    {
+      result.lower=-a.upper;
+      result.upper=-a.lower;
+    }
+  }
+  else if(expr.id()==ID_div && expr.operands().size()==2)
+  {
+    const valuet a=value_of(expr.op0()), b=value_of(expr.op1());
+
+    // with a divisor of constant sign, the quotient is monotonic in both
+    // operands
+    if(b.lower>0 || b.upper<0)
+    {
+      const mp_integer quotients[]=
+        { a.lower/b.lower, a.lower/b.upper, a.upper/b.lower, a.upper/b.upper };
+      const mp_integer lower=
+        *std::min_element(std::begin(quotients), std::end(quotients));
+      const mp_integer upper=
+        *std::max_element(std::begin(quotients), std::end(quotients));
+
+      if(fits(lower, upper, type))
+      {
+        result.lower=lower;
+        result.upper=upper;
+      }
+    }
+  }
+  else if(expr.id()==ID_mod && expr.operands().size()==2)
+  {
+    const valuet a=value_of(expr.op0()), b=value_of(expr.op1());
+
+    // the remainder has the sign of the dividend, and is smaller than the
+    // divisor in magnitude
+    if(b.lower>0 || b.upper<0)
+    {
+      mp_integer m=b.upper>0?b.upper:-b.lower;
+      m-=1;
+
+      result.lower=a.lower<0?-std::min(-a.lower, m):mp_integer(0);
+      result.upper=a.upper>0?std::min(a.upper, m):mp_integer(0);
+    }
+  }
+  else if(
+    (expr.id()==ID_bitand || expr.id()==ID_bitor || expr.id()==ID_bitxor) &&
+    w<=64)
+  {
+    bool all_non_negative=true;
+
+    for(auto it=expr.operands().begin(); it!=expr.operands().end(); it++)
+    {
+      const valuet v=value_of(*it);
+      all_non_negative&=v.lower>=0;
+
+      if(it==expr.operands().begin())
+      {
+        result.known=v.known;
+        result.bits=v.bits;
+        result.upper=v.upper;
+      }
+      else if(expr.id()==ID_bitand)
+      {
+        result.known=(result.known&v.known)|
+                     (result.known&~result.bits)|(v.known&~v.bits);
+        result.bits&=v.bits;
+        mp_min(result.upper, v.upper);
+      }
+      else if(expr.id()==ID_bitor)
+      {
+        result.known=(result.known&v.known)|result.bits|v.bits;
+        result.bits|=v.bits;
+      }
+      else
+      {
+        result.known&=v.known;
+        result.bits=(result.bits^v.bits)&result.known;
+      }
+    }
+
+    // the conjunction of non-negative values is at most any of them
+    if(expr.id()==ID_bitand && all_non_negative)
+      result.lower=0;
+    else
+      result.upper=top(type).upper;
+  }
+  else if(expr.id()==ID_bitnot && w<=64)
+  {
+    const valuet a=value_of(expr.op0());
+    result.known=a.known;
+    result.bits=~a.bits&a.known;
+  }
+  else if(
+    (expr.id()==ID_shl || expr.id()==ID_lshr || expr.id()==ID_ashr) &&
+    expr.op0().type()==type &&
+    expr.op1().is_constant())
+  {
+    mp_integer distance;
+    if(to_integer(expr.op1(), distance) || distance<0 || distance>=w)
+      return result;
+
+    const std::size_t k=integer2size_t(distance);
+    const mp_integer factor=power(2, k);
+    const valuet a=value_of(expr.op0());
+
+    if(expr.id()==ID_shl)
+    {
+      if(fits(a.lower*factor, a.upper*factor, type))
+      {
+        result.lower=a.lower*factor;
+        result.upper=a.upper*factor;
+      }
+
+      if(w<=64)
+      {
+        result.known=((a.known<<k)|mask(k))&mask(w);
+        result.bits=(a.bits<<k)&mask(w);
+      }
+    }
+    else if(a.lower>=0)
+    {
+      // for non-negative values, both shifts divide
+      result.lower=a.lower/factor;
+      result.upper=a.upper/factor;
+    }
+    else if(expr.id()==ID_lshr && w<=64)
+    {
+      result.known=(a.known>>k)|(mask(w)&~mask(w-k));
+      result.bits=a.bits>>k;
+    }
+  }
+  else if(expr.id()==ID_if)
+  {
+    const if_exprt &if_expr=to_if_expr(expr);
+    if(if_expr.true_case().type()!=type || if_expr.false_case().type()!=type)
+      return result;
+
+    const valuet a=value_of(if_expr.true_case());
+    const valuet b=value_of(if_expr.false_case());
+    result.lower=std::min(a.lower, b.lower);
+    result.upper=std::max(a.upper, b.upper);
+    result.known=a.known&b.known&~(a.bits^b.bits);
+    result.bits=a.bits&result.known;
+  }
+
+  return result;
+}
+
+/// Decide a relation from the values of its operands
+tvt word_level_preprocessort::decide(const exprt &relation)
+{
+  const valuet a=value_of(relation.op0());
+  const valuet b=value_of(relation.op1());
+  const irep_idt &id=relation.id();
+
+  if(id==ID_lt || id==ID_gt)
+  {
+    const valuet x=id==ID_lt?a:b, &y=id==ID_lt?b:a;
+    if(x.upper<y.lower)
+      return tvt(true);
+    if(x.lower>=y.upper)
+      return tvt(false);
+  }
+  else if(id==ID_le || id==ID_ge)
+  {
+    const valuet x=id==ID_le?a:b, &y=id==ID_le?b:a;
+    if(x.upper<=y.lower)
+      return tvt(true);
+    if(x.lower>y.upper)
+      return tvt(false);
+  }
+  else
+  {
+    const bool equal=id==ID_equal;
+
+    if(a.lower==a.upper && b.lower==b.upper && a.lower==b.lower)
+      return tvt(equal);
+
+    if(a.upper<b.lower || b.upper<a.lower ||
+       (a.known&b.known&(a.bits^b.bits))!=0)
+    {
+      return tvt(!equal);
+    }
+  }
+
+  return tvt::unknown();
+}
+
+/// Do arithmetic, or compare, at the smallest width that all operands and
+/// the result fit in. Neither overflows, so the result is the same.
+void word_level_preprocessort::narrow(exprt &expr)
+{
+  const bool relation=is_relation(expr);
+
+  if(!relation &&
+     expr.id()!=ID_plus && expr.id()!=ID_minus && expr.id()!=ID_mult &&
+     expr.id()!=ID_div && expr.id()!=ID_mod)
+  {
+    return;
+  }
+
+  const typet type=relation?expr.op0().type():expr.type();
+  if(!is_integer_bv(type) || expr.operands().size()<2)
+    return;
+
+  const bool is_signed=type.id()==ID_signedbv;
+  mp_integer lower=0, upper=0;
+
+  if(!relation)
+  {
+    const valuet v=value_of(expr);
+    lower=v.lower;
+    upper=v.upper;
+  }
+
+  for(const auto &op : expr.operands())
+  {
+    if(op.type()!=type)
+      return;
+
+    const valuet v=value_of(op);
+    mp_min(lower, v.lower);
+    mp_max(upper, v.upper);
+  }
+
+  const std::size_t from_width=width(type);
+  const std::size_t to_width=required_width(lower, upper, is_signed);
+
+  if(to_width>=from_width || (!is_signed && lower<0))
+    return;
+
+  const typet narrow_type=
+    is_signed?typet(signedbv_typet(to_width)):
+              typet(unsignedbv_typet(to_width));
+
+  exprt narrowed=expr;
+  for(auto &op : narrowed.operands())
+    op=narrow_operand(op, narrow_type);
+
+  statistics.narrowings.push_back(
+    { expr.id(), is_signed, from_width, to_width });
+
+  if(relation)
+    expr=narrowed;
+  else
+  {
+    narrowed.type()=narrow_type;
+    expr=typecast_exprt(narrowed, type);
+  }
+}
+
+/// Convert an operand whose value fits in \p type to that
+exprt word_level_preprocessort::narrow_operand(
+  const exprt &operand,
+  const typet &type) const
+{
+  mp_integer value;
+  if(operand.is_constant() && !to_integer(operand, value))
+    return from_integer(value, type);
+
+  // casting the operand of a cast directly yields the same value, whether
+  // either of the casts extends or truncates
+  if(operand.id()==ID_typecast)
+  {
+    const exprt &op=to_typecast_expr(operand).op();
+    if(op.type()==type)
+      return op;
+    else if(is_integer_bv(op.type()) || op.type().id()==ID_bool)
+      return typecast_exprt(op, type);
+  }
+
+  return typecast_exprt(operand, type);
+}
+
+exprt word_level_preprocessort::rewrite(const exprt &expr)
+{
+  return cached<exprt>(
+    rewrite_cache, expr, [this, &expr]() { return rewrite_rec(expr); });
+}
+
+exprt word_level_preprocessort::rewrite_rec(const exprt &expr)
+{
+  if(expr.id()==ID_symbol)
+  {
+    const irep_idt &identifier=to_symbol_expr(expr).get_identifier();
+    depends_on(identifier);
+
+    auto entry=substitutions.find(identifier);
+    if(entry==substitutions.end())
+      return expr;
+
+    statistics.substitutions++;
+    return rewrite(entry->second);
+  }
+
+  if(!expr.has_operands())
+    return expr;
+
+  exprt result=expr;
+  bool changed=false;
+
+  Forall_operands(it, result)
+  {
+    exprt op=rewrite(*it);
+    if(op!=*it)
+    {
+      *it=op;
+      changed=true;
+    }
+  }
+
+  if(changed)
+    simplify(result, ns);
+
+  if(result.is_constant())
+    return result;
+
+  if(is_relation(result))
+  {
+    const tvt value=decide(result);
+
+    if(value.is_known())
+    {
+      statistics.decided++;
+      return value.is_true()?exprt(true_exprt()):exprt(false_exprt());
+    }
+  }
+  else if(is_integer_bv(result.type()))
+  {
+    const valuet value=value_of(result);
+
+    if(value.lower==value.upper)
+    {
+      statistics.constants++;
+      return from_integer(value.lower, result.type());
+    }
+  }
+
+  narrow(result);
+
+  return result;
+}
+
+/// Learn from a condition that holds in all steps that follow
+void word_level_preprocessort::learn(const exprt &condition)
+{
+  if(condition.id()==ID_and)
+  {
+    for(const auto &op : condition.operands())
+      learn(op);
+  }
+  else if(condition.id()==ID_symbol)
+  {
+    const irep_idt &identifier=to_symbol_expr(condition).get_identifier();
+    substitutions[identifier]=true_exprt();
+    forget(identifier);
+  }
+  else if(condition.id()==ID_not)
+  {
+    const exprt &op=to_not_expr(condition).op();
+
+    if(op.id()==ID_symbol)
+    {
+      const irep_idt &identifier=to_symbol_expr(op).get_identifier();
+      substitutions[identifier]=false_exprt();
+      forget(identifier);
+    }
+    else if(is_relation(op))
+    {
+      learn(
+        binary_relation_exprt(
+          op.op0(), negate_relation(op.id()), op.op1()));
+    }
+  }
+  else if(is_relation(condition))
+  {
+    const exprt &lhs=condition.op0(), &rhs=condition.op1();
+    mp_integer constant;
+
+    if(lhs.id()==ID_symbol && !to_integer(rhs, constant))
+      refine(to_symbol_expr(lhs), condition.id(), constant);
+    else if(rhs.id()==ID_symbol && !to_integer(lhs, constant))
+      refine(to_symbol_expr(rhs), swap_relation(condition.id()), constant);
+    else if(
+      condition.id()==ID_equal &&
+      lhs.id()==ID_symbol && rhs.id()==ID_symbol)
+    {
+      const irep_idt &identifier=to_symbol_expr(lhs).get_identifier();
+      substitutions[identifier]=rhs;
+      forget(identifier);
+    }
+  }
+}
+
+void word_level_preprocessort::refine(
+  const symbol_exprt &symbol,
+  const irep_idt &relation,
+  const mp_integer &constant)
+{
+  const irep_idt &identifier=symbol.get_identifier();
+  auto entry=values.find(identifier);
+  valuet value=entry==values.end()?top(symbol.type()):entry->second;
+
+  if(relation==ID_equal)
+  {
+    mp_max(value.lower, constant);
+    mp_min(value.upper, constant);
+  }
+  else if(relation==ID_notequal)
+  {
+    if(value.lower==constant)
+      value.lower+=1;
+    else if(value.upper==constant)
+      value.upper-=1;
+  }
+  else if(relation==ID_lt)
+    mp_min(value.upper, constant-1);
+  else if(relation==ID_le)
+    mp_min(value.upper, constant);
+  else if(relation==ID_gt)
+    mp_max(value.lower, constant+1);
+  else if(relation==ID_ge)
+    mp_max(value.lower, constant);
+
+  // contradictory, which is left to the solver
+  if(value.lower>value.upper)
+    return;
+
+  normalize(value, symbol.type());
+  values[identifier]=value;
+
+  if(value.lower==value.upper)
+    substitutions[identifier]=from_integer(value.lower, symbol.type());
+
+  forget(identifier);
+}
+
+void word_level_preprocessort::operator()(symex_target_equationt &equation)
+{
+  // An assumption only holds for the assertions that follow it, whereas
+  // constraints hold regardless of where they are. What is learnt from an
+  // assumption is used to rewrite the steps that follow it, which are not
+  // relevant to earlier assertions, unless a constraint could refer to them.
+  bool learn_from_assumptions=true;
+
+  for(const auto &step : equation.SSA_steps)
+    if(step.is_constraint() && !step.ignore)
+      learn_from_assumptions=false;
+
+  for(auto &step : equation.SSA_steps)
+  {
+    if(step.ignore)
+      continue;
+
+    step.guard=rewrite(step.guard);
+
+    if(step.is_assignment())
+    {
+      const exprt rhs=rewrite(step.ssa_rhs);
+
+      if(rhs!=step.ssa_rhs)
+      {
+        step.ssa_rhs=rhs;
+        step.cond_expr=equal_exprt(step.ssa_lhs, step.ssa_rhs);
+      }
+
+      const irep_idt &identifier=step.ssa_lhs.get_identifier();
+
+      if(rhs.type()!=step.ssa_lhs.type())
+        continue;
+
+      if(rhs.is_constant() || rhs.id()==ID_symbol)
+        substitutions[identifier]=rhs;
+      else if(is_integer_bv(rhs.type()))
+        values[identifier]=value_of(rhs);
+
+      forget(identifier);
+    }
+    else if(
+      step.is_assume() || step.is_assert() || step.is_goto() ||
+      step.is_constraint())
+    {
+      step.cond_expr=rewrite(step.cond_expr);
+
+      if(step.is_constraint() || (step.is_assume() && learn_from_assumptions))
+        learn(step.cond_expr);
+    }
+  }
+}
+
+word_level_preprocessing_statisticst word_level_preprocessing(
+  symex_target_equationt &equation,
+  const namespacet &ns)
+{
+  word_level_preprocessort word_level_preprocessor(ns);
+  word_level_preprocessor(equation);
+  return word_level_preprocessor.statistics;
+}
@@ -0,0 +1,49 @@
+/*******************************************************************\
+
+Module: Word-level Preprocessing of the SSA Equation
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Word-level Preprocessing of the SSA Equation
+
+#ifndef CPROVER_GOTO_SYMEX_WORD_LEVEL_PREPROCESSING_H
+#define CPROVER_GOTO_SYMEX_WORD_LEVEL_PREPROCESSING_H
+
+#include <vector>
+
+#include "symex_target_equation.h"
+
+/// An arithmetic operation or comparison that is done at a smaller width
+struct word_level_narrowingt
+{
+  irep_idt id;
+  bool is_signed;
+  std::size_t from_width, to_width;
+};
+
+struct word_level_preprocessing_statisticst
+{
+  // occurrences of symbols replaced by expressions equal to them
+  std::size_t substitutions=0;
+  // expressions replaced by the only value they can take
+  std::size_t constants=0;
+  // comparisons decided by the ranges of their operands
+  std::size_t decided=0;
+  std::vector<word_level_narrowingt> narrowings;
+};
+
+/// Rewrites the equation, which must not have been converted yet, using what
+/// is known about the values of its integer bit-vector expressions. Ranges
+/// and known bits of these are propagated through the assignments and
+/// learnt from assumptions and constraints. This is used to decide
+/// comparisons, to substitute symbols and expressions that have a single
+/// value, and to do arithmetic at the smallest width that yields the same
+/// result.
+word_level_preprocessing_statisticst word_level_preprocessing(
+  symex_target_equationt &equation,
+  const namespacet &ns);
+
+#endif // CPROVER_GOTO_SYMEX_WORD_LEVEL_PREPROCESSING_H
@@ -15,6 +15,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #define USE_DEPRECATED_STATIC_ANALYSIS_H
 #include <analyses/static_analysis.h>
 
+#include "value_set_cache.h"
 #include "value_set_domain.h"
 #include "value_sets.h"
 
@@ -40,6 +41,49 @@ public:
   {
   }
 
+  using baset::operator();
+
+  /// Analyse \p goto_functions, taking the value sets of the functions that
+  /// \p cache is up to date for from there. These functions are only
+  /// analysed again if their callers pass them new values.
+  void operator()(
+    const goto_functionst &goto_functions,
+    const value_set_cachet &cache)
+  {
+    baset::initialize(goto_functions);
+
+    for(const auto &function :
+          cache.reusable_functions(goto_functions, baset::ns))
+    {
+      const goto_programt &body=goto_functions.function_map.at(function).body;
+      const std::vector<value_sett> value_sets=
+        cache.value_sets(function, goto_functions);
+      auto value_set=value_sets.begin();
+
+      forall_goto_program_instructions(i_it, body)
+        baset::state_map[i_it].value_set=*(value_set++);
+
+      baset::functions_done.insert(function);
+    }
+
+    baset::fixedpoint(goto_functions);
+  }
+
+  /// Store the value sets of the instructions of \p goto_functions, which
+  /// must have been analysed, in \p cache
+  void store(
+    const goto_functionst &goto_functions,
+    value_set_cachet &cache) const
+  {
+    cache.store(
+      goto_functions,
+      baset::ns,
+      [this](locationt l) -> const value_sett &
+      {
+        return (*this)[l].value_set;
+      });
+  }
+
   void convert(
     const goto_programt &goto_program,
     const irep_idt &identifier,
@@ -0,0 +1,516 @@
+/*******************************************************************\
+
+Module: Value Set Cache
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Value Set Cache
+
+#include "value_set_cache.h"
+
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <util/irep_hash.h>
+#include <util/irep_serialization.h>
+#include <util/namespace.h>
+#include <util/prefix.h>
+#include <util/std_code.h>
+#include <util/std_expr.h>
+#include <util/string2int.h>
+#include <util/string_hash.h>
+#include <util/symbol_table.h>
+
+/// A hash of \p irep that, unlike irept::hash, does not depend on the
+/// numbering of strings, and hence is the same in any run of any tool
+static std::size_t stable_hash(const irept &irep)
+{
+  std::size_t result=hash_string(id2string(irep.id()));
+
+  forall_irep(it, irep.get_sub())
+    result=hash_combine(result, stable_hash(*it));
+
+  forall_named_irep(it, irep.get_named_sub())
+  {
+    result=hash_combine(result, hash_string(id2string(it->first)));
+    result=hash_combine(result, stable_hash(it->second));
+  }
+
+  return hash_finalize(
+    result, irep.get_sub().size()+irep.get_named_sub().size());
+}
+
+/// The targets of jumps are hashed as their index in the body, as their
+/// location numbers change whenever a function before them does.
+std::size_t value_set_cachet::hash(const goto_programt &goto_program)
+{
+  std::unordered_map<const goto_programt::instructiont *, std::size_t>
+    indices;
+
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    const std::size_t index=indices.size();
+    indices[&*i_it]=index;
+  }
+
+  std::size_t result=goto_program.instructions.size();
+
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    result=hash_combine(result, static_cast<std::size_t>(i_it->type));
+    result=hash_combine(result, stable_hash(i_it->code));
+    result=hash_combine(result, stable_hash(i_it->guard));
+
+    for(const auto &target : i_it->targets)
+      result=hash_combine(result, indices.at(&*target));
+  }
+
+  return result;
+}
+
+typedef std::function<unsigned(unsigned)> renamet;
+
+static void rename_dynamic_objects(exprt &expr, const renamet &rename)
+{
+  if(expr.id()==ID_dynamic_object &&
+     to_dynamic_object_expr(expr).op0().id()==ID_constant)
+  {
+    dynamic_object_exprt &dynamic_object=to_dynamic_object_expr(expr);
+    dynamic_object.set_instance(rename(dynamic_object.get_instance()));
+  }
+
+  Forall_operands(it, expr)
+    rename_dynamic_objects(*it, rename);
+}
+
+/// A copy of \p value_set in which the instance numbers of the dynamic
+/// objects, which are part of their names, are replaced by \p rename
+static value_sett rename_dynamic_objects(
+  const value_sett &value_set,
+  const renamet &rename)
+{
+  const std::string prefix="value_set::dynamic_object";
+  value_sett result;
+  result.location_number=value_set.location_number;
+
+  for(const auto &value : value_set.values)
+  {
+    value_sett::entryt entry=value.second;
+    const std::string &identifier=id2string(entry.identifier);
+
+    if(has_prefix(identifier, prefix))
+    {
+      entry.identifier=
+        prefix+
+        std::to_string(
+          rename(safe_string2unsigned(identifier.substr(prefix.size()))));
+    }
+
+    value_sett::object_mapt object_map;
+
+    for(const auto &object : entry.object_map.read())
+    {
+      exprt object_expr=value_sett::object_numbering[object.first];
+      rename_dynamic_objects(object_expr, rename);
+      object_map.write()[value_sett::object_numbering.number(object_expr)]=
+        object.second;
+    }
+
+    entry.object_map=object_map;
+    result.values[id2string(entry.identifier)+entry.suffix]=entry;
+  }
+
+  return result;
+}
+
+/// The types of symbols are referred to by name in the code, and decide
+/// which members of structs are tracked separately.
+std::size_t value_set_cachet::hash_types(const namespacet &ns)
+{
+  std::size_t result=0;
+
+  // the order of the symbols need not be the same in every run
+  for(const auto &symbol_pair : ns.get_symbol_table().symbols)
+  {
+    const symbolt &symbol=symbol_pair.second;
+
+    if(symbol.is_type)
+      result+=hash_combine(
+        hash_string(id2string(symbol.name)), stable_hash(symbol.type));
+  }
+
+  return result;
+}
+
+void value_set_cachet::store(
+  const goto_functionst &goto_functions,
+  const namespacet &ns,
+  get_value_sett get_value_set)
+{
+  clear();
+
+  types_hash=hash_types(ns);
+
+  // the function and index in its body of each location number
+  std::unordered_map<unsigned, allocation_sitet> sites;
+
+  forall_goto_functions(f_it, goto_functions)
+  {
+    std::size_t index=0;
+    forall_goto_program_instructions(i_it, f_it->second.body)
+      sites[i_it->location_number]=allocation_sitet(f_it->first, index++);
+  }
+
+  std::map<allocation_sitet, std::size_t> site_numbers;
+
+  forall_goto_functions(f_it, goto_functions)
+  {
+    if(!f_it->second.body_available())
+      continue;
+
+    const goto_programt &body=f_it->second.body;
+    functiont &function=functions[f_it->first];
+    function.hash=hash(body);
+    function.value_sets.reserve(body.instructions.size());
+
+    bool unknown_site=false;
+
+    const renamet to_site=[&](unsigned location_number)
+    {
+      const auto s_it=sites.find(location_number);
+      if(s_it==sites.end())
+      {
+        unknown_site=true;
+        return location_number;
+      }
+
+      function.allocating_functions.insert(s_it->second.first);
+
+      const auto entry=site_numbers.insert(
+        std::make_pair(s_it->second, allocation_sites.size()));
+      if(entry.second)
+        allocation_sites.push_back(s_it->second);
+
+      return static_cast<unsigned>(entry.first->second);
+    };
+
+    forall_goto_program_instructions(i_it, body)
+    {
+      function.value_sets.push_back(
+        rename_dynamic_objects(get_value_set(i_it), to_site));
+      function.value_sets.back().location_number=
+        static_cast<unsigned>(function.value_sets.size()-1);
+    }
+
+    // a dynamic object that is not allocated by any instruction cannot be
+    // named in other runs
+    if(unknown_site)
+      functions.erase(f_it->first);
+  }
+}
+
+std::vector<value_sett> value_set_cachet::value_sets(
+  const irep_idt &function,
+  const goto_functionst &goto_functions) const
+{
+  // the location numbers of the allocation sites
+  std::map<std::size_t, unsigned> location_numbers;
+
+  const renamet to_location_number=[&](unsigned site)
+  {
+    const auto entry=location_numbers.insert(std::make_pair(site, 0u));
+
+    if(entry.second)
+    {
+      const allocation_sitet &allocation_site=allocation_sites.at(site);
+      const goto_programt &body=
+        goto_functions.function_map.at(allocation_site.first).body;
+      entry.first->second=
+        std::next(body.instructions.begin(), allocation_site.second)
+          ->location_number;
+    }
+
+    return entry.first->second;
+  };
+
+  const goto_programt &body=goto_functions.function_map.at(function).body;
+  std::vector<value_sett>::const_iterator value_set=
+    functions.at(function).value_sets.begin();
+  std::vector<value_sett> result;
+  result.reserve(body.instructions.size());
+
+  forall_goto_program_instructions(i_it, body)
+  {
+    result.push_back(
+      rename_dynamic_objects(*(value_set++), to_location_number));
+    result.back().location_number=i_it->location_number;
+  }
+
+  return result;
+}
+
+/// \return true if all functions that \p goto_program calls are either in
+///   \p reusable or have no body
+static bool calls_reusable_functions(
+  const goto_programt &goto_program,
+  const goto_functionst &goto_functions,
+  const std::set<irep_idt> &reusable)
+{
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    if(!i_it->is_function_call())
+      continue;
+
+    const exprt &function=to_code_function_call(i_it->code).function();
+
+    // calls through function pointers may go anywhere
+    if(function.id()!=ID_symbol)
+      return false;
+
+    const irep_idt &identifier=to_symbol_expr(function).get_identifier();
+
+    if(reusable.find(identifier)!=reusable.end())
+      continue;
+
+    goto_functionst::function_mapt::const_iterator f_it=
+      goto_functions.function_map.find(identifier);
+
+    if(f_it==goto_functions.function_map.end() ||
+       f_it->second.body_available())
+      return false;
+  }
+
+  return true;
+}
+
+std::set<irep_idt> value_set_cachet::reusable_functions(
+  const goto_functionst &goto_functions,
+  const namespacet &ns) const
+{
+  std::set<irep_idt> reusable;
+
+  if(functions.empty() || types_hash!=hash_types(ns))
+    return reusable;
+
+  std::set<irep_idt> unchanged;
+
+  forall_goto_functions(f_it, goto_functions)
+  {
+    if(!f_it->second.body_available())
+      continue;
+
+    const goto_programt &body=f_it->second.body;
+    std::map<irep_idt, functiont>::const_iterator c_it=
+      functions.find(f_it->first);
+
+    if(c_it!=functions.end() &&
+       c_it->second.value_sets.size()==body.instructions.size() &&
+       c_it->second.hash==hash(body))
+      unchanged.insert(f_it->first);
+  }
+
+  // the dynamic objects are named after instructions of unchanged functions
+  for(const auto &function : unchanged)
+  {
+    const std::set<irep_idt> &allocating=
+      functions.at(function).allocating_functions;
+
+    if(std::includes(
+         unchanged.begin(), unchanged.end(),
+         allocating.begin(), allocating.end()))
+      reusable.insert(function);
+  }
+
+  // remove the callers of functions that have changed, until none is left
+  bool changed=true;
+
+  while(changed)
+  {
+    changed=false;
+
+    for(std::set<irep_idt>::iterator it=reusable.begin();
+        it!=reusable.end(); )
+    {
+      if(calls_reusable_functions(
+           goto_functions.function_map.at(*it).body,
+           goto_functions,
+           reusable))
+      {
+        ++it;
+      }
+      else
+      {
+        it=reusable.erase(it);
+        changed=true;
+      }
+    }
+  }
+
+  return reusable;
+}
+
+/// Writes the header and then the contents, preceded by their length, so
+/// that truncated files are detected before they are read.
+void value_set_cachet::write(std::ostream &out) const
+{
+  std::ostringstream contents;
+  write_contents(contents);
+
+  out << "VSC";
+  write_gb_word(out, VALUE_SET_CACHE_VERSION);
+  write_gb_word(out, contents.str().size());
+  out << contents.str();
+}
+
+bool value_set_cachet::read(std::istream &in)
+{
+  clear();
+
+  char header[3];
+  in.read(header, sizeof(header));
+
+  if(!in || header[0]!='V' || header[1]!='S' || header[2]!='C')
+    return true;
+
+  if(irep_serializationt::read_gb_word(in)!=VALUE_SET_CACHE_VERSION)
+    return true;
+
+  const std::size_t size=irep_serializationt::read_gb_word(in);
+
+  if(!in)
+    return true;
+
+  std::string contents(
+    (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  if(contents.size()!=size)
+    return true;
+
+  std::istringstream contents_in(contents);
+  read_contents(contents_in);
+
+  return false;
+}
+
+void value_set_cachet::write_contents(std::ostream &out) const
+{
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt irepconverter(ireps_container);
+
+  write_gb_word(out, types_hash);
+  write_gb_word(out, allocation_sites.size());
+
+  for(const auto &site : allocation_sites)
+  {
+    irepconverter.write_string_ref(out, site.first);
+    write_gb_word(out, site.second);
+  }
+
+  write_gb_word(out, functions.size());
+
+  for(const auto &function : functions)
+  {
+    irepconverter.write_string_ref(out, function.first);
+    write_gb_word(out, function.second.hash);
+    write_gb_word(out, function.second.allocating_functions.size());
+
+    for(const auto &allocating : function.second.allocating_functions)
+      irepconverter.write_string_ref(out, allocating);
+
+    write_gb_word(out, function.second.value_sets.size());
+
+    for(const auto &value_set : function.second.value_sets)
+    {
+      write_gb_word(out, value_set.location_number);
+      write_gb_word(out, value_set.values.size());
+
+      for(const auto &value : value_set.values)
+      {
+        const value_sett::entryt &entry=value.second;
+
+        irepconverter.write_string_ref(out, value.first);
+        irepconverter.write_string_ref(out, entry.identifier);
+        write_gb_string(out, entry.suffix);
+
+        // the objects are written as expressions, as their numbers are
+        // only valid in this run
+        const value_sett::object_map_dt &object_map=entry.object_map.read();
+        write_gb_word(out, object_map.size());
+
+        for(const auto &object : object_map)
+        {
+          irepconverter.reference_convert(
+            value_sett::object_numbering[object.first], out);
+          // an unknown offset is written as the empty string
+          write_gb_string(
+            out, object.second ? integer2string(*object.second) : "");
+        }
+      }
+    }
+  }
+}
+
+void value_set_cachet::read_contents(std::istream &in)
+{
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt irepconverter(ireps_container);
+
+  types_hash=irepconverter.read_gb_word(in);
+  allocation_sites.resize(irepconverter.read_gb_word(in));
+
+  for(auto &site : allocation_sites)
+  {
+    site.first=irepconverter.read_string_ref(in);
+    site.second=irepconverter.read_gb_word(in);
+  }
+
+  const std::size_t function_count=irepconverter.read_gb_word(in);
+
+  for(std::size_t f=0; f<function_count; f++)
+  {
+    functiont &function=functions[irepconverter.read_string_ref(in)];
+    function.hash=irepconverter.read_gb_word(in);
+    const std::size_t allocating_count=irepconverter.read_gb_word(in);
+
+    for(std::size_t a=0; a<allocating_count; a++)
+      function.allocating_functions.insert(irepconverter.read_string_ref(in));
+
+    function.value_sets.resize(irepconverter.read_gb_word(in));
+
+    for(auto &value_set : function.value_sets)
+    {
+      value_set.location_number=
+        static_cast<unsigned>(irepconverter.read_gb_word(in));
+      const std::size_t value_count=irepconverter.read_gb_word(in);
+
+      for(std::size_t v=0; v<value_count; v++)
+      {
+        const irep_idt key=irepconverter.read_string_ref(in);
+        value_sett::entryt &entry=value_set.values[key];
+        entry.identifier=irepconverter.read_string_ref(in);
+        entry.suffix=id2string(irepconverter.read_gb_string(in));
+
+        const std::size_t object_count=irepconverter.read_gb_word(in);
+
+        for(std::size_t o=0; o<object_count; o++)
+        {
+          exprt object;
+          irepconverter.reference_convert(in, object);
+          const std::string offset=id2string(irepconverter.read_gb_string(in));
+
+          entry.object_map.write()[value_sett::object_numbering.number(object)]=
+            offset.empty() ?
+              value_sett::offsett() :
+              value_sett::offsett(string2integer(offset));
+        }
+      }
+    }
+  }
+}
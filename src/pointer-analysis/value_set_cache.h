@@ -0,0 +1,118 @@
+/*******************************************************************\
+
+Module: Value Set Cache
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Value Set Cache
+
+#ifndef CPROVER_POINTER_ANALYSIS_VALUE_SET_CACHE_H
+#define CPROVER_POINTER_ANALYSIS_VALUE_SET_CACHE_H
+
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <goto-programs/goto_functions.h>
+
+#include "value_set.h"
+
+#define VALUE_SET_CACHE_VERSION 2
+
+/// The value sets of the instructions of each function, as computed by
+/// value_set_analysist, together with a hash of the function body that
+/// they have been computed for. Written to a file next to a goto binary,
+/// these let later tools that work on the same binary skip the analysis of
+/// the functions that have not changed.
+///
+/// The hash of a body only depends on the body, so that a function is still
+/// reused when the location numbers of its instructions change because other
+/// functions have. Dynamic objects are named after the location number of
+/// the instruction that allocates them. In the cache, they are named after
+/// the function of that instruction and its index in the body instead, and
+/// a function is only reused if the functions that allocate the dynamic
+/// objects in its value sets have not changed either. The value sets are
+/// only taken from the cache if the types in the symbol table have not
+/// changed.
+///
+/// The flow-insensitive analyses value_set_analysis_fit,
+/// value_set_analysis_fivrt and value_set_analysis_fivrnst keep a single
+/// state for the whole program rather than one per instruction. Neither
+/// goto-instrument nor any other tool runs them with a cache, and they are
+/// not covered.
+class value_set_cachet
+{
+public:
+  typedef std::function<const value_sett &(goto_programt::const_targett)>
+    get_value_sett;
+
+  value_set_cachet():types_hash(0)
+  {
+  }
+
+  /// Replace the contents of the cache by the value sets of the
+  /// instructions of the functions with a body in \p goto_functions
+  void store(
+    const goto_functionst &goto_functions,
+    const namespacet &ns,
+    get_value_sett get_value_set);
+
+  /// The functions in \p goto_functions whose value sets can be taken from
+  /// the cache. Their bodies must be the ones the value sets have been
+  /// computed for, and the same must hold for all functions that they may
+  /// call, as the value sets after a call depend on the function called.
+  std::set<irep_idt> reusable_functions(
+    const goto_functionst &goto_functions,
+    const namespacet &ns) const;
+
+  /// The value sets of the instructions of \p function, which must be one
+  /// of the reusable functions, in order. Their dynamic objects are named
+  /// after the location numbers in \p goto_functions.
+  std::vector<value_sett> value_sets(
+    const irep_idt &function,
+    const goto_functionst &goto_functions) const;
+
+  void clear()
+  {
+    types_hash=0;
+    functions.clear();
+    allocation_sites.clear();
+  }
+
+  void write(std::ostream &out) const;
+
+  /// \return true if \p in does not contain a value set cache of this
+  ///   version, in which case the cache is left empty
+  bool read(std::istream &in);
+
+  static std::size_t hash(const goto_programt &goto_program);
+  static std::size_t hash_types(const namespacet &ns);
+
+protected:
+  struct functiont
+  {
+    std::size_t hash;
+    std::vector<value_sett> value_sets;
+    // the functions that allocate the dynamic objects in the value sets
+    std::set<irep_idt> allocating_functions;
+  };
+
+  std::size_t types_hash;
+  std::map<irep_idt, functiont> functions;
+
+  // A function and the index of an instruction in its body. The dynamic
+  // objects in the value sets of the cache are named after their position
+  // in allocation_sites.
+  typedef std::pair<irep_idt, std::size_t> allocation_sitet;
+  std::vector<allocation_sitet> allocation_sites;
+
+  void write_contents(std::ostream &out) const;
+  void read_contents(std::istream &in);
+};
+
+#endif // CPROVER_POINTER_ANALYSIS_VALUE_SET_CACHE_H
@@ -27,6 +27,8 @@ arrayst::arrayst(
 {
   lazy_arrays = false;        // will be set to true when --refine is used
   incremental_cache = false;  // for incremental solving
+  lazy_array_axioms = false;
+  lazy_array_rounds = 0;
 }
 
 void arrayst::record_array_index(const index_exprt &index)
@@ -250,6 +252,12 @@ void arrayst::add_array_constraint(const lazy_constraintt &lazy, bool refine)
       lazy_array_constraints.push_back(lazy);
     }
   }
+  else if(incremental_cache)
+  {
+    // add the constraint eagerly, unless a previous round has done so
+    if(expr_map.insert(std::make_pair(lazy.lazy, true)).second)
+      prop.l_set_to_true(convert(lazy.lazy));
+  }
   else
   {
     // add the constraint eagerly
@@ -265,6 +273,9 @@ void arrayst::add_array_constraints()
   // reduce initial index map
   update_index_map(true);
 
+  if(lazy_array_axioms)
+    prepare_lazy_array_axioms();
+
   // add constraints for if, with, array_of
   for(std::size_t i=0; i<arrays.size(); i++)
   {
@@ -303,6 +314,10 @@ void arrayst::add_array_Ackermann_constraints()
   // iterate over arrays
   for(std::size_t i=0; i<arrays.size(); i++)
   {
+    // added on demand
+    if(is_lazy_array(arrays[i]))
+      continue;
+
     const index_sett &index_set=index_map[arrays.find_number(i)];
 
 #ifdef DEBUG
@@ -323,39 +338,54 @@ void arrayst::add_array_Ackermann_constraints()
           if(i1->is_constant() && i2->is_constant())
             continue;
 
-          // index equality
-          equal_exprt indices_equal(*i1, *i2);
+          const exprt constraint=
+            array_Ackermann_constraint(arrays[i], *i1, *i2);
 
-          if(indices_equal.op0().type()!=
-             indices_equal.op1().type())
+          if(constraint.is_not_nil())
           {
-            indices_equal.op1().
-              make_typecast(indices_equal.op0().type());
+            // add constraint
+            lazy_constraintt lazy(lazy_typet::ARRAY_ACKERMANN, constraint);
+            add_array_constraint(lazy, true); // added lazily
           }
+        }
+  }
+}
+
+/// \return the constraint `index1=index2 => array[index1]=array[index2]`,
+///   or nil if the indices cannot be equal
+exprt arrayst::array_Ackermann_constraint(
+  const exprt &array,
+  const exprt &index1,
+  const exprt &index2)
+{
+  // index equality
+  equal_exprt indices_equal(index1, index2);
 
-          literalt indices_equal_lit=convert(indices_equal);
+  if(indices_equal.op0().type()!=
+     indices_equal.op1().type())
+  {
+    indices_equal.op1().
+      make_typecast(indices_equal.op0().type());
+  }
 
-          if(indices_equal_lit!=const_literal(false))
-          {
-            const typet &subtype=ns.follow(arrays[i].type()).subtype();
-            index_exprt index_expr1(arrays[i], *i1, subtype);
+  literalt indices_equal_lit=convert(indices_equal);
 
-            index_exprt index_expr2=index_expr1;
-            index_expr2.index()=*i2;
+  if(indices_equal_lit==const_literal(false))
+    return nil_exprt();
 
-            equal_exprt values_equal(index_expr1, index_expr2);
+  const typet &subtype=ns.follow(array.type()).subtype();
+  index_exprt index_expr1(array, index1, subtype);
 
-            // add constraint
-            lazy_constraintt lazy(lazy_typet::ARRAY_ACKERMANN,
-              implies_exprt(literal_exprt(indices_equal_lit), values_equal));
-            add_array_constraint(lazy, true); // added lazily
+  index_exprt index_expr2=index_expr1;
+  index_expr2.index()=index2;
+
+  equal_exprt values_equal(index_expr1, index_expr2);
 
 #if 0 // old code for adding, not significantly faster
-            prop.lcnf(!indices_equal_lit, convert(values_equal));
+  prop.lcnf(!indices_equal_lit, convert(values_equal));
 #endif
-          }
-        }
-  }
+
+  return implies_exprt(literal_exprt(indices_equal_lit), values_equal);
 }
 
 /// merge the indices into the root
@@ -434,7 +464,14 @@ void arrayst::add_array_constraints_equality(
     // add constraint
     // equality constraints are not added lazily
     // convert must be done to guarantee correct update of the index_set
-    prop.lcnf(!array_equality.l, convert(equality_expr));
+    literalt equality_lit=convert(equality_expr);
+
+    if(!incremental_cache ||
+       expr_map.insert(
+         std::make_pair(
+           implies_exprt(literal_exprt(array_equality.l), equality_expr),
+           true)).second)
+      prop.lcnf(!array_equality.l, equality_lit);
   }
 }
 
@@ -532,44 +569,67 @@ void arrayst::add_array_constraints_with(
   // use other array index applications for "else" case
   // add constraint x[I]=y[I] for I!=i
 
-  for(auto other_index : index_set)
+  if(is_lazy_array(expr))
+  {
+    // added on demand
+    lazy_with_exprs.push_back(expr);
+    return;
+  }
+
+  for(const auto &other_index : index_set)
   {
     if(other_index!=index)
     {
-      // we first build the guard
+      const exprt constraint=array_with_constraint(expr, other_index);
 
-      if(other_index.type()!=index.type())
-        other_index.make_typecast(index.type());
+      if(constraint.is_not_nil())
+      {
+        // add constraint
+        lazy_constraintt lazy(lazy_typet::ARRAY_WITH, constraint);
+        add_array_constraint(lazy, false); // added immediately
+      }
+    }
+  }
+}
 
-      literalt guard_lit=convert(equal_exprt(index, other_index));
+/// \return the constraint `i=I || x[I]=y[I]` for `x=(y with [i:=v])` and
+///   \p other_index I, or nil if the indices are always equal
+exprt arrayst::array_with_constraint(
+  const with_exprt &expr,
+  const exprt &other_index)
+{
+  const exprt &index=expr.where();
 
-      if(guard_lit!=const_literal(true))
-      {
-        const typet &subtype=ns.follow(expr.type()).subtype();
-        index_exprt index_expr1(expr, other_index, subtype);
-        index_exprt index_expr2(expr.op0(), other_index, subtype);
+  // we first build the guard
 
-        equal_exprt equality_expr(index_expr1, index_expr2);
+  exprt other_index_cast=other_index;
+  if(other_index_cast.type()!=index.type())
+    other_index_cast.make_typecast(index.type());
 
-        // add constraint
-        lazy_constraintt lazy(lazy_typet::ARRAY_WITH, or_exprt(equality_expr,
-                                literal_exprt(guard_lit)));
-        add_array_constraint(lazy, false); // added immediately
+  literalt guard_lit=convert(equal_exprt(index, other_index_cast));
+
+  if(guard_lit==const_literal(true))
+    return nil_exprt();
+
+  const typet &subtype=ns.follow(expr.type()).subtype();
+  index_exprt index_expr1(expr, other_index_cast, subtype);
+  index_exprt index_expr2(expr.op0(), other_index_cast, subtype);
+
+  equal_exprt equality_expr(index_expr1, index_expr2);
 
 #if 0 // old code for adding, not significantly faster
-        {
-          literalt equality_lit=convert(equality_expr);
+  {
+    literalt equality_lit=convert(equality_expr);
 
-          bvt bv;
-          bv.reserve(2);
-          bv.push_back(equality_lit);
-          bv.push_back(guard_lit);
-          prop.lcnf(bv);
-        }
-#endif
-      }
-    }
+    bvt bv;
+    bv.reserve(2);
+    bv.push_back(equality_lit);
+    bv.push_back(guard_lit);
+    prop.lcnf(bv);
   }
+#endif
+
+  return or_exprt(equality_expr, literal_exprt(guard_lit));
 }
 
 void arrayst::add_array_constraints_update(
@@ -706,3 +766,267 @@ void arrayst::add_array_constraints_if(
 #endif
   }
 }
+
+/// \return true if the Ackermann and with-constraints of \p array are
+///   added on demand
+bool arrayst::is_lazy_array(const exprt &array)
+{
+  return
+    lazy_array_axioms &&
+    lazy_array_classes.find(arrays.find_number(array))!=
+      lazy_array_classes.end();
+}
+
+/// Decide which equivalence classes of arrays get their constraints on
+/// demand, and convert the reads these constraints refer to
+void arrayst::prepare_lazy_array_axioms()
+{
+  lazy_array_classes.clear();
+  lazy_with_exprs.clear();
+
+  // We need to be able to tell whether two indices are equal by looking at
+  // their values in the model. Nested arrays are left alone, as the
+  // constraints for their elements would introduce further array
+  // equalities.
+  for(std::size_t i=0; i<arrays.size(); i++)
+  {
+    if(!arrays.is_root_number(i))
+      continue;
+
+    const typet &subtype=ns.follow(arrays[i].type()).subtype();
+    if(ns.follow(subtype).id()==ID_array)
+      continue;
+
+    const index_sett &index_set=index_map[i];
+    if(index_set.empty())
+      continue;
+
+    const typet &index_type=index_set.begin()->type();
+    bool supported=
+      index_type.id()==ID_signedbv || index_type.id()==ID_unsignedbv;
+
+    for(const auto &index : index_set)
+      if(index.type()!=index_type)
+        supported=false;
+
+    if(supported)
+      lazy_array_classes.insert(i);
+  }
+
+  // The model needs to give values to the indices and to the elements of
+  // all arrays at these, and these must survive the SAT solver's
+  // preprocessing, as constraints over them are added later.
+  for(std::size_t i=0; i<arrays.size(); i++)
+  {
+    const std::size_t root=arrays.find_number(i);
+    if(lazy_array_classes.find(root)==lazy_array_classes.end())
+      continue;
+
+    // take copies, as conversion may add arrays and indices
+    const exprt array=arrays[i];
+    const index_sett index_set=index_map[root];
+    const typet &subtype=ns.follow(array.type()).subtype();
+
+    for(const auto &index : index_set)
+    {
+      set_frozen(convert_bv(index));
+      set_frozen(convert_bv(index_exprt(array, index, subtype)));
+    }
+  }
+}
+
+/// \param [out] value: the value of \p index in the current model
+/// \return false if the value is not known
+bool arrayst::get_index_value(const exprt &index, mp_integer &value)
+{
+  const bvt &bv=convert_bv(index);
+
+  value=0;
+  mp_integer weight=1;
+
+  for(const auto &literal : bv)
+  {
+    const tvt bit=prop.l_get(literal);
+    if(bit.is_unknown())
+      return false;
+    if(bit.is_true())
+      value+=weight;
+    weight*=2;
+  }
+
+  // two's complement
+  if(index.type().id()==ID_signedbv &&
+     !bv.empty() &&
+     prop.l_get(bv.back()).is_true())
+    value-=weight;
+
+  return true;
+}
+
+/// \return true if \p expr1 and \p expr2 are known to have the same value
+///   in the current model
+bool arrayst::same_value(const exprt &expr1, const exprt &expr2)
+{
+  const bvt bv1=convert_bv(expr1);
+  const bvt &bv2=convert_bv(expr2);
+
+  if(bv1.size()!=bv2.size())
+    return false;
+
+  for(std::size_t i=0; i<bv1.size(); i++)
+  {
+    const tvt bit1=prop.l_get(bv1[i]);
+    if(bit1.is_unknown() || bit1!=prop.l_get(bv2[i]))
+      return false;
+  }
+
+  return true;
+}
+
+/// Add \p axiom, unless this has been done before
+/// \return true if the axiom is new
+bool arrayst::add_lazy_array_axiom(std::size_t array_class, const exprt &axiom)
+{
+  if(axiom.is_nil() || !lazy_array_axioms_added.insert(axiom).second)
+    return false;
+
+  prop.l_set_to_true(convert(axiom));
+  lazy_array_axiom_counts[array_class]++;
+  return true;
+}
+
+/// Add the constraints that are violated by the current model
+/// \return the number of constraints added
+std::size_t arrayst::add_violated_array_axioms()
+{
+  std::size_t added=0;
+
+  // Ackermann constraints: group the indices by their value, and check
+  // that all reads in a group agree with the first one
+  for(std::size_t i=0; i<arrays.size(); i++)
+  {
+    const std::size_t root=arrays.find_number(i);
+    if(lazy_array_classes.find(root)==lazy_array_classes.end())
+      continue;
+
+    const exprt array=arrays[i];
+    const index_sett index_set=index_map[root];
+    const typet &subtype=ns.follow(array.type()).subtype();
+
+    std::map<mp_integer, exprt> representatives;
+
+    for(const auto &index : index_set)
+    {
+      mp_integer value;
+      if(!get_index_value(index, value))
+      {
+        // relate it to all other indices
+        for(const auto &other_index : index_set)
+          if(other_index!=index &&
+             add_lazy_array_axiom(
+               root, array_Ackermann_constraint(array, index, other_index)))
+            added++;
+        continue;
+      }
+
+      const auto entry=representatives.insert(std::make_pair(value, index));
+      const exprt &representative=entry.first->second;
+
+      if(!entry.second &&
+         !same_value(
+           index_exprt(array, index, subtype),
+           index_exprt(array, representative, subtype)) &&
+         add_lazy_array_axiom(
+           root, array_Ackermann_constraint(array, representative, index)))
+        added++;
+    }
+  }
+
+  // with-constraints for indices other than the one written
+  for(const auto &expr : lazy_with_exprs)
+  {
+    const with_exprt &with_expr=to_with_expr(expr);
+    const std::size_t root=arrays.find_number(with_expr);
+    const index_sett index_set=index_map[root];
+    const typet &subtype=ns.follow(with_expr.type()).subtype();
+
+    mp_integer where_value;
+    const bool where_known=get_index_value(with_expr.where(), where_value);
+
+    for(const auto &other_index : index_set)
+    {
+      if(other_index==with_expr.where())
+        continue;
+
+      mp_integer value;
+      if(where_known &&
+         get_index_value(other_index, value) &&
+         value==where_value)
+        continue;
+
+      if(!same_value(
+           index_exprt(with_expr, other_index, subtype),
+           index_exprt(with_expr.old(), other_index, subtype)) &&
+         add_lazy_array_axiom(
+           root, array_with_constraint(with_expr, other_index)))
+        added++;
+    }
+  }
+
+  return added;
+}
+
+void arrayst::report_lazy_array_axioms()
+{
+  std::size_t total=0;
+  for(const auto &count : lazy_array_axiom_counts)
+    total+=count.second;
+
+  statistics() << "Array axioms: " << total << " added on demand in "
+               << lazy_array_rounds << " round(s), for "
+               << lazy_array_axiom_counts.size() << " of "
+               << lazy_array_classes.size() << " array(s)" << eom;
+
+  // name each equivalence class by one of its symbols, if any
+  std::map<std::size_t, exprt> names;
+  for(std::size_t i=0; i<arrays.size(); i++)
+  {
+    const std::size_t root=arrays.find_number(i);
+    if(arrays[i].id()==ID_symbol &&
+       lazy_array_axiom_counts.find(root)!=lazy_array_axiom_counts.end())
+      names.insert(std::make_pair(root, arrays[i]));
+  }
+
+  for(const auto &count : lazy_array_axiom_counts)
+  {
+    const auto name=names.find(count.first);
+    progress() << "  "
+               << format(name==names.end()?arrays[count.first]:name->second)
+               << ": " << count.second << eom;
+  }
+}
+
+decision_proceduret::resultt arrayst::dec_solve()
+{
+  if(!lazy_array_axioms)
+    return SUB::dec_solve();
+
+  while(true)
+  {
+    const resultt result=SUB::dec_solve();
+
+    if(result!=resultt::D_SATISFIABLE)
+    {
+      report_lazy_array_axioms();
+      return result;
+    }
+
+    lazy_array_rounds++;
+
+    if(add_violated_array_axioms()==0)
+    {
+      report_lazy_array_axioms();
+      return result;
+    }
+  }
+}
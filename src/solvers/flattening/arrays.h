@@ -12,8 +12,11 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_SOLVERS_FLATTENING_ARRAYS_H
 #define CPROVER_SOLVERS_FLATTENING_ARRAYS_H
 
+#include <list>
 #include <set>
+#include <unordered_set>
 
+#include <util/mp_arith.h>
 #include <util/union_find.h>
 
 #include "equality.h"
@@ -42,6 +45,21 @@ public:
   literalt record_array_equality(const equal_exprt &expr);
   void record_array_index(const index_exprt &expr);
 
+  /// Add the Ackermann constraints, and the constraints relating the
+  /// elements of `y with [i:=v]` and `y` at indices other than i, only once
+  /// a model of the formula violates them
+  bool lazy_array_axioms;
+
+  decision_proceduret::resultt dec_solve() override;
+
+  /// The array constraints are computed from scratch in each round of
+  /// post-processing; remember the ones added, so that each is added once
+  void redo_post_processing() override
+  {
+    incremental_cache=true;
+    SUB::redo_post_processing();
+  }
+
 protected:
   virtual void post_process_arrays()
   {
@@ -101,6 +119,13 @@ protected:
   // adds all the constraints eagerly
   void add_array_constraints();
   void add_array_Ackermann_constraints();
+  exprt array_Ackermann_constraint(
+    const exprt &array,
+    const exprt &index1,
+    const exprt &index2);
+  exprt array_with_constraint(
+    const with_exprt &expr,
+    const exprt &other_index);
   void add_array_constraints_equality(
     const index_sett &index_set, const array_equalityt &array_equality);
   void add_array_constraints(
@@ -123,6 +148,27 @@ protected:
 
   virtual bool is_unbounded_array(const typet &type) const=0;
     // (maybe this function should be partially moved here from boolbv)
+
+  virtual const bvt &convert_bv(const exprt &expr)=0;
+
+  // lazy_array_axioms: the equivalence classes (by root number) for which
+  // constraints are added on demand, the with-expressions whose constraints
+  // for other indices are pending, the constraints added so far, and their
+  // number for each equivalence class
+  std::set<std::size_t> lazy_array_classes;
+  std::list<exprt> lazy_with_exprs;
+  std::unordered_set<exprt, irep_hash> lazy_array_axioms_added;
+  std::map<std::size_t, std::size_t> lazy_array_axiom_counts;
+  std::size_t lazy_array_rounds;
+
+  bool add_lazy_array_axiom(std::size_t array_class, const exprt &axiom);
+
+  bool is_lazy_array(const exprt &array);
+  void prepare_lazy_array_axioms();
+  std::size_t add_violated_array_axioms();
+  bool get_index_value(const exprt &index, mp_integer &value);
+  bool same_value(const exprt &expr1, const exprt &expr2);
+  void report_lazy_array_axioms();
 };
 
 #endif // CPROVER_SOLVERS_FLATTENING_ARRAYS_H
@@ -115,14 +115,26 @@ bool boolbvt::literal(
 
 const bvt &boolbvt::convert_bv(const exprt &expr)
 {
+  bv_node_cachet::const_iterator node_entry=
+    bv_node_cache.find(&expr.read());
+  if(node_entry!=bv_node_cache.end())
+  {
+    bv_cache_statistics.node_hits++;
+    return *node_entry->second.second;
+  }
+
   // check cache first
   std::pair<bv_cachet::iterator, bool> cache_result=
     bv_cache.insert(std::make_pair(expr, bvt()));
   if(!cache_result.second)
   {
+    bv_cache_statistics.structural_hits++;
+    cache_node(expr, cache_result.first->second);
     return cache_result.first->second;
   }
 
+  bv_cache_statistics.misses++;
+
   // Iterators into hash_maps supposedly stay stable
   // even though we are inserting more elements recursively.
 
@@ -140,9 +152,20 @@ const bvt &boolbvt::convert_bv(const exprt &expr)
     }
   }
 
+  cache_node(expr, cache_result.first->second);
+
   return cache_result.first->second;
 }
 
+void boolbvt::cache_node(const exprt &expr, const bvt &bv)
+{
+  // A node that is not shareable may still be modified by its owner, and
+  // copying it makes a new node.
+  exprt copy=expr;
+  if(&copy.read()==&expr.read())
+    bv_node_cache.emplace(&expr.read(), std::make_pair(std::move(copy), &bv));
+}
+
 bvt boolbvt::conversion_failed(const exprt &expr)
 {
   ignoring(expr);
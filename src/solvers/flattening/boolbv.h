@@ -55,6 +55,7 @@ public:
   {
     SUB::clear_cache();
     bv_cache.clear();
+    bv_node_cache.clear();
   }
 
   void post_process() override
@@ -75,6 +76,16 @@ public:
   enum class unbounded_arrayt { U_NONE, U_ALL, U_AUTO };
   unbounded_arrayt unbounded_array;
 
+  void set_multiplier_encoding(bv_utilst::multipliert encoding)
+  {
+    bv_utils.multiplier_encoding=encoding;
+  }
+
+  void set_divider_encoding(bv_utilst::dividert encoding)
+  {
+    bv_utils.divider_encoding=encoding;
+  }
+
   mp_integer get_value(const bvt &bv)
   {
     return get_value(bv, 0, bv.size());
@@ -82,6 +93,20 @@ public:
 
   mp_integer get_value(const bvt &bv, std::size_t offset, std::size_t width);
 
+  struct bv_cache_statisticst
+  {
+    // lookups of a node that had been looked up before
+    std::size_t node_hits=0;
+    // lookups of a node equal to one that had been looked up before
+    std::size_t structural_hits=0;
+    std::size_t misses=0;
+  };
+
+  const bv_cache_statisticst &get_bv_cache_statistics() const
+  {
+    return bv_cache_statistics;
+  }
+
   const boolbv_mapt &get_map() const
   {
     return map;
@@ -115,6 +140,22 @@ protected:
   typedef std::unordered_map<const exprt, bvt, irep_hash> bv_cachet;
   bv_cachet bv_cache;
 
+  // The entries of bv_cache, keyed by the identity of the nodes that have
+  // been looked up, which takes no hashing of the expression. This finds
+  // all equal expressions if these are hash consed, and sub-terms that are
+  // shared otherwise. Only shareable nodes are entered, as others may still
+  // be modified, and the entries keep the nodes alive, so that their
+  // addresses are not reused for other expressions. Like bv_cache, this
+  // persists across calls to dec_solve, i.e., when formulas are added
+  // incrementally.
+  typedef std::unordered_map<const void *, std::pair<exprt, const bvt *>>
+    bv_node_cachet;
+  bv_node_cachet bv_node_cache;
+
+  bv_cache_statisticst bv_cache_statistics;
+
+  void cache_node(const exprt &expr, const bvt &bv);
+
   bool type_conversion(
     const typet &src_type, const bvt &src,
     const typet &dest_type, bvt &dest);
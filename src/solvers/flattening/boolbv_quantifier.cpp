@@ -230,4 +230,7 @@ void boolbvt::post_process_quantifiers()
   {
     prop.set_equal(convert_bool(it->expr), it->l);
   }
+
+  // Clear the list to avoid re-doing in case of incremental usage.
+  quantifier_list.clear();
 }
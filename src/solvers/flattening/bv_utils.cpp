@@ -8,9 +8,11 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "bv_utils.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include <util/arith_tools.h>
+#include <util/invariant.h>
 
 bvt bv_utilst::build_constant(const mp_integer &n, std::size_t width)
 {
@@ -630,14 +632,124 @@ bvt bv_utilst::wallace_tree(const std::vector<bvt> &pps)
   }
 }
 
-bvt bv_utilst::unsigned_multiplier(const bvt &_op0, const bvt &_op1)
+/// Column-wise reduction of the partial products following Dadda: in each
+/// stage, the columns are reduced to the next smaller height in the sequence
+/// 2, 3, 4, 6, 9, 13, ... using as few full and half adders as possible.
+/// Carries out of the most significant column are dropped.
+bvt bv_utilst::dadda_tree(const std::vector<bvt> &pps)
 {
-  #if 1
-  bvt op0=_op0, op1=_op1;
+  PRECONDITION(!pps.empty());
 
-  if(is_constant(op1))
-    std::swap(op0, op1);
+  const std::size_t width=pps.front().size();
+
+  // the bits of each weight, without constant zeros
+  std::vector<bvt> columns(width);
+  std::size_t max_height=0;
+
+  for(const auto &pp : pps)
+  {
+    INVARIANT(pp.size()==width, "partial products must have equal width");
+
+    for(std::size_t bit=0; bit<width; bit++)
+      if(!pp[bit].is_false())
+        columns[bit].push_back(pp[bit]);
+  }
+
+  for(const auto &column : columns)
+    max_height=std::max(max_height, column.size());
+
+  std::vector<std::size_t> heights(1, 2);
+  while(heights.back()*3/2<max_height)
+    heights.push_back(heights.back()*3/2);
+
+  for(auto h_it=heights.rbegin(); h_it!=heights.rend(); h_it++)
+  {
+    const std::size_t target=*h_it;
+
+    // carries produced in this stage for the next column
+    bvt carries;
+
+    for(auto &column : columns)
+    {
+      bvt bits;
+      bits.swap(column);
+      bits.insert(bits.end(), carries.begin(), carries.end());
+      carries.clear();
+
+      std::size_t height=bits.size();
+      std::size_t i=0;
+
+      while(height>target)
+      {
+        literalt carry_out;
+
+        if(height-target>=2)
+        {
+          column.push_back(
+            full_adder(bits[i], bits[i+1], bits[i+2], carry_out));
+          i+=3;
+          height-=2;
+        }
+        else
+        {
+          column.push_back(prop.lxor(bits[i], bits[i+1]));
+          carry_out=prop.land(bits[i], bits[i+1]);
+          i+=2;
+          height-=1;
+        }
+
+        carries.push_back(carry_out);
+      }
+
+      column.insert(column.end(), bits.begin()+i, bits.end());
+    }
+  }
+
+  // at most two bits per column are left
+  bvt a=zeros(width), b=zeros(width);
+
+  for(std::size_t bit=0; bit<width; bit++)
+  {
+    INVARIANT(columns[bit].size()<=2, "Dadda reduction must be complete");
+
+    if(columns[bit].size()>=1)
+      a[bit]=columns[bit][0];
+    if(columns[bit].size()==2)
+      b[bit]=columns[bit][1];
+  }
+
+  return add(a, b);
+}
+
+/// The usual quadratic number of partial products of \p op0 and \p op1,
+/// omitting those for constant-zero bits of \p op0
+std::vector<bvt> bv_utilst::partial_products(const bvt &op0, const bvt &op1)
+{
+  std::vector<bvt> pps;
+  pps.reserve(op0.size());
+
+  for(std::size_t bit=0; bit<op0.size(); bit++)
+    if(op0[bit]!=const_literal(false))
+    {
+      bvt pp;
+
+      pp.reserve(op0.size());
+
+      // zeros according to weight
+      for(std::size_t idx=0; idx<bit; idx++)
+        pp.push_back(const_literal(false));
+
+      for(std::size_t idx=bit; idx<op0.size(); idx++)
+        pp.push_back(prop.land(op1[idx-bit], op0[bit]));
+
+      pps.push_back(pp);
+    }
+
+  return pps;
+}
 
+bvt bv_utilst::shift_add_multiplier(const bvt &op0, const bvt &op1)
+{
   bvt product;
   product.resize(op0.size());
 
@@ -661,43 +773,153 @@ bvt bv_utilst::unsigned_multiplier(const bvt &_op0, const bvt &_op1)
     }
 
   return product;
-  #else
-  // Wallace tree multiplier. This is disabled, as runtimes have
-  // been observed to go up by 5%-10%, and on some models even by 20%.
+}
+
+/// Multiplication by a constant: the constant is recoded into canonical
+/// signed digit form, which has the least number of non-zero digits, and a
+/// shifted copy of \p op is added or subtracted for each of these.
+bvt bv_utilst::constant_multiplier(const bvt &op, const bvt &constant)
+{
+  PRECONDITION(is_constant(constant));
+
+  const std::size_t width=op.size();
+  bvt product=zeros(width);
+  bool carry=false;
+
+  for(std::size_t bit=0; bit<width; bit++)
+  {
+    const bool digit=constant[bit].is_true();
+    const bool next=bit+1<width && constant[bit+1].is_true();
+
+    if(digit==carry)
+    {
+      // 0 or 2: nothing to add, the carry stays
+      continue;
+    }
+
+    const bvt shifted=shift(op, shiftt::SHIFT_LEFT, bit);
+
+    if(next)
+    {
+      // a run of ones: subtract here and carry into the next digit
+      product=sub(product, shifted);
+      carry=true;
+    }
+    else
+    {
+      product=add(product, shifted);
+      carry=false;
+    }
+  }
+
+  return product;
+}
 
-  // build the usual quadratic number of partial products
+/// The full double-width product of \p op0 and \p op1, computed with
+/// Karatsuba's three half-width multiplications
+bvt bv_utilst::karatsuba_full_product(const bvt &op0, const bvt &op1)
+{
+  PRECONDITION(op0.size()==op1.size());
+
+  const std::size_t n=op0.size();
+
+  if(n<=karatsuba_threshold)
+    return shift_add_multiplier(zero_extension(op0, 2*n),
+                                zero_extension(op1, 2*n));
+
+  const std::size_t m=n/2;
+  const std::size_t k=n-m+1;
+
+  const bvt a0=extract_lsb(op0, m), a1=extract_msb(op0, n-m);
+  const bvt b0=extract_lsb(op1, m), b1=extract_msb(op1, n-m);
 
+  // z0=a0*b0, z2=a1*b1, z1=(a0+a1)*(b0+b1)-z0-z2
+  const bvt z0=karatsuba_full_product(a0, b0);
+  const bvt z2=karatsuba_full_product(a1, b1);
+
+  const bvt sum_a=add(zero_extension(a0, k), zero_extension(a1, k));
+  const bvt sum_b=add(zero_extension(b0, k), zero_extension(b1, k));
+
+  bvt z1=karatsuba_full_product(sum_a, sum_b);
+  z1=sub(z1, zero_extension(z0, 2*k));
+  z1=sub(z1, zero_extension(z2, 2*k));
+
+  bvt product=zero_extension(z0, 2*n);
+  product=add(
+    product,
+    shift(zero_extension(z1, 2*n), shiftt::SHIFT_LEFT, m));
+  product=add(
+    product,
+    shift(zero_extension(z2, 2*n), shiftt::SHIFT_LEFT, 2*m));
+
+  return product;
+}
+
+/// Truncated product: with op0=a0+2^m*a1 and op1=b0+2^m*b1, where 2*m is at
+/// least the width, only a0*b0 needs to be computed in full, and the cross
+/// terms a1*b0 and a0*b1 only modulo 2^(width-m).
+bvt bv_utilst::karatsuba_multiplier(const bvt &op0, const bvt &op1)
+{
+  const std::size_t n=op0.size();
+
+  if(n<=karatsuba_threshold)
+    return shift_add_multiplier(op0, op1);
+
+  const std::size_t m=(n+1)/2;
+
+  const bvt a0=extract_lsb(op0, m), a1=extract_msb(op0, n-m);
+  const bvt b0=extract_lsb(op1, m), b1=extract_msb(op1, n-m);
+
+  const bvt low=extract_lsb(karatsuba_full_product(a0, b0), n);
+
+  const bvt cross=add(
+    karatsuba_multiplier(a1, extract_lsb(b0, n-m)),
+    karatsuba_multiplier(extract_lsb(a0, n-m), b1));
+
+  return add(low, concatenate(zeros(m), cross));
+}
+
+bvt bv_utilst::unsigned_multiplier(const bvt &_op0, const bvt &_op1)
+{
   bvt op0=_op0, op1=_op1;
 
   if(is_constant(op1))
     std::swap(op0, op1);
 
-  std::vector<bvt> pps;
-  pps.reserve(op0.size());
-
-  for(std::size_t bit=0; bit<op0.size(); bit++)
-    if(op0[bit]!=const_literal(false))
-    {
-      bvt pp;
+  if(op0.empty())
+    return op0;
 
-      pp.reserve(op0.size());
+  if(multiplier_encoding!=multipliert::SHIFT_ADD && is_constant(op0))
+    return constant_multiplier(op1, op0);
 
-      // zeros according to weight
-      for(std::size_t idx=0; idx<bit; idx++)
-        pp.push_back(const_literal(false));
+  switch(multiplier_encoding)
+  {
+  case multipliert::AUTO:
+  case multipliert::SHIFT_ADD:
+    return shift_add_multiplier(op0, op1);
 
-      for(std::size_t idx=bit; idx<op0.size(); idx++)
-        pp.push_back(prop.land(op1[idx-bit], op0[bit]));
+  case multipliert::WALLACE:
+  case multipliert::DADDA:
+  {
+    const std::vector<bvt> pps=partial_products(op0, op1);
 
-      pps.push_back(pp);
+    if(pps.empty())
+      return zeros(op0.size());
+    else if(multiplier_encoding==multipliert::WALLACE)
+    {
+      // Wallace trees are not the default, as runtimes have
+      // been observed to go up by 5%-10%, and on some models even by 20%.
+      return wallace_tree(pps);
     }
+    else
+      return dadda_tree(pps);
+  }
 
-  if(pps.empty())
-    return zeros(op0.size());
-  else
-    return wallace_tree(pps);
+  case multipliert::KARATSUBA:
+    return karatsuba_multiplier(op0, op1);
+  }
 
-  #endif
+  UNREACHABLE;
 }
 
 bvt bv_utilst::unsigned_multiplier_no_overflow(
@@ -895,6 +1117,12 @@ void bv_utilst::unsigned_divider(
   bvt &res,
   bvt &rem)
 {
+  if(divider_encoding==dividert::RESTORING)
+  {
+    restoring_divider(op0, op1, res, rem);
+    return;
+  }
+
   std::size_t width=op0.size();
 
   // check if we divide by a power of two
@@ -975,6 +1203,75 @@ void bv_utilst::unsigned_divider(
 }
 
 
+/// Long division that restores the partial remainder whenever subtracting
+/// the divisor would make it negative. Unlike the multiplicative encoding,
+/// this needs no fresh variables, and quotient and remainder follow from the
+/// operands by propagation alone. Division by zero yields the SMT-LIB
+/// values, i.e., all ones and the dividend, which is one of the results
+/// the multiplicative encoding allows.
+void bv_utilst::restoring_divider(
+  const bvt &op0,
+  const bvt &op1,
+  bvt &res,
+  bvt &rem)
+{
+  std::size_t width=op0.size();
+
+  // check if we divide by a power of two
+  std::size_t one_count=0, non_const_count=0, one_pos=0;
+
+  for(std::size_t i=0; i<op1.size(); i++)
+  {
+    literalt l=op1[i];
+    if(l.is_true())
+    {
+      one_count++;
+      one_pos=i;
+    }
+    else if(!l.is_false())
+      non_const_count++;
+  }
+
+  if(non_const_count==0 && one_count==1)
+  {
+    // it is a power of two!
+    res=shift(op0, shiftt::SHIFT_LRIGHT, one_pos);
+
+    // remainder is just a mask
+    rem=op0;
+    for(std::size_t i=one_pos; i<rem.size(); i++)
+      rem[i]=const_literal(false);
+    return;
+  }
+
+  // the partial remainder needs one more bit than the operands, as it
+  // may be up to twice the divisor before the subtraction
+  const bvt divisor=zero_extension(op1, width+1);
+
+  res.resize(width);
+  rem=zeros(width);
+
+  for(std::size_t i=width; i>0; i--)
+  {
+    // shift in the next bit of the dividend
+    bvt partial;
+    partial.reserve(width+1);
+    partial.push_back(op0[i-1]);
+    partial.insert(partial.end(), rem.begin(), rem.end());
+
+    // the carry out of partial-divisor is set iff partial>=divisor
+    bvt difference=partial;
+    literalt no_borrow;
+    adder(difference, inverted(divisor), const_literal(true), no_borrow);
+
+    res[i-1]=no_borrow;
+
+    // the new partial remainder is below the divisor, and hence fits
+    rem=select(no_borrow, difference, partial);
+    rem.resize(width);
+  }
+}
+
 #ifdef COMPACT_EQUAL_CONST
 // TODO : use for lt_or_le as well
 
@@ -1361,3 +1658,47 @@ bvt bv_utilst::verilog_bv_normal_bits(const bvt &src)
 
   return even_bits;
 }
+
+bool get_multiplier_encoding(
+  const std::string &name,
+  bv_utilst::multipliert &encoding)
+{
+  if(name=="auto")
+    encoding=bv_utilst::multipliert::AUTO;
+  else if(name=="shift-add")
+    encoding=bv_utilst::multipliert::SHIFT_ADD;
+  else if(name=="wallace")
+    encoding=bv_utilst::multipliert::WALLACE;
+  else if(name=="dadda")
+    encoding=bv_utilst::multipliert::DADDA;
+  else if(name=="karatsuba")
+    encoding=bv_utilst::multipliert::KARATSUBA;
+  else
+    return false;
+
+  return true;
+}
+
+std::string multiplier_encoding_names()
+{
+  return "auto, shift-add, wallace, dadda, karatsuba";
+}
+
+bool get_divider_encoding(
+  const std::string &name,
+  bv_utilst::dividert &encoding)
+{
+  if(name=="multiplicative")
+    encoding=bv_utilst::dividert::MULTIPLICATIVE;
+  else if(name=="restoring")
+    encoding=bv_utilst::dividert::RESTORING;
+  else
+    return false;
+
+  return true;
+}
+
+std::string divider_encoding_names()
+{
+  return "multiplicative, restoring";
+}
@@ -12,6 +12,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include <util/mp_arith.h>
 
@@ -30,6 +32,22 @@ public:
 
   enum class representationt { SIGNED, UNSIGNED };
 
+  /// Encodings of unsigned multiplication. With any of them but SHIFT_ADD,
+  /// multiplication by a constant is encoded as additions and subtractions of
+  /// shifted operands. AUTO uses the shift-add multiplier for non-constant
+  /// operands.
+  enum class multipliert { AUTO, SHIFT_ADD, WALLACE, DADDA, KARATSUBA };
+
+  multipliert multiplier_encoding=multipliert::SHIFT_ADD;
+
+  /// Encodings of unsigned division. MULTIPLICATIVE constrains fresh
+  /// variables for quotient and remainder by a multiplication, RESTORING
+  /// computes them with a long division circuit, and divides by powers of
+  /// two with a shift and a mask.
+  enum class dividert { MULTIPLICATIVE, RESTORING };
+
+  dividert divider_encoding=dividert::MULTIPLICATIVE;
+
   bvt build_constant(const mp_integer &i, std::size_t width);
 
   bvt incrementer(const bvt &op, literalt carry_in);
@@ -243,6 +261,40 @@ protected:
   bvt cond_negate_no_overflow(const bvt &bv, const literalt cond);
 
   bvt wallace_tree(const std::vector<bvt> &pps);
+  bvt dadda_tree(const std::vector<bvt> &pps);
+  std::vector<bvt> partial_products(const bvt &op0, const bvt &op1);
+
+  bvt shift_add_multiplier(const bvt &op0, const bvt &op1);
+  bvt constant_multiplier(const bvt &op, const bvt &constant);
+
+  // below this width, Karatsuba multiplication falls back to shift-add
+  static const std::size_t karatsuba_threshold=16;
+  bvt karatsuba_multiplier(const bvt &op0, const bvt &op1);
+  bvt karatsuba_full_product(const bvt &op0, const bvt &op1);
+
+  void restoring_divider(
+    const bvt &op0,
+    const bvt &op1,
+    bvt &res,
+    bvt &rem);
 };
 
+/// Look up the multiplier encoding with the given name
+/// \return false if there is no such encoding
+bool get_multiplier_encoding(
+  const std::string &name,
+  bv_utilst::multipliert &encoding);
+
+/// Comma-separated names of the available multiplier encodings
+std::string multiplier_encoding_names();
+
+/// Look up the divider encoding with the given name
+/// \return false if there is no such encoding
+bool get_divider_encoding(
+  const std::string &name,
+  bv_utilst::dividert &encoding);
+
+/// Comma-separated names of the available divider encodings
+std::string divider_encoding_names();
+
 #endif // CPROVER_SOLVERS_FLATTENING_BV_UTILS_H
@@ -16,13 +16,15 @@ Author: Daniel Kroening, kroening@kroening.com
 void functionst::record(
   const function_application_exprt &function_application)
 {
-  function_map[function_application.function()].applications.
-    insert(function_application);
+  function_infot &info=function_map[function_application.function()];
+
+  if(info.applications.insert(function_application).second)
+    info.ordered.push_back(function_application);
 }
 
 void functionst::add_function_constraints()
 {
-  for(function_mapt::const_iterator it=
+  for(function_mapt::iterator it=
       function_map.begin();
       it!=function_map.end();
       it++)
@@ -55,28 +57,29 @@ exprt functionst::arguments_equal(const exprt::operandst &o1,
   return and_expr;
 }
 
-void functionst::add_function_constraints(const function_infot &info)
+void functionst::add_function_constraints(function_infot &info)
 {
   // Do Ackermann's function reduction.
   // This is quadratic, slow, and needs to be modernized.
+  // When post-processing is redone incrementally, only the pairs with
+  // an application recorded since then are added.
 
-  for(std::set<function_application_exprt>::const_iterator
-      it1=info.applications.begin();
-      it1!=info.applications.end();
-      it1++)
+  for(std::size_t i1=info.constrained; i1<info.ordered.size(); i1++)
   {
-    for(std::set<function_application_exprt>::const_iterator
-        it2=info.applications.begin();
-        it2!=it1;
-        it2++)
+    for(std::size_t i2=0; i2<i1; i2++)
     {
+      const function_application_exprt &a1=info.ordered[i1];
+      const function_application_exprt &a2=info.ordered[i2];
+
       exprt arguments_equal_expr=
-        arguments_equal(it1->arguments(), it2->arguments());
+        arguments_equal(a1.arguments(), a2.arguments());
 
       implies_exprt implication(arguments_equal_expr,
-                                equal_exprt(*it1, *it2));
+                                equal_exprt(a1, a2));
 
       prop_conv.set_to_true(implication);
     }
   }
+
+  info.constrained=info.ordered.size();
 }
@@ -0,0 +1,230 @@
+/*******************************************************************\
+
+Module: Micro-Benchmark for the Multiplier Encodings
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Micro-Benchmark for the Multiplier Encodings
+///
+/// Encodes a fixed set of multiplication and division problems with each of
+/// the multiplier and divider encodings offered by bv_utilst and reports the
+/// size of the CNF and the time the default SAT solver takes. Usage:
+///
+///   multiplier_benchmark [time limit in seconds] [width]...
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <util/arith_tools.h>
+#include <util/message.h>
+
+#include <solvers/sat/satcheck.h>
+
+#include "bv_utils.h"
+
+struct benchmarkt
+{
+  const char *name;
+  // adds constraints that are satisfiable iff the answer is "sat"
+  void (*encode)(bv_utilst &, propt &, std::size_t width);
+};
+
+static mp_integer power2(std::size_t width)
+{
+  return power(2, width);
+}
+
+/// a*b!=b*a (unsat)
+static void commutativity(bv_utilst &bv_utils, propt &prop, std::size_t width)
+{
+  const bvt a=prop.new_variables(width), b=prop.new_variables(width);
+  prop.l_set_to_false(
+    bv_utils.equal(
+      bv_utils.unsigned_multiplier(a, b),
+      bv_utils.unsigned_multiplier(b, a)));
+}
+
+/// a*(b+c)!=a*b+a*c (unsat)
+static void distributivity(
+  bv_utilst &bv_utils,
+  propt &prop,
+  std::size_t width)
+{
+  const bvt a=prop.new_variables(width), b=prop.new_variables(width),
+            c=prop.new_variables(width);
+  prop.l_set_to_false(
+    bv_utils.equal(
+      bv_utils.unsigned_multiplier(a, bv_utils.add(b, c)),
+      bv_utils.add(
+        bv_utils.unsigned_multiplier(a, b),
+        bv_utils.unsigned_multiplier(a, c))));
+}
+
+/// a*b==C with 1<a, 1<b and no overflow, for C the product of two
+/// numbers of about half the width (sat)
+static void factoring(bv_utilst &bv_utils, propt &prop, std::size_t width)
+{
+  const mp_integer p=power2(width/2)-1, q=power2(width-width/2-1)+1;
+  const bvt a=prop.new_variables(width), b=prop.new_variables(width);
+  const bvt one=bv_utils.build_constant(1, width);
+
+  const bvt product=bv_utils.multiplier_no_overflow(
+    a, b, bv_utilst::representationt::UNSIGNED);
+
+  prop.l_set_to_true(
+    bv_utils.equal(product, bv_utils.build_constant(p*q, width)));
+  prop.l_set_to_true(bv_utils.unsigned_less_than(one, a));
+  prop.l_set_to_true(bv_utils.unsigned_less_than(one, b));
+}
+
+/// a*K==1 for an odd constant K, i.e., find the inverse of K (sat)
+static void constant_inverse(
+  bv_utilst &bv_utils,
+  propt &prop,
+  std::size_t width)
+{
+  // the 64 bit golden ratio constant, truncated and made odd
+  const mp_integer k=bitwise_or(
+    string2integer("11400714819323198485")%power2(width), 1);
+  const bvt a=prop.new_variables(width);
+
+  prop.l_set_to_true(
+    bv_utils.equal(
+      bv_utils.unsigned_multiplier(a, bv_utils.build_constant(k, width)),
+      bv_utils.build_constant(1, width)));
+}
+
+/// b!=0 && (a/b)*b+a%b!=a (unsat)
+static void division(bv_utilst &bv_utils, propt &prop, std::size_t width)
+{
+  const bvt a=prop.new_variables(width), b=prop.new_variables(width);
+  bvt res, rem;
+  bv_utils.unsigned_divider(a, b, res, rem);
+
+  prop.l_set_to_true(bv_utils.is_not_zero(b));
+  prop.l_set_to_false(
+    bv_utils.equal(
+      bv_utils.add(bv_utils.unsigned_multiplier(res, b), rem),
+      a));
+}
+
+/// (a/8)*8+a%8!=a (unsat)
+static void constant_division(
+  bv_utilst &bv_utils,
+  propt &prop,
+  std::size_t width)
+{
+  const bvt a=prop.new_variables(width);
+  const bvt eight=bv_utils.build_constant(8, width);
+  bvt res, rem;
+  bv_utils.unsigned_divider(a, eight, res, rem);
+
+  prop.l_set_to_false(
+    bv_utils.equal(
+      bv_utils.add(bv_utils.unsigned_multiplier(res, eight), rem),
+      a));
+}
+
+static const benchmarkt benchmarks[]=
+{
+  { "commutativity", commutativity },
+  { "distributivity", distributivity },
+  { "factoring", factoring },
+  { "constant-inverse", constant_inverse },
+  { "division", division },
+  { "constant-division", constant_division }
+};
+
+struct encodingt
+{
+  const char *multiplier;
+  const char *divider;
+};
+
+// the default first, then each alternative on its own
+static const encodingt encodings[]=
+{
+  { "shift-add", "multiplicative" },
+  { "auto", "multiplicative" },
+  { "wallace", "multiplicative" },
+  { "dadda", "multiplicative" },
+  { "karatsuba", "multiplicative" },
+  { "shift-add", "restoring" }
+};
+
+int main(int argc, const char **argv)
+{
+  unsigned time_limit=10;
+  std::vector<std::size_t> widths;
+
+  if(argc>=2)
+    time_limit=std::strtoul(argv[1], nullptr, 10);
+
+  for(int i=2; i<argc; i++)
+    widths.push_back(std::strtoul(argv[i], nullptr, 10));
+
+  if(widths.empty())
+    widths={ 8, 16, 24, 32 };
+
+  null_message_handlert message_handler;
+
+  std::cout << std::left
+            << std::setw(20) << "benchmark"
+            << std::setw(7) << "width"
+            << std::setw(11) << "multiplier"
+            << std::setw(16) << "divider"
+            << std::right
+            << std::setw(10) << "variables"
+            << std::setw(10) << "clauses"
+            << std::setw(9) << "result"
+            << std::setw(10) << "time (s)" << '\n';
+
+  for(const auto &benchmark : benchmarks)
+    for(const auto width : widths)
+      for(const auto &encoding : encodings)
+      {
+        bv_utilst::multipliert multiplier;
+        get_multiplier_encoding(encoding.multiplier, multiplier);
+        bv_utilst::dividert divider;
+        get_divider_encoding(encoding.divider, divider);
+
+        satcheckt satcheck;
+        satcheck.set_message_handler(message_handler);
+        satcheck.set_time_limit_seconds(time_limit);
+
+        bv_utilst bv_utils(satcheck);
+        bv_utils.multiplier_encoding=multiplier;
+        bv_utils.divider_encoding=divider;
+
+        benchmark.encode(bv_utils, satcheck, width);
+
+        const auto start=std::chrono::steady_clock::now();
+        const propt::resultt result=satcheck.prop_solve();
+        const auto stop=std::chrono::steady_clock::now();
+
+        const char *result_string=
+          result==propt::resultt::P_SATISFIABLE?"sat":
+          result==propt::resultt::P_UNSATISFIABLE?"unsat":"timeout";
+
+        std::cout << std::left
+                  << std::setw(20) << benchmark.name
+                  << std::setw(7) << width
+                  << std::setw(11) << encoding.multiplier
+                  << std::setw(16) << encoding.divider
+                  << std::right
+                  << std::setw(10) << satcheck.no_variables()
+                  << std::setw(10) << satcheck.no_clauses()
+                  << std::setw(9) << result_string
+                  << std::setw(10) << std::fixed << std::setprecision(3)
+                  << std::chrono::duration<double>(stop-start).count()
+                  << '\n';
+      }
+
+  return 0;
+}
@@ -101,7 +101,7 @@ public:
   // create a node (consulting the reverse-map)
   mini_bddt mk(unsigned var, const mini_bddt &low, const mini_bddt &high);
 
-  std::size_t number_of_nodes();
+  std::size_t number_of_nodes() const;
 
   struct var_table_entryt
   {
@@ -0,0 +1,78 @@
+/*******************************************************************\
+
+Module: Constraints Under an Activation Literal
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Constraints Under an Activation Literal
+
+#include "activated_prop_conv.h"
+
+#include <util/invariant.h>
+#include <util/std_expr.h>
+
+#include "literal_expr.h"
+
+activated_prop_convt::activated_prop_convt(
+  const namespacet &_ns,
+  prop_conv_solvert &_solver,
+  const irep_idt &activation_name):
+  prop_convt(_ns),
+  solver(_solver)
+{
+  activation=solver.convert(symbol_exprt(activation_name, bool_typet()));
+  solver.set_frozen(activation);
+}
+
+void activated_prop_convt::set_to(const exprt &expr, bool value)
+{
+  if(expr.id()==ID_not && expr.operands().size()==1)
+  {
+    set_to(expr.op0(), !value);
+    return;
+  }
+
+  if(value && expr.id()==ID_and)
+  {
+    forall_operands(it, expr)
+      set_to_true(*it);
+    return;
+  }
+
+  literalt l=solver.convert(expr);
+
+  // activation => (value ? l : !l)
+  solver.set_to_true(
+    or_exprt(
+      literal_exprt(!activation),
+      literal_exprt(value?l:!l)));
+}
+
+decision_proceduret::resultt activated_prop_convt::dec_solve()
+{
+  // without assumptions, the activation literal would be ignored and the
+  // constraints of all paths would be checked at once
+  PRECONDITION(solver.has_set_assumptions());
+
+  bvt solver_assumptions=assumptions;
+  solver_assumptions.push_back(activation);
+  solver.set_assumptions(solver_assumptions);
+
+  // constraints may have been added since the last call; post-processing
+  // adds only what is needed for these
+  solver.redo_post_processing();
+
+  decision_proceduret::resultt result=solver.dec_solve();
+
+  solver.set_assumptions(bvt());
+
+  return result;
+}
+
+void activated_prop_convt::retire()
+{
+  solver.set_to_false(literal_exprt(activation));
+}
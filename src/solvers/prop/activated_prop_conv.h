@@ -0,0 +1,101 @@
+/*******************************************************************\
+
+Module: Constraints Under an Activation Literal
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Constraints Under an Activation Literal
+
+#ifndef CPROVER_SOLVERS_PROP_ACTIVATED_PROP_CONV_H
+#define CPROVER_SOLVERS_PROP_ACTIVATED_PROP_CONV_H
+
+#include "prop_conv.h"
+
+/// \brief Adds all constraints under an activation literal
+///
+/// Wraps a persistent solver such that several formulas that need not be
+/// consistent with each other, e.g., the formulas for different paths
+/// through a program, can be solved one after another. Conversions
+/// (`convert`) are passed on unchanged, as they only add definitions, which
+/// means that the encoding of common sub-expressions and the clauses learned
+/// by the SAT solver are shared. Constraints (`set_to`) are added as
+/// implications from the activation literal, which `dec_solve` assumes.
+/// Once the formula is no longer needed, `retire` permanently disables its
+/// constraints.
+class activated_prop_convt:public prop_convt
+{
+public:
+  /// \param _ns: namespace
+  /// \param _solver: the persistent solver, which must support assumptions
+  /// \param activation_name: a fresh identifier, used for the Boolean
+  ///   symbol that represents the activation literal
+  activated_prop_convt(
+    const namespacet &_ns,
+    prop_conv_solvert &_solver,
+    const irep_idt &activation_name);
+
+  // overloading from decision_proceduret
+  void set_to(const exprt &expr, bool value) override;
+  decision_proceduret::resultt dec_solve() override;
+  exprt get(const exprt &expr) const override
+  {
+    return solver.get(expr);
+  }
+  void print_assignment(std::ostream &out) const override
+  {
+    solver.print_assignment(out);
+  }
+  std::string decision_procedure_text() const override
+  {
+    return "incremental "+solver.decision_procedure_text();
+  }
+
+  // overloading from prop_convt
+  literalt convert(const exprt &expr) override
+  {
+    return solver.convert(expr);
+  }
+  tvt l_get(literalt a) const override
+  {
+    return solver.l_get(a);
+  }
+  using prop_convt::set_frozen;
+  void set_frozen(literalt a) override
+  {
+    solver.set_frozen(a);
+  }
+  void set_assumptions(const bvt &_assumptions) override
+  {
+    assumptions=_assumptions;
+  }
+  bool has_set_assumptions() const override
+  {
+    return solver.has_set_assumptions();
+  }
+  bool is_in_conflict(literalt l) const override
+  {
+    return solver.is_in_conflict(l);
+  }
+  bool has_is_in_conflict() const override
+  {
+    return solver.has_is_in_conflict();
+  }
+
+  /// Permanently disable all constraints added via this object
+  void retire();
+
+  literalt get_activation_literal() const
+  {
+    return activation;
+  }
+
+protected:
+  prop_conv_solvert &solver;
+  literalt activation;
+  bvt assumptions;
+};
+
+#endif // CPROVER_SOLVERS_PROP_ACTIVATED_PROP_CONV_H
@@ -8,23 +8,22 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "aig_prop.h"
 
-#include <set>
-#include <stack>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <random>
+#include <unordered_map>
 
 // Tries to compact AIGs corresponding to xor and equality
 // Needed to match the performance of the native CNF back-end.
 #define USE_AIG_COMPACT
 
-// Use the Plaisted-Greenbaum encoding, again, needed to match the
-// native CNF back-end.
-#define USE_PG
-
 literalt aig_prop_baset::land(const bvt &bv)
 {
   literalt literal=const_literal(true);
 
   // Introduces N-1 extra nodes for N bits
-  // See convert_node for where this overhead is removed
+  // See encode for where this overhead is removed
   forall_literals(it, bv)
     literal=land(*it, literal);
 
@@ -36,7 +35,7 @@ literalt aig_prop_baset::lor(const bvt &bv)
   literalt literal=const_literal(true);
 
   // Introduces N-1 extra nodes for N bits
-  // See convert_node for where this overhead is removed
+  // See encode for where this overhead is removed
   forall_literals(it, bv)
     literal=land(neg(*it), literal);
 
@@ -65,7 +64,133 @@ literalt aig_prop_baset::land(literalt a, literalt b)
   if(a==b)
     return a;
 
-  return dest.new_and_node(a, b);
+  if(b<a)
+    std::swap(a, b);
+
+  literalt result;
+  if(rewriting && rewrite_and(a, b, result))
+  {
+    rewrites++;
+    return result;
+  }
+
+  const std::uint64_t key=(std::uint64_t(a.get())<<32)|b.get();
+  const auto entry=and_nodes.insert({ key, literalt() });
+
+  if(entry.second)
+    entry.first->second=dest.new_and_node(a, b);
+  else
+    strash_hits++;
+
+  return entry.first->second;
+}
+
+/// Two-level rewriting of AND nodes, following Brummayer and Biere, "Local
+/// Two-Level And-Inverter Graph Minimization without Blowup"
+/// \par parameters: Two distinct, non-constant literals that are not the
+///   negation of each other
+/// \return true if \p result has been set to a literal equivalent to the
+///   conjunction of \p a and \p b
+bool aig_prop_baset::rewrite_and(literalt a, literalt b, literalt &result)
+{
+  // rules with one AND node, in both orders
+  for(unsigned i=0; i<2; i++, std::swap(a, b))
+  {
+    if(!is_and(a))
+      continue;
+
+    const aig_nodet node=dest.get_node(a);
+
+    if(!a.sign())
+    {
+      // contradiction: (x & y) & !x = false
+      if(node.a==neg(b) || node.b==neg(b))
+      {
+        result=const_literal(false);
+        return true;
+      }
+
+      // idempotence: (x & y) & x = x & y
+      if(node.a==b || node.b==b)
+      {
+        result=a;
+        return true;
+      }
+    }
+    else
+    {
+      // subsumption: !(x & y) & !x = !x
+      if(node.a==neg(b) || node.b==neg(b))
+      {
+        result=b;
+        return true;
+      }
+
+      // substitution: !(x & y) & x = !y & x
+      if(node.a==b)
+      {
+        result=land(neg(node.b), b);
+        return true;
+      }
+
+      if(node.b==b)
+      {
+        result=land(neg(node.a), b);
+        return true;
+      }
+    }
+  }
+
+  if(!is_and(a) || !is_and(b))
+    return false;
+
+  // rules with two AND nodes, in both orders
+  for(unsigned i=0; i<2; i++, std::swap(a, b))
+  {
+    const aig_nodet node_a=dest.get_node(a), node_b=dest.get_node(b);
+    const literalt inputs_a[]={ node_a.a, node_a.b };
+    const literalt inputs_b[]={ node_b.a, node_b.b };
+
+    for(unsigned j=0; j<2; j++)
+      for(unsigned k=0; k<2; k++)
+      {
+        const literalt x=inputs_a[j], y=inputs_b[k];
+
+        // contradiction: (x & z) & (!x & w) = false
+        if(!a.sign() && !b.sign() && x==neg(y))
+        {
+          result=const_literal(false);
+          return true;
+        }
+
+        if(!a.sign() && b.sign())
+        {
+          // subsumption: (x & z) & !(!x & w) = x & z
+          if(x==neg(y))
+          {
+            result=a;
+            return true;
+          }
+
+          // substitution: (x & z) & !(x & w) = (x & z) & !w
+          if(x==y)
+          {
+            result=land(a, neg(inputs_b[1-k]));
+            return true;
+          }
+        }
+
+        // resolution: !(x & y) & !(x & !y) = !x
+        if(a.sign() && b.sign() && x==y &&
+           inputs_a[1-j]==neg(inputs_b[1-k]))
+        {
+          result=neg(x);
+          return true;
+        }
+      }
+  }
+
+  return false;
 }
 
 literalt aig_prop_baset::lor(literalt a, literalt b)
@@ -90,7 +215,7 @@ literalt aig_prop_baset::lxor(literalt a, literalt b)
     return const_literal(true);
 
   // This produces up to three nodes!
-  // See convert_node for where this overhead is removed
+  // See encode for where this overhead is removed
   return lor(land(a, neg(b)), land(neg(a), b));
 }
 
@@ -124,7 +249,7 @@ literalt aig_prop_baset::lselect(literalt a, literalt b, literalt c)
     return b;
 
   // This produces unnecessary clauses and variables
-  // See convert_node for where this overhead is removed
+  // See encode for where this overhead is removed
 
   return lor(land(a, b), land(neg(a), c));
 }
@@ -144,9 +269,35 @@ void aig_prop_baset::set_equal(literalt a, literalt b)
 #endif
 }
 
+aig_prop_solvert::aig_prop_solvert(propt &_solver):
+  aig_prop_constraintt(aig),
+  solver(_solver),
+  converted_nodes(0),
+  converted_constraints(0)
+{
+  // node zero would be variable zero of the solver, which isn't used
+  aig.new_var_node();
+}
+
+aig_prop_solvert::aig_prop_solvert(std::unique_ptr<propt> _solver):
+  aig_prop_constraintt(aig),
+  solver_ptr(std::move(_solver)),
+  solver(*solver_ptr),
+  converted_nodes(0),
+  converted_constraints(0)
+{
+  aig.new_var_node();
+}
+
 tvt aig_prop_solvert::l_get(literalt a) const
 {
-  return solver.l_get(a);
+  if(a.is_constant())
+    return tvt(a.is_true());
+
+  if(a.var_no()>=values.size())
+    return tvt::unknown();
+
+  return tvt(values[a.var_no()]!=a.sign());
 }
 
 propt::resultt aig_prop_solvert::prop_solve()
@@ -155,444 +306,605 @@ propt::resultt aig_prop_solvert::prop_solve()
            << aig.nodes.size() << " nodes" << eom;
   convert_aig();
 
-  return solver.prop_solve();
-}
+  statistics() << "AIG: " << strash_hits << " structural hash hits, "
+               << rewrites << " rewrites, "
+               << stats.merged_nodes << " merged nodes" << eom;
+  statistics() << "AIG: encoded " << stats.encoded_nodes << " nodes ("
+               << stats.wide_and_cuts << " wide AND cuts, "
+               << stats.function_cuts << " function cuts) into "
+               << stats.clauses << " clauses" << eom;
 
-/// Compute the phase information needed for Plaisted-Greenbaum encoding
-/// \par parameters: Two vectors of bools of size aig.nodes.size()
-/// \return These vectors filled in with per node phase information
-void aig_prop_solvert::compute_phase(
-  std::vector<bool> &n_pos,
-  std::vector<bool> &n_neg)
-{
-  std::stack<literalt> queue;
+  bvt solver_assumptions;
+  solver_assumptions.reserve(assumptions.size());
+  for(const auto &l : assumptions)
+    solver_assumptions.push_back(map(l));
+  solver.set_assumptions(solver_assumptions);
 
-  // Get phases of constraints
-  for(aig_plus_constraintst::constraintst::const_iterator
-      c_it=aig.constraints.begin();
-      c_it!=aig.constraints.end();
-      c_it++)
-    queue.push(*c_it);
+  const resultt result=solver.prop_solve();
 
-  while(!queue.empty())
-  {
-    literalt l=queue.top();
-    queue.pop();
+  if(result==resultt::P_SATISFIABLE)
+    compute_values();
 
-    if(l.is_constant())
-      continue;
+  return result;
+}
 
-    bool sign=l.sign();
-    unsigned var_no=l.var_no();
+bool aig_prop_solvert::is_in_conflict(literalt a) const
+{
+  const literalt l=map(a);
 
-    // already set?
-    if(sign?n_neg[var_no]:n_pos[var_no])
-      continue; // done already
+  if(l.is_constant())
+    return l.is_false();
 
-    // set
-    sign?n_neg[var_no]=1:n_pos[var_no]=1;
+  return solver.is_in_conflict(l);
+}
 
-    const aigt::nodet &node=aig.nodes[var_no];
+/// The values of all nodes, computed from the values the solver has assigned
+/// to the variables. Nodes that haven't been encoded, or only in one
+/// direction, may have a different value in the solver; however, the
+/// constraints hold for the computed values whenever they hold for the
+/// values of the solver.
+void aig_prop_solvert::compute_values()
+{
+  values.resize(aig.nodes.size());
+
+  for(std::size_t n=0; n<aig.nodes.size(); n++)
+  {
+    const aigt::nodet &node=aig.nodes[n];
 
-    if(node.is_and())
+    if(node.is_var())
+      values[n]=solver.l_get(literalt(n, false)).is_true();
+    else
     {
-      queue.push(node.a^sign);
-      queue.push(node.b^sign);
+      const literalt inputs[]={ node.a, node.b };
+      values[n]=true;
+
+      for(const auto &l : inputs)
+        if(l.is_constant()?l.is_false():values[l.var_no()]==l.sign())
+          values[n]=false;
     }
   }
+}
+
+namespace
+{
+// the number of 64-bit words of random simulation used for sweeping
+const std::size_t simulation_words=4;
 
-  // Count
-  unsigned pos_only=0, neg_only=0, mixed=0;
+// the limits on the support and the cone for proving equivalence
+const std::size_t max_proof_support=12;
+const std::size_t max_proof_cone=1000;
 
-  for(unsigned n=0; n<aig.nodes.size(); n++)
+typedef std::array<std::uint64_t, simulation_words> signaturet;
+
+struct signature_hasht
+{
+  std::size_t operator()(const signaturet &signature) const
   {
-    if(aig.nodes[n].is_and())
-    {
-      if(n_neg[n] && n_pos[n])
-        mixed++;
-      else if(n_pos[n])
-        pos_only++;
-      else if(n_neg[n])
-        neg_only++;
-    }
+    std::size_t result=0;
+    for(const auto &word : signature)
+      result=result*1000003+std::hash<std::uint64_t>()(word);
+    return result;
   }
+};
 
-  statistics() << "Pos only: " << pos_only << "\n"
-               << "Neg only: " << neg_only << "\n"
-               << "Mixed: " << mixed << eom;
+// the truth tables of the variables of a function with up to 6 inputs
+const std::uint64_t variable_patterns[]=
+{
+  0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+  0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+};
 }
 
-
-/// Compact encoding for single usage variable
-/// \par parameters: Two vectors of unsigned of size aig.nodes.size()
-/// \return These vectors filled in with per node usage information
-void aig_prop_solvert::usage_count(
-  std::vector<unsigned> &p_usage_count,
-  std::vector<unsigned> &n_usage_count)
+/// Merges AND nodes that haven't been passed to the solver yet with
+/// equivalent nodes. Nodes with the same signature under random simulation
+/// are candidates, which are proven equivalent by exhaustive simulation if
+/// their combined support is small enough.
+void aig_prop_solvert::sweep()
 {
-  for(aig_plus_constraintst::constraintst::const_iterator
-      c_it=aig.constraints.begin();
-      c_it!=aig.constraints.end();
-      c_it++)
+  const std::size_t nodes=aig.nodes.size();
+  std::vector<std::uint64_t> simulation(nodes*simulation_words);
+  std::unordered_map<signaturet, literalt, signature_hasht> representatives;
+  std::mt19937_64 random;
+
+  for(std::size_t n=1; n<nodes; n++)
   {
-    if(!((*c_it).is_constant()))
+    const aigt::nodet &node=aig.nodes[n];
+    std::uint64_t *words=&simulation[n*simulation_words];
+
+    for(std::size_t w=0; w<simulation_words; w++)
     {
-      if((*c_it).sign())
-      {
-        ++n_usage_count[(*c_it).var_no()];
-      }
+      if(node.is_var())
+        words[w]=random();
       else
       {
-        ++p_usage_count[(*c_it).var_no()];
+        words[w]=~std::uint64_t(0);
+
+        for(const literalt l : { map(node.a), map(node.b) })
+        {
+          if(l.is_constant())
+            words[w]&=l.is_true()?~std::uint64_t(0):0;
+          else
+            words[w]&=simulation[l.var_no()*simulation_words+w]^
+                      (l.sign()?~std::uint64_t(0):0);
+        }
       }
     }
-  }
 
-  for(unsigned n=0; n<aig.nodes.size(); n++)
-  {
-    const aigt::nodet &node=aig.nodes[n];
+    if(replacement[n]!=literalt(n, false))
+      continue;
 
-    if(node.is_and())
+    // normalize the phase, such that complemented nodes match
+    const bool phase=(words[0]&1)!=0;
+    signaturet signature;
+    bool is_zero=true;
+
+    for(std::size_t w=0; w<simulation_words; w++)
     {
-      if(node.a.sign())
-      {
-        ++n_usage_count[node.a.var_no()];
-      }
-      else
-      {
-        ++p_usage_count[node.a.var_no()];
-      }
+      signature[w]=words[w]^(phase?~std::uint64_t(0):0);
+      is_zero&=signature[w]==0;
+    }
 
-      if(node.b.sign())
-      {
-        ++n_usage_count[node.b.var_no()];
-      }
-      else
+    const literalt normalized(n, phase);
+    const bool may_replace=n>=converted_nodes && node.is_and();
+
+    if(is_zero)
+    {
+      if(may_replace && prove_equal(normalized, const_literal(false)))
       {
-        ++p_usage_count[node.b.var_no()];
+        replacement[n]=const_literal(phase);
+        stats.merged_nodes++;
       }
+
+      continue;
+    }
+
+    const auto entry=representatives.insert({ signature, normalized });
+
+    if(!entry.second &&
+       may_replace &&
+       prove_equal(normalized, entry.first->second))
+    {
+      replacement[n]=entry.first->second^phase;
+      stats.merged_nodes++;
     }
   }
+}
 
+/// \return true if \p a and \p b are known to be equivalent, which is
+///   established by simulating all assignments to their support
+bool aig_prop_solvert::prove_equal(literalt a, literalt b) const
+{
+  std::vector<literalt::var_not> cone, support, stack;
+  std::unordered_map<literalt::var_not, std::size_t> index;
 
-  #if 1
-  // Compute stats
-  unsigned unused=0;
-  unsigned usedOncePositive=0;
-  unsigned usedOnceNegative=0;
-  unsigned usedTwicePositive=0;
-  unsigned usedTwiceNegative=0;
-  unsigned usedTwiceMixed=0;
-  unsigned usedThreeTimes=0;
-  unsigned usedMore=0;
+  for(const literalt l : { a, b })
+    if(!l.is_constant())
+      stack.push_back(l.var_no());
 
-  for(unsigned n=0; n<aig.nodes.size(); n++)
+  while(!stack.empty())
   {
-    switch(p_usage_count[n] + n_usage_count[n])
+    const literalt::var_not v=stack.back();
+    stack.pop_back();
+
+    if(!index.insert({ v, 0 }).second)
+      continue;
+
+    const aigt::nodet &node=aig.nodes[v];
+
+    if(node.is_var())
     {
-    case 0: ++unused; break;
-    case 1:
-      if(p_usage_count[n]==1)
-        ++usedOncePositive;
-      else
-        ++usedOnceNegative;
-      break;
+      support.push_back(v);
+      if(support.size()>max_proof_support)
+        return false;
+    }
+    else
+    {
+      cone.push_back(v);
+      if(cone.size()>max_proof_cone)
+        return false;
 
-    case 2 :
-      if(p_usage_count[n]>=2)
-      {
-        ++usedTwicePositive;
-      }
-      else if(n_usage_count[n]>=2)
-      {
-        ++usedTwiceNegative;
-      }
-      else
-      {
-        assert(p_usage_count[n]==1 && n_usage_count[n]==1);
-        ++usedTwiceMixed;
-      }
-      break;
-    case 3: ++usedThreeTimes; break;
-    default: ++usedMore; break;
+      for(const literalt l : { map(node.a), map(node.b) })
+        if(!l.is_constant())
+          stack.push_back(l.var_no());
     }
   }
 
-  statistics() << "Unused: " << unused << " "
-               << "Used once: " << usedOncePositive + usedOnceNegative
-               << " (P: " << usedOncePositive
-               << ", N: " << usedOnceNegative << ") "
-               << "Used twice: "
-               << usedTwicePositive + usedTwiceNegative + usedTwiceMixed
-               << " (P: " << usedTwicePositive
-               << ", N: " << usedTwiceNegative
-               << ", M: " << usedTwiceMixed << ") "
-               << "Used three times: " << usedThreeTimes << " "
-               << "Used more: " << usedMore
-               << eom;
-  #endif
+  // the inputs of a node precede it
+  std::sort(cone.begin(), cone.end());
+
+  const std::size_t words=
+    support.size()<=6?1:std::size_t(1)<<(support.size()-6);
+  std::vector<std::uint64_t> simulation((support.size()+cone.size())*words);
+  std::size_t next=0;
+
+  for(std::size_t i=0; i<support.size(); i++, next++)
+  {
+    index[support[i]]=next;
+    for(std::size_t w=0; w<words; w++)
+      simulation[next*words+w]=
+        i<6?variable_patterns[i]:((w>>(i-6))&1)!=0?~std::uint64_t(0):0;
+  }
+
+  const auto word=[&](literalt l, std::size_t w)
+  {
+    if(l.is_constant())
+      return l.is_true()?~std::uint64_t(0):std::uint64_t(0);
+    return simulation[index[l.var_no()]*words+w]^
+           (l.sign()?~std::uint64_t(0):0);
+  };
+
+  for(const auto v : cone)
+  {
+    const aigt::nodet &node=aig.nodes[v];
+    const literalt node_a=map(node.a), node_b=map(node.b);
+    index[v]=next;
+
+    for(std::size_t w=0; w<words; w++)
+      simulation[next*words+w]=word(node_a, w)&word(node_b, w);
+
+    next++;
+  }
+
+  for(std::size_t w=0; w<words; w++)
+    if(word(a, w)!=word(b, w))
+      return false;
+
+  return true;
 }
 
-/// Convert one AIG node, including special handling of a couple of cases
-/// \par parameters: The node to convert, the phases required and the usage
-///   counts.
-/// \return The node converted to CNF in the solver object.
-void aig_prop_solvert::convert_node(
-  unsigned n,
-  const aigt::nodet &node,
-  bool n_pos, bool n_neg,
-  std::vector<unsigned> &p_usage_count,
-  std::vector<unsigned> &n_usage_count)
-{
-  if(p_usage_count[n]>0 || n_usage_count[n]>0)
+void aig_prop_solvert::count_fanout()
+{
+  fanout.assign(aig.nodes.size(), 0);
+
+  for(std::size_t n=0; n<aig.nodes.size(); n++)
   {
-    literalt o=literalt(n, false);
-    bvt body(2);
-    body[0]=node.a;
-    body[1]=node.b;
+    const aigt::nodet &node=aig.nodes[n];
 
-#ifdef USE_AIG_COMPACT
-    // Inline positive literals
-    // This should remove the overhead introduced by land and lor for bvt
+    if(node.is_and() && replacement[n]==literalt(n, false))
+      for(const literalt l : { map(node.a), map(node.b) })
+        if(!l.is_constant())
+          fanout[l.var_no()]++;
+  }
 
-    for(bvt::size_type i=0; i < body.size(); i++)
-    {
-      literalt l=body[i];
+  for(const auto &c : aig.constraints)
+  {
+    const literalt l=map(c);
+    if(!l.is_constant())
+      fanout[l.var_no()]++;
+  }
+}
 
-      if(!l.sign() &&                      // Used positively...
-         aig.nodes[l.var_no()].is_and() && // ... is a gate ...
-         p_usage_count[l.var_no()] == 1 && // ... only used here.
-         n_usage_count[l.var_no()] == 0)
-      {
-        const aigt::nodet &rep=aig.nodes[l.var_no()];
-        body[i]=rep.a;
-        body.push_back(rep.b);
-        --i;                         // Repeat the process
-        --p_usage_count[l.var_no()]; // Supress generation of inlined node
-      }
+/// Pass a clause to the solver. The first literal is the node that is being
+/// encoded; the others are the inputs of the cut, which need to be encoded
+/// in the direction given by their sign.
+void aig_prop_solvert::add_clause(
+  const bvt &clause,
+  std::vector<literalt> &queue)
+{
+  solver.lcnf(clause);
+  stats.clauses++;
+
+  for(std::size_t i=1; i<clause.size(); i++)
+    if(!clause[i].is_constant())
+      queue.push_back(clause[i]);
+}
+
+/// Encode node \p n, in the direction that the node implies its function if
+/// \p pos is set, and the opposite direction otherwise
+void aig_prop_solvert::encode(
+  literalt::var_not n,
+  bool pos,
+  std::vector<literalt> &queue)
+{
+  const aigt::nodet &node=aig.nodes[n];
+
+  if(!node.is_and() || (pos?encoded_pos[n]:encoded_neg[n]))
+    return;
+
+  if(!encoded_pos[n] && !encoded_neg[n])
+    stats.encoded_nodes++;
+
+  (pos?encoded_pos[n]:encoded_neg[n])=true;
+
+  if(!cut_encoding)
+  {
+    encode_wide_and(n, { map(node.a), map(node.b) }, pos, queue);
+    return;
+  }
+
+  // The wide AND cut absorbs nodes below positive edges that have no other
+  // fanout, without bound on the number of inputs. This removes the
+  // overhead of land and lor on bit vectors.
+  bvt inputs={ map(node.a), map(node.b) };
+  std::size_t wide_and_size=0;
+
+  for(std::size_t i=0; i<inputs.size(); i++)
+  {
+    const literalt l=inputs[i];
+
+    if(!l.is_constant() && !l.sign() &&
+       aig.nodes[l.var_no()].is_and() && fanout[l.var_no()]==1)
+    {
+      const aigt::nodet &input=aig.nodes[l.var_no()];
+      inputs[i]=map(input.a);
+      inputs.push_back(map(input.b));
+      wide_and_size++;
+      i--;
     }
+  }
+
+  // The function cut absorbs nodes with no other fanout below any edge, as
+  // long as there are no more than four inputs. This covers the nodes that
+  // lxor and lselect produce, as well as carries and other small functions.
+  std::vector<literalt::var_not> leaves;
+  std::size_t function_size=0;
+
+  const auto add_leaf=[](
+    std::vector<literalt::var_not> &dest, literalt l)
+  {
+    if(!l.is_constant() &&
+       std::find(dest.begin(), dest.end(), l.var_no())==dest.end())
+      dest.push_back(l.var_no());
+  };
 
-    // TODO : Could check the array for duplicates / complementary literals
-    // but this should be found by the SAT preprocessor.
-    // TODO : Likewise could find things that are constrained, esp the output
-    // and backwards constant propagate.  Again may not be worth it.
-
-    // lxor and lselect et al. are difficult to express in AIGs.
-    // Doing so introduces quite a bit of overhead.
-    // This should recognise the AIGs they produce and
-    // handle them in a more efficient way.
-
-    // Recognise something of the form:
-    //
-    //  neg(o)=lor(land(a,b), land(neg(a),c))
-    //      o =land(lneg(land(a,b)), lneg(land(neg(a),c)))
-    //
-    // Note that lxor and lselect generate the negation of this
-    // but will still be recognised because the negation is
-    // recorded where it is used
-
-    if(body.size() == 2 && body[0].sign() && body[1].sign())
+  add_leaf(leaves, map(node.a));
+  add_leaf(leaves, map(node.b));
+
+  for(bool progress=true; progress; )
+  {
+    progress=false;
+
+    for(std::size_t i=0; i<leaves.size() && !progress; i++)
     {
-      const aigt::nodet &left=aig.nodes[body[0].var_no()];
-      const aigt::nodet &right=aig.nodes[body[1].var_no()];
+      const aigt::nodet &leaf=aig.nodes[leaves[i]];
+
+      if(!leaf.is_and() || fanout[leaves[i]]!=1)
+        continue;
 
-      if(left.is_and() && right.is_and())
+      std::vector<literalt::var_not> expanded(leaves);
+      expanded.erase(expanded.begin()+i);
+      add_leaf(expanded, map(leaf.a));
+      add_leaf(expanded, map(leaf.b));
+
+      if(expanded.size()<=4)
       {
-        if(left.a==neg(right.a))
-        {
-          if(p_usage_count[body[0].var_no()]==0 &&
-             n_usage_count[body[0].var_no()]==1 &&
-             p_usage_count[body[1].var_no()]==0 &&
-             n_usage_count[body[1].var_no()]==1)
-          {
-            bvt lits(3);
-
-            if(n_neg)
-            {
-              lits[0]=left.a;
-              lits[1]=right.b;
-              lits[2]=o;
-              solver.lcnf(lits);
-
-              lits[0]=neg(left.a);
-              lits[1]=left.b;
-              lits[2]=o;
-              solver.lcnf(lits);
-            }
-
-            if(n_pos)
-            {
-              lits[0]=left.a;
-              lits[1]=neg(right.b);
-              lits[2]=neg(o);
-              solver.lcnf(lits);
-
-              lits[0]=neg(left.a);
-              lits[1]=neg(left.b);
-              lits[2]=neg(o);
-              solver.lcnf(lits);
-            }
-
-            // Supress generation
-            --n_usage_count[body[0].var_no()];
-            --n_usage_count[body[1].var_no()];
-
-            return;
-          }
-        }
+        leaves.swap(expanded);
+        function_size++;
+        progress=true;
       }
     }
+  }
 
+  if(function_size>wide_and_size)
+  {
+    stats.function_cuts++;
+    encode_function(n, leaves, pos, queue);
+  }
+  else
+  {
+    stats.wide_and_cuts++;
+    encode_wide_and(n, inputs, pos, queue);
+  }
+}
 
-    // Likewise, carry has an improved encoding which is generated
-    // by the CNF encoding
-    if(body.size() == 3 && body[0].sign() && body[1].sign() && body[2].sign())
-    {
-      const aigt::nodet &left=aig.nodes[body[0].var_no()];
-      const aigt::nodet &mid=aig.nodes[body[1].var_no()];
-      const aigt::nodet &right=aig.nodes[body[2].var_no()];
+void aig_prop_solvert::encode_wide_and(
+  literalt::var_not n,
+  const bvt &inputs,
+  bool pos,
+  std::vector<literalt> &queue)
+{
+  const literalt o(n, false);
 
-      if(left.is_and() && mid.is_and() && right.is_and())
-      {
-        if(p_usage_count[body[0].var_no()]==0 &&
-           n_usage_count[body[0].var_no()]==1 &&
-           p_usage_count[body[1].var_no()]==0 &&
-           n_usage_count[body[1].var_no()]==1 &&
-           p_usage_count[body[2].var_no()]==0 &&
-           n_usage_count[body[2].var_no()]==1)
-        {
-          literalt a=left.a;
-          literalt b=left.b;
-          literalt c=mid.a;
+  if(pos)
+  {
+    for(const auto &l : inputs)
+    {
+      if(l.is_true())
+        continue;
 
-          if(a==right.b && b==mid.b && c==right.a)
-          {
-            // A (negative) carry -- 1 if at most one input is 1
-            bvt lits(3);
-
-            if(n_neg)
-            {
-              lits[0]=a;
-              lits[1]=b;
-              lits[2]=o;
-              solver.lcnf(lits);
-
-              lits[0]=a;
-              lits[1]=c;
-              lits[2]=o;
-              solver.lcnf(lits);
-
-              lits[0]=b;
-              lits[1]=c;
-              lits[2]=o;
-              solver.lcnf(lits);
-            }
-
-            if(n_pos)
-            {
-              lits[0]=neg(a);
-              lits[1]=neg(b);
-              lits[2]=neg(o);
-              solver.lcnf(lits);
-
-              lits[0]=neg(a);
-              lits[1]=neg(c);
-              lits[2]=neg(o);
-              solver.lcnf(lits);
-
-              lits[0]=neg(b);
-              lits[1]=neg(c);
-              lits[2]=neg(o);
-              solver.lcnf(lits);
-            }
-
-            // Supress generation
-            --n_usage_count[body[0].var_no()];
-            --n_usage_count[body[1].var_no()];
-            --n_usage_count[body[2].var_no()];
-
-            return;
-          }
-        }
-      }
+      add_clause({ neg(o), l }, queue);
     }
+  }
+  else
+  {
+    bvt clause={ o };
 
-    // TODO : these special cases are fragile and could be improved.
-    // They don't handle cases where the construction is partially constant
-    // folded.  Also the usage constraints are sufficient for improvement
-    // but reductions may still be possible with looser restrictions.
-#endif
-
-    if(n_pos)
+    for(const auto &l : inputs)
     {
-      bvt lits(2);
-      lits[1]=neg(o);
+      if(l.is_false())
+        return;
 
-      forall_literals(it, body)
-      {
-        lits[0]=pos(*it);
-        solver.lcnf(lits);
-      }
+      if(!l.is_true())
+        clause.push_back(neg(l));
     }
 
-    if(n_neg)
+    add_clause(clause, queue);
+  }
+}
+
+namespace
+{
+// a conjunction of the inputs of a function with up to four inputs
+struct cubet
+{
+  unsigned pos, neg;
+};
+
+const unsigned truth_table_mask=0xFFFF;
+
+unsigned cofactor(unsigned table, unsigned var, bool value)
+{
+  const unsigned mask=variable_patterns[var]&truth_table_mask;
+  const unsigned shift=1u<<var;
+
+  if(value)
+  {
+    const unsigned t=table&mask;
+    return t|(t>>shift);
+  }
+  else
+  {
+    const unsigned t=table&~mask&truth_table_mask;
+    return (t|(t<<shift))&truth_table_mask;
+  }
+}
+
+/// Irredundant sum-of-products of a function between \p lower and \p upper
+/// over the first \p vars inputs, following Minato and Morreale
+/// \return the function of the cover that is added to \p cover
+unsigned isop(
+  unsigned lower,
+  unsigned upper,
+  unsigned vars,
+  std::vector<cubet> &cover)
+{
+  if(lower==0)
+    return 0;
+
+  if(upper==truth_table_mask)
+  {
+    cover.push_back({ 0, 0 });
+    return truth_table_mask;
+  }
+
+  unsigned var=vars;
+  while(var>0)
+  {
+    var--;
+    if(cofactor(lower, var, false)!=cofactor(lower, var, true) ||
+       cofactor(upper, var, false)!=cofactor(upper, var, true))
+      break;
+  }
+
+  const unsigned lower0=cofactor(lower, var, false);
+  const unsigned lower1=cofactor(lower, var, true);
+  const unsigned upper0=cofactor(upper, var, false);
+  const unsigned upper1=cofactor(upper, var, true);
+
+  const std::size_t start0=cover.size();
+  const unsigned result0=isop(lower0&~upper1, upper0, var, cover);
+  for(std::size_t i=start0; i<cover.size(); i++)
+    cover[i].neg|=1u<<var;
+
+  const std::size_t start1=cover.size();
+  const unsigned result1=isop(lower1&~upper0, upper1, var, cover);
+  for(std::size_t i=start1; i<cover.size(); i++)
+    cover[i].pos|=1u<<var;
+
+  const unsigned result_both=isop(
+    (lower0&~result0)|(lower1&~result1), upper0&upper1, var, cover);
+
+  const unsigned mask=variable_patterns[var]&truth_table_mask;
+
+  return (result0&~mask)|(result1&mask)|result_both;
+}
+}
+
+void aig_prop_solvert::encode_function(
+  literalt::var_not n,
+  const std::vector<literalt::var_not> &leaves,
+  bool pos,
+  std::vector<literalt> &queue)
+{
+  // the truth table of the node over the leaves
+  std::function<unsigned(literalt)> table=[&](literalt l) -> unsigned
+  {
+    if(l.is_constant())
+      return l.is_true()?truth_table_mask:0;
+
+    unsigned result;
+    const auto leaf=std::find(leaves.begin(), leaves.end(), l.var_no());
+
+    if(leaf!=leaves.end())
+      result=variable_patterns[leaf-leaves.begin()]&truth_table_mask;
+    else
     {
-      bvt lits;
+      const aigt::nodet &node=aig.nodes[l.var_no()];
+      result=table(map(node.a))&table(map(node.b));
+    }
+
+    return l.sign()?~result&truth_table_mask:result;
+  };
 
-      forall_literals(it, body)
-        lits.push_back(neg(*it));
+  const literalt o(n, false);
+  const aigt::nodet &node=aig.nodes[n];
+  const unsigned function=table(map(node.a))&table(map(node.b));
 
-      lits.push_back(pos(o));
-      solver.lcnf(lits);
+  // The clauses for the node implying the function are the negated cubes of
+  // the cover of the negated function, and vice versa.
+  const unsigned covered=pos?~function&truth_table_mask:function;
+  std::vector<cubet> cover;
+  isop(covered, covered, leaves.size(), cover);
+
+  for(const auto &cube : cover)
+  {
+    bvt clause={ pos?neg(o):o };
+
+    for(std::size_t i=0; i<leaves.size(); i++)
+    {
+      if(cube.pos&(1u<<i))
+        clause.push_back(literalt(leaves[i], true));
+      if(cube.neg&(1u<<i))
+        clause.push_back(literalt(leaves[i], false));
     }
+
+    add_clause(clause, queue);
   }
 }
 
 void aig_prop_solvert::convert_aig()
 {
+  const std::size_t nodes=aig.nodes.size();
+
   // 1. Do variables
-  while(solver.no_variables()<=aig.nodes.size())
+  while(solver.no_variables()<=nodes)
     solver.new_variable();
 
-  // Usage count for inlining
+  for(std::size_t n=replacement.size(); n<nodes; n++)
+    replacement.push_back(literalt(n, false));
 
-  std::vector<unsigned> p_usage_count;
-  std::vector<unsigned> n_usage_count;
-  p_usage_count.resize(aig.nodes.size(), 0);
-  n_usage_count.resize(aig.nodes.size(), 0);
+  encoded_pos.resize(nodes, false);
+  encoded_neg.resize(nodes, false);
 
-  this->usage_count(p_usage_count, n_usage_count);
+  // 2. Merge equivalent nodes
+  if(sweeping)
+    sweep();
 
+  count_fanout();
 
-  #ifdef USE_PG
-  // Get phases
-  std::vector<bool> n_pos, n_neg;
-  n_pos.resize(aig.nodes.size(), false);
-  n_neg.resize(aig.nodes.size(), false);
+  // 3. Do constraints, and the nodes that they need
+  std::vector<literalt> queue;
+
+  for(std::size_t c=converted_constraints; c<aig.constraints.size(); c++)
+  {
+    const literalt l=map(aig.constraints[c]);
+    solver.l_set_to(l, true);
 
-  this->compute_phase(n_pos, n_neg);
-  #endif
+    if(!l.is_constant())
+      queue.push_back(l);
+  }
 
-  // 2. Do nodes
-  for(std::size_t n=aig.nodes.size() - 1; n!=0; n--)
+  // 4. Do the nodes that are assumed, in both directions, such that their
+  // value in the solver is their function, whatever sign they are assumed
+  // with, and conflicts on them refer to that function
+  for(const auto &a : assumptions)
   {
-    if(aig.nodes[n].is_and())
+    const literalt l=map(a);
+
+    if(!l.is_constant())
     {
-#ifdef USE_PG
-      convert_node(
-        n, aig.nodes[n], n_pos[n], n_neg[n], p_usage_count, n_usage_count);
-#else
-      convert_node(n, aig.nodes[n], true, true, p_usage_count, n_usage_count);
-#endif
+      queue.push_back(l);
+      queue.push_back(!l);
     }
   }
-  // Skip zero as it is not used or a valid literal
 
+  while(!queue.empty())
+  {
+    const literalt l=queue.back();
+    queue.pop_back();
+    encode(l.var_no(), !l.sign(), queue);
+  }
 
-  // 3. Do constraints
-  for(const auto &c_it : aig.constraints)
-    solver.l_set_to(c_it, true);
-
-  // HACK!
-  aig.nodes.clear();
+  converted_nodes=nodes;
+  converted_constraints=aig.constraints.size();
 }
@@ -11,6 +11,9 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_SOLVERS_PROP_AIG_PROP_H
 
 #include <cassert>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 
 #include <util/threeval.h>
 #include <solvers/prop/prop.h>
@@ -60,8 +63,26 @@ public:
   resultt prop_solve() override
   { assert(0); return resultt::P_ERROR; }
 
+  // whether to simplify AND nodes by two-level rewriting as they are built
+  bool rewriting=false;
+
+  // number of AND nodes that were found in the structural hash table or
+  // that were simplified by two-level rewriting, respectively
+  std::size_t strash_hits=0;
+  std::size_t rewrites=0;
+
 protected:
   aigt &dest;
+
+  // structural hashing: the AND nodes by their (ordered) inputs
+  std::unordered_map<std::uint64_t, literalt> and_nodes;
+
+  bool is_and(literalt l) const
+  {
+    return !l.is_constant() && dest.get_node(l).is_and();
+  }
+
+  bool rewrite_and(literalt a, literalt b, literalt &result);
 };
 
 class aig_prop_constraintt:public aig_prop_baset
@@ -87,14 +108,30 @@ public:
   }
 };
 
+/// \brief Builds an AIG and passes it to another solver when solving
+///
+/// The AIG is structurally hashed as it is built, and each AND node that is
+/// needed is encoded into CNF on its own, using the Plaisted-Greenbaum
+/// encoding. optimize() enables the following, which have not been
+/// measured for their effect on SAT run times yet:
+/// - AND nodes are locally rewritten as they are built;
+/// - before solving, AND nodes are merged with functionally equivalent ones
+///   (sweeping), where candidates are found by random simulation and proven
+///   by exhaustive simulation of their support;
+/// - the remaining nodes are encoded into CNF by cuts: each node that is
+///   needed is encoded together with the single-fanout nodes below it,
+///   either as a wide AND or by the irredundant sum-of-products of a
+///   function of up to four inputs.
+///
+/// Nodes and constraints that are added after solving are converted
+/// incrementally. The value of a node is computed from the values of the
+/// variables in the model of the solver. Assumptions are passed on to the
+/// solver, with the nodes they refer to encoded in both directions.
 class aig_prop_solvert:public aig_prop_constraintt
 {
 public:
-  explicit aig_prop_solvert(propt &_solver):
-    aig_prop_constraintt(aig),
-    solver(_solver)
-  {
-  }
+  explicit aig_prop_solvert(propt &_solver);
+  explicit aig_prop_solvert(std::unique_ptr<propt> _solver);
 
   aig_plus_constraintst aig;
 
@@ -108,26 +145,101 @@ public:
   tvt l_get(literalt a) const override;
   resultt prop_solve() override;
 
+  void set_assumptions(const bvt &_assumptions) override
+  {
+    assumptions=_assumptions;
+  }
+  bool has_set_assumptions() const override
+  {
+    return solver.has_set_assumptions();
+  }
+  bool is_in_conflict(literalt a) const override;
+  bool has_is_in_conflict() const override
+  {
+    return solver.has_is_in_conflict();
+  }
+
   void set_message_handler(message_handlert &m) override
   {
     aig_prop_constraintt::set_message_handler(m);
     solver.set_message_handler(m);
   }
 
+  void set_time_limit_seconds(uint32_t lim) override
+  {
+    solver.set_time_limit_seconds(lim);
+  }
+
+  // whether to merge equivalent nodes before encoding
+  bool sweeping=false;
+  // whether to encode nodes together with their single-fanout cones
+  bool cut_encoding=false;
+
+  void optimize()
+  {
+    rewriting=true;
+    sweeping=true;
+    cut_encoding=true;
+  }
+
+  struct statisticst
+  {
+    std::size_t merged_nodes=0;
+    std::size_t encoded_nodes=0;
+    std::size_t wide_and_cuts=0;
+    std::size_t function_cuts=0;
+    std::size_t clauses=0;
+  };
+
+  const statisticst &get_statistics() const
+  {
+    return stats;
+  }
+
 protected:
+  std::unique_ptr<propt> solver_ptr;
   propt &solver;
 
+  bvt assumptions;
+
+  // nodes and constraints below these have been passed to the solver
+  std::size_t converted_nodes;
+  std::size_t converted_constraints;
+
+  // the literal that replaces a node after sweeping
+  std::vector<literalt> replacement;
+  // the number of fanouts of a node after sweeping
+  std::vector<unsigned> fanout;
+  // the directions of the Plaisted-Greenbaum encoding that a node has been
+  // encoded with: output implies function, function implies output
+  std::vector<bool> encoded_pos, encoded_neg;
+  // the values of the nodes in the last model
+  std::vector<bool> values;
+
+  statisticst stats;
+
+  literalt map(literalt l) const
+  {
+    return l.is_constant()?l:replacement[l.var_no()]^l.sign();
+  }
+
   void convert_aig();
-  void usage_count(
-    std::vector<unsigned> &p_usage_count, std::vector<unsigned> &n_usage_count);
-  void compute_phase(std::vector<bool> &n_pos, std::vector<bool> &n_neg);
-  void convert_node(
-    unsigned n,
-    const aigt::nodet &node,
-    bool n_pos,
-    bool n_neg,
-    std::vector<unsigned> &p_usage_count,
-    std::vector<unsigned> &n_usage_count);
+  void sweep();
+  bool prove_equal(literalt a, literalt b) const;
+  void count_fanout();
+  void encode(literalt::var_not n, bool pos, std::vector<literalt> &queue);
+  void encode_wide_and(
+    literalt::var_not n,
+    const bvt &inputs,
+    bool pos,
+    std::vector<literalt> &queue);
+  void encode_function(
+    literalt::var_not n,
+    const std::vector<literalt::var_not> &leaves,
+    bool pos,
+    std::vector<literalt> &queue);
+  void add_clause(const bvt &clause, std::vector<literalt> &queue);
+  void compute_values();
 };
 
 #endif // CPROVER_SOLVERS_PROP_AIG_PROP_H
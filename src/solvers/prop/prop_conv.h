@@ -112,12 +112,26 @@ public:
 
   virtual void clear_cache() { cache.clear();}
 
+  /// Post-processing (e.g., adding array constraints) happens before the
+  /// first call to dec_solve(). Have it done again before the next call, as
+  /// required when constraints have been added incrementally. Post-processing
+  /// must then add only constraints that are valid on their own, and should
+  /// not add the constraints of earlier rounds again.
+  virtual void redo_post_processing() { post_processing_done=false; }
+
   typedef std::map<irep_idt, literalt> symbolst;
   typedef std::unordered_map<exprt, literalt, irep_hash> cachet;
 
   const cachet &get_cache() const { return cache; }
   const symbolst &get_symbols() const { return symbols; }
 
+  // the number of variables of the propositional solver, including the
+  // unused variable zero
+  std::size_t get_number_of_solver_variables() const
+  {
+    return prop.no_variables();
+  }
+
   void set_time_limit_seconds(uint32_t lim) override
   {
     prop.set_time_limit_seconds(lim);
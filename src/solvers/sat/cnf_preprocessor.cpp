@@ -0,0 +1,832 @@
+/*******************************************************************\
+
+Module: CNF Preprocessing
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// CNF Preprocessing
+
+#include "cnf_preprocessor.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <util/invariant.h>
+
+void cnf_preprocessort::freeze(literalt l)
+{
+  if(l.is_constant())
+    return;
+
+  if(frozen.size()<=l.var_no())
+    frozen.resize(l.var_no()+1, false);
+
+  frozen[l.var_no()]=true;
+}
+
+void cnf_preprocessort::resize(std::size_t no_variables)
+{
+  status.resize(no_variables, statust::ACTIVE);
+  frozen.resize(no_variables, false);
+  value.resize(no_variables, false);
+  representative.resize(no_variables);
+  removed.resize(no_variables);
+  restored.resize(no_variables, false);
+  occurs.resize(2*no_variables);
+}
+
+bool cnf_preprocessort::contains(const bvt &clause, literalt l)
+{
+  return std::binary_search(clause.begin(), clause.end(), l);
+}
+
+/// Sort \p clause and remove duplicate literals
+/// \return true iff the clause is a tautology
+bool cnf_preprocessort::normalize(bvt &clause)
+{
+  std::sort(clause.begin(), clause.end());
+  clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+  // l and !l differ in the least significant bit only
+  for(std::size_t i=1; i<clause.size(); i++)
+    if(clause[i]==!clause[i-1])
+      return true;
+
+  return false;
+}
+
+std::size_t cnf_preprocessort::add_clause(bvt clause)
+{
+  const std::size_t index=clauses.size();
+
+  for(const auto &l : clause)
+    occurs[l.get()].push_back(index);
+
+  if(clause.size()==1)
+    units.push_back(index);
+  else if(clause.empty())
+    inconsistent=true;
+
+  clauses.push_back(std::move(clause));
+  deleted.push_back(false);
+
+  return index;
+}
+
+void cnf_preprocessort::delete_clause(std::size_t index)
+{
+  deleted[index]=true;
+}
+
+/// The clauses that contain \p l, after dropping any stale entries
+const std::vector<std::size_t> &cnf_preprocessort::occurrences(literalt l)
+{
+  std::vector<std::size_t> &result=occurs[l.get()];
+
+  result.erase(
+    std::remove_if(
+      result.begin(),
+      result.end(),
+      [this, l](std::size_t index)
+      {
+        return deleted[index] || !contains(clauses[index], l);
+      }),
+    result.end());
+
+  return result;
+}
+
+bool cnf_preprocessort::propagate()
+{
+  bool changed=false;
+
+  while(!units.empty() && !inconsistent)
+  {
+    const std::size_t index=units.back();
+    units.pop_back();
+
+    if(deleted[index] || clauses[index].size()!=1)
+      continue;
+
+    const literalt l=clauses[index].front();
+    const literalt::var_not v=l.var_no();
+
+    status[v]=statust::FIXED;
+    value[v]=!l.sign();
+    statistics.units++;
+    changed=true;
+
+    for(const auto i : occurrences(l))
+      delete_clause(i);
+
+    for(const auto i : occurrences(!l))
+    {
+      bvt &clause=clauses[i];
+      clause.erase(std::find(clause.begin(), clause.end(), !l));
+
+      if(clause.empty())
+        inconsistent=true;
+      else if(clause.size()==1)
+        units.push_back(i);
+    }
+
+    occurs[l.get()].clear();
+    occurs[(!l).get()].clear();
+  }
+
+  return changed;
+}
+
+bool cnf_preprocessort::substitute_equivalences()
+{
+  const std::size_t nodes=occurs.size();
+  const unsigned unvisited=std::numeric_limits<unsigned>::max();
+
+  // the binary implication graph, by literalt::get()
+  std::vector<std::vector<unsigned>> successors(nodes);
+
+  for(std::size_t i=0; i<clauses.size(); i++)
+    if(!deleted[i] && clauses[i].size()==2)
+    {
+      const literalt a=clauses[i][0], b=clauses[i][1];
+      successors[(!a).get()].push_back(b.get());
+      successors[(!b).get()].push_back(a.get());
+    }
+
+  // Tarjan's algorithm, without recursion
+  std::vector<unsigned> index(nodes, unvisited), low(nodes, 0);
+  std::vector<unsigned> component(nodes, unvisited);
+  std::vector<unsigned> scc_stack;
+  std::vector<bool> on_stack(nodes, false);
+  std::vector<std::pair<unsigned, std::size_t>> call_stack;
+  unsigned counter=0, components=0;
+  std::vector<std::size_t> component_size;
+
+  for(unsigned root=0; root<nodes; root++)
+  {
+    if(index[root]!=unvisited || successors[root].empty())
+      continue;
+
+    index[root]=low[root]=counter++;
+    scc_stack.push_back(root);
+    on_stack[root]=true;
+    call_stack.push_back(std::make_pair(root, 0));
+
+    while(!call_stack.empty())
+    {
+      const unsigned node=call_stack.back().first;
+      std::size_t &edge=call_stack.back().second;
+
+      if(edge<successors[node].size())
+      {
+        const unsigned succ=successors[node][edge++];
+
+        if(index[succ]==unvisited)
+        {
+          index[succ]=low[succ]=counter++;
+          scc_stack.push_back(succ);
+          on_stack[succ]=true;
+          call_stack.push_back(std::make_pair(succ, 0));
+        }
+        else if(on_stack[succ])
+          low[node]=std::min(low[node], index[succ]);
+      }
+      else
+      {
+        if(low[node]==index[node])
+        {
+          std::size_t size=0;
+          unsigned member;
+          do
+          {
+            member=scc_stack.back();
+            scc_stack.pop_back();
+            on_stack[member]=false;
+            component[member]=components;
+            size++;
+          }
+          while(member!=node);
+
+          component_size.push_back(size);
+          components++;
+        }
+
+        call_stack.pop_back();
+
+        if(!call_stack.empty())
+        {
+          const unsigned parent=call_stack.back().first;
+          low[parent]=std::min(low[parent], low[node]);
+        }
+      }
+    }
+  }
+
+  // choose a representative per component, preferring frozen variables,
+  // and the negated one for the complementary component
+  std::vector<literalt> component_representative(components);
+  std::vector<bool> has_representative(components, false);
+
+  for(unsigned node=2; node<nodes; node++)
+  {
+    const unsigned c=component[node];
+    if(c==unvisited || component_size[c]==1)
+      continue;
+
+    if(component[node^1]==c)
+    {
+      // l <=> !l
+      inconsistent=true;
+      return false;
+    }
+
+    literalt l;
+    l.set(node>>1, node&1);
+
+    if(!has_representative[c] ||
+       (is_frozen(l.var_no()) &&
+        !is_frozen(component_representative[c].var_no())))
+    {
+      component_representative[c]=l;
+      has_representative[c]=true;
+      component_representative[component[node^1]]=!l;
+      has_representative[component[node^1]]=true;
+    }
+  }
+
+  bool changed=false;
+
+  for(literalt::var_not v=1; v<status.size(); v++)
+  {
+    const literalt l(v, false);
+    const unsigned c=component[l.get()];
+
+    if(c==unvisited || component_size[c]==1 ||
+       status[v]!=statust::ACTIVE || is_frozen(v))
+      continue;
+
+    const literalt r=component_representative[c];
+    if(r.var_no()==v)
+      continue;
+
+    status[v]=statust::SUBSTITUTED;
+    representative[v]=r;
+    statistics.equivalences++;
+    changed=true;
+
+    extension_stack.push_back({l, {l, !r}});
+    extension_stack.push_back({!l, {!l, r}});
+  }
+
+  if(!changed)
+    return false;
+
+  // rewrite all clauses
+  std::vector<bvt> old_clauses;
+  old_clauses.swap(clauses);
+  std::vector<bool> old_deleted;
+  old_deleted.swap(deleted);
+
+  for(auto &o : occurs)
+    o.clear();
+  units.clear();
+
+  for(std::size_t i=0; i<old_clauses.size(); i++)
+  {
+    if(old_deleted[i])
+      continue;
+
+    bvt clause;
+    clause.reserve(old_clauses[i].size());
+    for(const auto &l : old_clauses[i])
+      clause.push_back(map_literal(l));
+
+    if(!normalize(clause))
+      add_clause(std::move(clause));
+  }
+
+  return true;
+}
+
+bool cnf_preprocessort::eliminate_blocked_clauses()
+{
+  bool changed=false;
+
+  for(std::size_t i=0; i<clauses.size(); i++)
+  {
+    if(deleted[i])
+      continue;
+
+    const bvt &clause=clauses[i];
+
+    for(const auto &l : clause)
+    {
+      const literalt::var_not v=l.var_no();
+
+      if(is_frozen(v) || status[v]!=statust::ACTIVE)
+        continue;
+
+      const std::vector<std::size_t> &resolve_with=occurrences(!l);
+
+      if(resolve_with.size()>max_occurrences)
+        continue;
+
+      // all resolvents on l must be tautologies
+      const bool blocked=std::all_of(
+        resolve_with.begin(),
+        resolve_with.end(),
+        [this, &clause, l](std::size_t j)
+        {
+          for(const auto &m : clause)
+            if(m!=l && contains(clauses[j], !m))
+              return true;
+          return false;
+        });
+
+      if(blocked)
+      {
+        removed[v].push_back(clause);
+        extension_stack.push_back({l, clause});
+        delete_clause(i);
+        statistics.blocked_clauses++;
+        changed=true;
+        break;
+      }
+    }
+  }
+
+  return changed;
+}
+
+bool cnf_preprocessort::eliminate_variable(literalt::var_not v)
+{
+  const literalt p(v, false);
+  const std::vector<std::size_t> pos=occurrences(p);
+  const std::vector<std::size_t> neg=occurrences(!p);
+
+  if(pos.size()>max_occurrences || neg.size()>max_occurrences ||
+     (pos.empty() && neg.empty()))
+    return false;
+
+  // eliminate if this doesn't increase the number of clauses
+  std::vector<bvt> resolvents;
+
+  for(const auto i : pos)
+    for(const auto j : neg)
+    {
+      bvt resolvent;
+      resolvent.reserve(clauses[i].size()+clauses[j].size()-2);
+
+      for(const auto &l : clauses[i])
+        if(l!=p)
+          resolvent.push_back(l);
+      for(const auto &l : clauses[j])
+        if(l!=!p)
+          resolvent.push_back(l);
+
+      if(normalize(resolvent))
+        continue;
+
+      if(resolvent.size()>max_resolvent_size ||
+         resolvents.size()>=pos.size()+neg.size())
+        return false;
+
+      resolvents.push_back(std::move(resolvent));
+    }
+
+  // The clauses with the less frequent literal w go onto the extension
+  // stack, preceded by !w: once w is made true to satisfy one of these,
+  // all resolvents on w are satisfied by the remaining literals of the
+  // clauses with !w.
+  const bool pos_smaller=pos.size()<=neg.size();
+  const literalt witness=pos_smaller?p:!p;
+
+  for(const auto i : pos_smaller?pos:neg)
+    extension_stack.push_back({witness, clauses[i]});
+  extension_stack.push_back({!witness, {!witness}});
+
+  for(const auto i : pos)
+  {
+    removed[v].push_back(clauses[i]);
+    delete_clause(i);
+  }
+
+  for(const auto i : neg)
+  {
+    removed[v].push_back(clauses[i]);
+    delete_clause(i);
+  }
+
+  for(auto &resolvent : resolvents)
+    add_clause(std::move(resolvent));
+
+  occurs[p.get()].clear();
+  occurs[(!p).get()].clear();
+
+  status[v]=statust::ELIMINATED;
+  statistics.eliminated_variables++;
+
+  return true;
+}
+
+bool cnf_preprocessort::eliminate_variables()
+{
+  // cheapest first
+  std::vector<std::pair<std::size_t, literalt::var_not>> candidates;
+
+  for(literalt::var_not v=1; v<status.size(); v++)
+  {
+    if(is_frozen(v) || status[v]!=statust::ACTIVE)
+      continue;
+
+    const literalt p(v, false);
+    const std::size_t pos=occurrences(p).size();
+    const std::size_t neg=occurrences(!p).size();
+
+    if(pos+neg!=0 && pos<=max_occurrences && neg<=max_occurrences)
+      candidates.push_back(std::make_pair(pos*neg, v));
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+
+  bool changed=false;
+
+  for(const auto &candidate : candidates)
+  {
+    if(inconsistent)
+      break;
+
+    if(eliminate_variable(candidate.second))
+      changed=true;
+  }
+
+  return changed;
+}
+
+std::size_t cnf_preprocessort::count_variables(
+  const cnf_clause_listt::clausest &clause_list) const
+{
+  std::vector<bool> seen(status.size(), false);
+  std::size_t count=0;
+
+  for(const auto &clause : clause_list)
+    for(const auto &l : clause)
+      if(!seen[l.var_no()])
+      {
+        seen[l.var_no()]=true;
+        count++;
+      }
+
+  return count;
+}
+
+bool cnf_preprocessort::simplify(
+  cnf_clause_listt::clausest &clause_list,
+  std::size_t no_variables)
+{
+  resize(no_variables);
+  inconsistent=false;
+
+  statistics.clauses_before+=clause_list.size();
+  statistics.variables_before+=count_variables(clause_list);
+
+  for(const auto &c : clause_list)
+  {
+    bvt clause;
+    clause.reserve(c.size());
+    for(const auto &l : c)
+      clause.push_back(map_literal(l));
+
+    if(!normalize(clause))
+      add_clause(std::move(clause));
+  }
+
+  clause_list.clear();
+
+  for(unsigned round=0; round<3 && !inconsistent; round++)
+  {
+    bool changed=propagate();
+    if(!inconsistent)
+      changed|=substitute_equivalences();
+    if(!inconsistent)
+      changed|=propagate();
+    if(!inconsistent)
+      changed|=eliminate_blocked_clauses();
+    if(!inconsistent)
+      changed|=eliminate_variables();
+
+    if(!changed)
+      break;
+  }
+
+  if(!inconsistent)
+    propagate();
+
+  if(inconsistent)
+    clause_list.push_back(bvt());
+  else
+  {
+    for(std::size_t i=0; i<clauses.size(); i++)
+      if(!deleted[i])
+        clause_list.push_back(std::move(clauses[i]));
+  }
+
+  statistics.clauses_after+=clause_list.size();
+  statistics.variables_after+=count_variables(clause_list);
+
+  clauses.clear();
+  deleted.clear();
+  units.clear();
+  for(auto &o : occurs)
+    o.clear();
+
+  return !inconsistent;
+}
+
+literalt cnf_preprocessort::map_literal(literalt l) const
+{
+  while(!l.is_constant() && l.var_no()<status.size())
+  {
+    const literalt::var_not v=l.var_no();
+
+    if(status[v]==statust::FIXED)
+      return const_literal(value[v]^l.sign());
+    else if(status[v]==statust::SUBSTITUTED)
+      l=representative[v]^l.sign();
+    else
+      break;
+  }
+
+  return l;
+}
+
+void cnf_preprocessort::restore(literalt::var_not v, std::vector<bvt> &dest)
+{
+  if(v>=removed.size())
+    return;
+
+  dest.insert(dest.end(), removed[v].begin(), removed[v].end());
+  removed[v].clear();
+  restored[v]=true;
+
+  if(status[v]==statust::ELIMINATED)
+    status[v]=statust::ACTIVE;
+}
+
+void cnf_preprocessort::extend_model(std::vector<tvt> &assignment) const
+{
+  if(assignment.size()<status.size())
+    assignment.resize(status.size());
+
+  for(literalt::var_not v=1; v<status.size(); v++)
+  {
+    if(status[v]==statust::FIXED)
+      assignment[v]=tvt(value[v]);
+    else if(assignment[v].is_unknown())
+      assignment[v]=tvt(false);
+  }
+
+  for(auto it=extension_stack.rbegin(); it!=extension_stack.rend(); it++)
+  {
+    const literalt::var_not v=it->witness.var_no();
+
+    // the solver takes care of restored clauses, but substituted variables
+    // still need to be given the value of their representative
+    if(restored[v] && status[v]!=statust::SUBSTITUTED)
+      continue;
+
+    const bool satisfied=std::any_of(
+      it->clause.begin(),
+      it->clause.end(),
+      [&assignment](literalt l)
+      {
+        return assignment[l.var_no()].is_true()!=l.sign();
+      });
+
+    if(!satisfied)
+      assignment[v]=tvt(!it->witness.sign());
+  }
+}
+
+cnf_preprocessing_solvert::cnf_preprocessing_solvert(
+  std::unique_ptr<cnft> _solver):
+  solver(std::move(_solver)),
+  preprocessed(false),
+  inconsistent(false)
+{
+  PRECONDITION(solver);
+}
+
+const std::string cnf_preprocessing_solvert::solver_text()
+{
+  return "CNF preprocessing, followed by "+solver->solver_text();
+}
+
+void cnf_preprocessing_solvert::lcnf(const bvt &bv)
+{
+  if(!preprocessed)
+  {
+    cnf_clause_listt::lcnf(bv);
+    return;
+  }
+
+  bvt new_bv;
+
+  if(process_clause(bv, new_bv))
+    return;
+
+  add_to_solver(new_bv);
+  add_pending();
+}
+
+/// Map the literal to the solver's, restoring any clauses the solver needs
+/// to know about to give the variable its original meaning
+literalt cnf_preprocessing_solvert::map_literal(literalt l)
+{
+  if(l.is_constant())
+    return l;
+
+  const literalt mapped=preprocessor.map_literal(l);
+
+  if(preprocessor.needs_restore(l.var_no()))
+    preprocessor.restore(l.var_no(), pending);
+
+  if(!mapped.is_constant() && preprocessor.needs_restore(mapped.var_no()))
+    preprocessor.restore(mapped.var_no(), pending);
+
+  return mapped;
+}
+
+void cnf_preprocessing_solvert::add_to_solver(const bvt &clause)
+{
+  bvt mapped;
+  mapped.reserve(clause.size());
+
+  for(const auto &l : clause)
+  {
+    const literalt m=map_literal(l);
+
+    if(m.is_true())
+      return;
+    else if(!m.is_false())
+      mapped.push_back(m);
+  }
+
+  if(mapped.empty())
+  {
+    inconsistent=true;
+    return;
+  }
+
+  if(solver->no_variables()<no_variables())
+    solver->set_no_variables(no_variables());
+
+  solver->lcnf(mapped);
+}
+
+/// Pass the restored clauses to the solver, which may restore further ones
+void cnf_preprocessing_solvert::add_pending()
+{
+  while(!pending.empty())
+  {
+    const bvt clause=std::move(pending.back());
+    pending.pop_back();
+    add_to_solver(clause);
+  }
+}
+
+void cnf_preprocessing_solvert::set_frozen(literalt l)
+{
+  if(!preprocessed)
+  {
+    preprocessor.freeze(l);
+    return;
+  }
+
+  const literalt mapped=map_literal(l);
+  add_pending();
+
+  if(!mapped.is_constant())
+  {
+    if(solver->no_variables()<no_variables())
+      solver->set_no_variables(no_variables());
+
+    solver->set_frozen(mapped);
+  }
+}
+
+void cnf_preprocessing_solvert::set_assumptions(const bvt &_assumptions)
+{
+  assumptions=_assumptions;
+
+  if(!preprocessed)
+    for(const auto &l : assumptions)
+      preprocessor.freeze(l);
+}
+
+void cnf_preprocessing_solvert::preprocess()
+{
+  preprocessed=true;
+
+  for(const auto &l : assumptions)
+    preprocessor.freeze(l);
+
+  if(!preprocessor.simplify(clauses, no_variables()))
+    inconsistent=true;
+
+  const cnf_preprocessort::statisticst &s=preprocessor.get_statistics();
+
+  statistics() << "CNF preprocessing: "
+               << s.variables_before << " variables, "
+               << s.clauses_before << " clauses reduced to "
+               << s.variables_after << " variables, "
+               << s.clauses_after << " clauses" << eom;
+
+  statistics() << "CNF preprocessing: "
+               << s.units << " units, "
+               << s.equivalences << " equivalences, "
+               << s.blocked_clauses << " blocked clauses, "
+               << s.eliminated_variables << " eliminated variables" << eom;
+
+  if(inconsistent)
+    return;
+
+  solver->set_no_variables(no_variables());
+
+  for(const auto &clause : clauses)
+    solver->lcnf(clause);
+
+  clauses.clear();
+
+  for(literalt::var_not v=1; v<no_variables(); v++)
+    if(preprocessor.is_frozen(v))
+    {
+      const literalt mapped=preprocessor.map_literal(literalt(v, false));
+      if(!mapped.is_constant())
+        solver->set_frozen(mapped);
+    }
+}
+
+propt::resultt cnf_preprocessing_solvert::prop_solve()
+{
+  if(!preprocessed)
+    preprocess();
+
+  mapped_assumptions.clear();
+
+  bvt solver_assumptions;
+  bool assumption_false=false;
+
+  for(const auto &l : assumptions)
+  {
+    const literalt mapped=map_literal(l);
+    mapped_assumptions[l]=mapped;
+
+    if(mapped.is_false())
+      assumption_false=true;
+    else if(!mapped.is_true())
+      solver_assumptions.push_back(mapped);
+  }
+
+  add_pending();
+
+  if(inconsistent || assumption_false)
+  {
+    statistics() << "CNF preprocessing: system is UNSATISFIABLE" << eom;
+    return resultt::P_UNSATISFIABLE;
+  }
+
+  if(solver->no_variables()<no_variables())
+    solver->set_no_variables(no_variables());
+
+  if(solver->has_set_assumptions())
+    solver->set_assumptions(solver_assumptions);
+
+  const resultt result=solver->prop_solve();
+
+  if(result==resultt::P_SATISFIABLE)
+  {
+    assignment.resize(no_variables());
+
+    for(literalt::var_not v=1; v<assignment.size(); v++)
+      assignment[v]=solver->l_get(literalt(v, false));
+
+    preprocessor.extend_model(assignment);
+  }
+
+  return result;
+}
+
+bool cnf_preprocessing_solvert::is_in_conflict(literalt l) const
+{
+  const auto entry=mapped_assumptions.find(l);
+  PRECONDITION(entry!=mapped_assumptions.end());
+
+  if(entry->second.is_constant())
+    return entry->second.is_false();
+
+  return solver->is_in_conflict(entry->second);
+}
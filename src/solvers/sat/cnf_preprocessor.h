@@ -0,0 +1,200 @@
+/*******************************************************************\
+
+Module: CNF Preprocessing
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// CNF Preprocessing
+
+#ifndef CPROVER_SOLVERS_SAT_CNF_PREPROCESSOR_H
+#define CPROVER_SOLVERS_SAT_CNF_PREPROCESSOR_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "cnf_clause_list.h"
+
+/// \brief Simplifies a list of clauses before it is handed to a SAT solver
+///
+/// The simplifications are unit propagation, substitution of equivalent
+/// literals (strongly connected components of the binary implication
+/// graph), blocked clause elimination and bounded variable elimination.
+/// Frozen variables are neither substituted nor eliminated, and are not
+/// used as the blocking literal of a clause, such that they may be used in
+/// further clauses and assumptions.
+///
+/// The result is satisfiable iff the original clauses are. A model of the
+/// simplified clauses is turned into a model of the original ones by
+/// extend_model(). Clauses that are added after simplification must be
+/// passed through map_literal() and restore(): the former replaces fixed
+/// and substituted variables, the latter re-activates the clauses that were
+/// removed on behalf of a variable.
+class cnf_preprocessort
+{
+public:
+  struct statisticst
+  {
+    std::size_t clauses_before=0, clauses_after=0;
+    std::size_t variables_before=0, variables_after=0;
+    std::size_t units=0;
+    std::size_t equivalences=0;
+    std::size_t blocked_clauses=0;
+    std::size_t eliminated_variables=0;
+  };
+
+  // limits of bounded variable elimination
+  std::size_t max_occurrences=16;
+  std::size_t max_resolvent_size=24;
+
+  void freeze(literalt l);
+
+  bool is_frozen(literalt::var_not v) const
+  {
+    return v<frozen.size() && frozen[v];
+  }
+
+  /// Simplify \p clauses over the variables 1..no_variables-1 in place
+  /// \return false iff the clauses were found to be unsatisfiable
+  bool simplify(cnf_clause_listt::clausest &clauses, std::size_t no_variables);
+
+  /// The literal that replaces \p l, which is a constant if the variable of
+  /// \p l has been fixed
+  literalt map_literal(literalt l) const;
+
+  /// Whether \p v has been eliminated, or clauses have been removed on its
+  /// behalf, such that it needs to be restored before it may be used in a
+  /// new clause or assumption
+  bool needs_restore(literalt::var_not v) const
+  {
+    return v<status.size() &&
+           (status[v]==statust::ELIMINATED || !removed[v].empty());
+  }
+
+  /// Re-activate variable \p v, and append the clauses that were removed on
+  /// its behalf to \p dest
+  void restore(literalt::var_not v, std::vector<bvt> &dest);
+
+  /// Extend a model of the simplified clauses to the original ones. Entries
+  /// of variables that have been fixed, substituted or eliminated are
+  /// overwritten.
+  void extend_model(std::vector<tvt> &assignment) const;
+
+  const statisticst &get_statistics() const
+  {
+    return statistics;
+  }
+
+protected:
+  enum class statust { ACTIVE, FIXED, SUBSTITUTED, ELIMINATED };
+
+  std::vector<statust> status;
+  std::vector<bool> frozen;
+  // the value of FIXED variables
+  std::vector<bool> value;
+  // the literal replacing SUBSTITUTED variables
+  std::vector<literalt> representative;
+  // the clauses removed on behalf of a variable, by eliminating it or by
+  // using it as blocking literal
+  std::vector<std::vector<bvt>> removed;
+  // variables whose removed clauses have been restored
+  std::vector<bool> restored;
+
+  // Each entry is a clause that is to be satisfied by making its witness
+  // literal true, processed from last to first to extend a model.
+  struct extensiont
+  {
+    literalt witness;
+    bvt clause;
+  };
+  std::vector<extensiont> extension_stack;
+
+  // the working set of clauses, with occurrence lists indexed by
+  // literalt::get(); these may contain stale entries
+  std::vector<bvt> clauses;
+  std::vector<bool> deleted;
+  std::vector<std::vector<std::size_t>> occurs;
+  std::vector<std::size_t> units;
+  bool inconsistent;
+
+  statisticst statistics;
+
+  void resize(std::size_t no_variables);
+  std::size_t add_clause(bvt clause);
+  void delete_clause(std::size_t index);
+  const std::vector<std::size_t> &occurrences(literalt l);
+  static bool contains(const bvt &clause, literalt l);
+  static bool normalize(bvt &clause);
+
+  bool propagate();
+  bool substitute_equivalences();
+  bool eliminate_blocked_clauses();
+  bool eliminate_variables();
+  bool eliminate_variable(literalt::var_not v);
+
+  std::size_t count_variables(const cnf_clause_listt::clausest &) const;
+};
+
+/// \brief Runs cnf_preprocessort on the clauses given before the first call
+/// to prop_solve(), and passes the result to another CNF solver
+class cnf_preprocessing_solvert:public cnf_clause_list_assignmentt
+{
+public:
+  explicit cnf_preprocessing_solvert(std::unique_ptr<cnft> _solver);
+
+  const std::string solver_text() override;
+
+  void set_message_handler(message_handlert &_message_handler) override
+  {
+    cnf_clause_list_assignmentt::set_message_handler(_message_handler);
+    solver->set_message_handler(_message_handler);
+  }
+
+  void lcnf(const bvt &bv) override;
+  resultt prop_solve() override;
+
+  void set_assumptions(const bvt &_assumptions) override;
+  bool has_set_assumptions() const override
+  {
+    return solver->has_set_assumptions();
+  }
+
+  bool is_in_conflict(literalt l) const override;
+  bool has_is_in_conflict() const override
+  {
+    return solver->has_is_in_conflict();
+  }
+
+  void set_frozen(literalt l) override;
+
+  void set_time_limit_seconds(uint32_t lim) override
+  {
+    solver->set_time_limit_seconds(lim);
+  }
+
+  const cnf_preprocessort::statisticst &get_statistics() const
+  {
+    return preprocessor.get_statistics();
+  }
+
+protected:
+  std::unique_ptr<cnft> solver;
+  cnf_preprocessort preprocessor;
+  bool preprocessed;
+  bool inconsistent;
+  bvt assumptions;
+  // the assumptions as given to the solver, by original literal
+  std::map<literalt, literalt> mapped_assumptions;
+  // clauses that have been restored but not yet passed to the solver
+  std::vector<bvt> pending;
+
+  void preprocess();
+  void add_to_solver(const bvt &clause);
+  void add_pending();
+  literalt map_literal(literalt l);
+};
+
+#endif // CPROVER_SOLVERS_SAT_CNF_PREPROCESSOR_H
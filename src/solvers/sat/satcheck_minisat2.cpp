@@ -14,6 +14,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <stack>
 
 #include <util/invariant.h>
@@ -91,6 +92,19 @@ template<typename T>
 void satcheck_minisat2_baset<T>::clear_interrupt()
 {
   solver->clearInterrupt();
+
+  // an interrupted query leaves the solver in a usable state
+  if(status==statust::ERROR)
+    status=statust::INIT;
+}
+
+template<typename T>
+void satcheck_minisat2_baset<T>::set_random_seed(double seed)
+{
+  PRECONDITION(seed>0);
+  solver->random_seed=seed;
+  solver->rnd_init_act=true;
+  solver->random_var_freq=0.01;
 }
 
 const std::string satcheck_minisat_no_simplifiert::solver_text()
@@ -147,6 +161,34 @@ void satcheck_minisat2_baset<T>::lcnf(const bvt &bv)
   }
 }
 
+/// Solve in rounds of a growing number of conflicts, until there is an
+/// answer or \p stop is set. MiniSat checks its own interrupt flag, a
+/// plain bool, while it solves, so that flag must not be set from another
+/// thread. Learnt clauses are kept from one round to the next. The rounds
+/// are capped at 10000 conflicts, which MiniSat typically does in well
+/// below a second, as that bounds the time it takes to notice \p stop.
+template<typename T>
+static Minisat::lbool solve_in_rounds(
+  T &solver,
+  const Minisat::vec<Minisat::Lit> &assumptions,
+  const std::atomic<bool> &stop)
+{
+  using Minisat::lbool;
+
+  lbool result=l_Undef;
+  int64_t budget=1000;
+
+  while(result==l_Undef && !stop)
+  {
+    solver.setConfBudget(budget);
+    result=solver.solveLimited(assumptions);
+    budget=std::min(2*budget, int64_t(10000));
+  }
+
+  solver.budgetOff();
+  return result;
+}
+
 #ifndef _WIN32
 
 static Minisat::Solver *solver_to_interrupt=nullptr;
@@ -199,41 +241,52 @@ propt::resultt satcheck_minisat2_baset<T>::prop_solve()
 
         using Minisat::lbool;
 
-#ifndef _WIN32
-
-        void (*old_handler)(int)=SIG_ERR;
+        lbool solver_result=l_Undef;
 
-        if(time_limit_seconds!=0)
+        if(stop_flag!=nullptr)
         {
-          solver_to_interrupt=solver;
-          old_handler=signal(SIGALRM, interrupt_solver);
-          if(old_handler==SIG_ERR)
-            warning() << "Failed to set solver time limit" << eom;
-          else
-            alarm(time_limit_seconds);
+          solver_result=
+            solve_in_rounds(*solver, solver_assumptions, *stop_flag);
         }
+        else
+        {
+#ifndef _WIN32
 
-        lbool solver_result=solver->solveLimited(solver_assumptions);
+          void (*old_handler)(int)=SIG_ERR;
 
-        if(old_handler!=SIG_ERR)
-        {
-          alarm(0);
-          signal(SIGALRM, old_handler);
-          solver_to_interrupt=solver;
-        }
+          if(time_limit_seconds!=0)
+          {
+            solver_to_interrupt=solver;
+            old_handler=signal(SIGALRM, interrupt_solver);
+            if(old_handler==SIG_ERR)
+              warning() << "Failed to set solver time limit" << eom;
+            else
+              alarm(time_limit_seconds);
+          }
+
+          solver_result=solver->solveLimited(solver_assumptions);
+
+          if(old_handler!=SIG_ERR)
+          {
+            alarm(0);
+            signal(SIGALRM, old_handler);
+            solver_to_interrupt=solver;
+          }
 
 #else // _WIN32
 
-        if(time_limit_seconds!=0)
-        {
-          messaget::warning() <<
-            "Time limit ignored (not supported on Win32 yet)" << messaget::eom;
-        }
+          if(time_limit_seconds!=0)
+          {
+            messaget::warning()
+              << "Time limit ignored (not supported on Win32 yet)"
+              << messaget::eom;
+          }
 
-        lbool solver_result=
-          solver->solve(solver_assumptions) ? l_True : l_False;
+          solver_result=
+            solver->solve(solver_assumptions) ? l_True : l_False;
 
 #endif
+        }
 
         if(solver_result==l_True)
         {
@@ -295,7 +348,7 @@ void satcheck_minisat2_baset<T>::set_assignment(literalt a, bool value)
 
 template<typename T>
 satcheck_minisat2_baset<T>::satcheck_minisat2_baset(T *_solver):
-  solver(_solver), time_limit_seconds(0)
+  solver(_solver), time_limit_seconds(0), stop_flag(nullptr)
 {
 }
 
@@ -10,6 +10,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_SOLVERS_SAT_SATCHECK_MINISAT2_H
 #define CPROVER_SOLVERS_SAT_SATCHECK_MINISAT2_H
 
+#include <atomic>
+
 #include "cnf.h"
 
 // Select one: basic solver or with simplification.
@@ -48,6 +50,19 @@ public:
   // extra MiniSat feature: permit previously interrupted SAT query to continue
   void clear_interrupt();
 
+  // solve in rounds of a limited number of conflicts, and give up between
+  // rounds once *flag is set; unlike interrupt(), setting the flag is safe
+  // from another thread, but it takes effect only at the end of the current
+  // round of at most 10000 conflicts, usually within a second
+  void set_stop_flag(const std::atomic<bool> *flag)
+  {
+    stop_flag=flag;
+  }
+
+  // extra MiniSat feature: randomize the initial variable order and some of
+  // the decisions, using a positive seed; call before adding clauses
+  void set_random_seed(double seed);
+
   virtual bool is_in_conflict(literalt a) const override;
   virtual bool has_set_assumptions() const final { return true; }
   virtual bool has_is_in_conflict() const final { return true; }
@@ -60,6 +75,7 @@ public:
 protected:
   T *solver;
   uint32_t time_limit_seconds;
+  const std::atomic<bool> *stop_flag;
 
   void add_variables();
   bvt assumptions;
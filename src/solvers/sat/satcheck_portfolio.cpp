@@ -0,0 +1,269 @@
+/*******************************************************************\
+
+Module: Portfolio of SAT Solvers
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Portfolio of SAT Solvers
+
+#include "satcheck_portfolio.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <util/invariant.h>
+#include <util/make_unique.h>
+
+#include "satcheck.h"
+
+satcheck_portfoliot::satcheck_portfoliot():
+  time_limit_seconds(0),
+  winner(0)
+{
+}
+
+satcheck_portfoliot::~satcheck_portfoliot()
+{
+}
+
+void satcheck_portfoliot::add_solver(
+  std::unique_ptr<cnf_solvert> solver,
+  std::function<void()> interrupt,
+  std::function<void()> clear_interrupt)
+{
+  solver->set_message_handler(null_message_handler);
+  add_variables(*solver);
+
+  membert member;
+  member.solver=std::move(solver);
+  member.interrupt=std::move(interrupt);
+  member.clear_interrupt=std::move(clear_interrupt);
+  members.push_back(std::move(member));
+}
+
+const std::string satcheck_portfoliot::solver_text()
+{
+  std::string result="portfolio of";
+
+  for(std::size_t i=0; i<members.size(); i++)
+    result+=(i==0?" ":", ")+members[i].solver->solver_text();
+
+  return result;
+}
+
+void satcheck_portfoliot::add_variables(cnf_solvert &solver) const
+{
+  if(solver.no_variables()<no_variables())
+    solver.set_no_variables(no_variables());
+}
+
+void satcheck_portfoliot::lcnf(const bvt &bv)
+{
+  for(auto &member : members)
+  {
+    add_variables(*member.solver);
+    member.solver->lcnf(bv);
+  }
+
+  clause_counter++;
+}
+
+void satcheck_portfoliot::set_assumptions(const bvt &_assumptions)
+{
+  assumptions=_assumptions;
+}
+
+bool satcheck_portfoliot::has_set_assumptions() const
+{
+  for(const auto &member : members)
+    if(!member.solver->has_set_assumptions())
+      return false;
+
+  return true;
+}
+
+bool satcheck_portfoliot::has_is_in_conflict() const
+{
+  for(const auto &member : members)
+    if(!member.solver->has_is_in_conflict())
+      return false;
+
+  return true;
+}
+
+void satcheck_portfoliot::set_frozen(literalt a)
+{
+  for(auto &member : members)
+  {
+    add_variables(*member.solver);
+    member.solver->set_frozen(a);
+  }
+}
+
+tvt satcheck_portfoliot::l_get(literalt a) const
+{
+  if(a.is_constant())
+    return tvt(a.is_true());
+
+  if(status!=statust::SAT)
+    return tvt::unknown();
+
+  return members[winner].solver->l_get(a);
+}
+
+bool satcheck_portfoliot::is_in_conflict(literalt a) const
+{
+  PRECONDITION(status==statust::UNSAT);
+  return members[winner].solver->is_in_conflict(a);
+}
+
+propt::resultt satcheck_portfoliot::prop_solve()
+{
+  PRECONDITION(!members.empty());
+
+  statistics() << (no_variables()-1) << " variables, "
+               << no_clauses() << " clauses, "
+               << members.size() << " SAT solvers" << eom;
+
+  for(auto &member : members)
+  {
+    add_variables(*member.solver);
+    if(member.solver->has_set_assumptions())
+      member.solver->set_assumptions(assumptions);
+  }
+
+  std::mutex mutex;
+  std::condition_variable finished_condition;
+  std::size_t finished=0;
+  bool answered=false;
+  std::vector<resultt> results(members.size(), resultt::P_ERROR);
+  std::vector<std::thread> threads;
+
+  for(std::size_t i=0; i<members.size(); i++)
+  {
+    threads.emplace_back([this, i, &mutex, &finished_condition, &finished,
+                          &answered, &results]()
+    {
+      const resultt result=members[i].solver->prop_solve();
+
+      std::lock_guard<std::mutex> lock(mutex);
+      results[i]=result;
+      finished++;
+
+      if(!answered && result!=resultt::P_ERROR)
+      {
+        answered=true;
+        winner=i;
+
+        for(std::size_t j=0; j<members.size(); j++)
+          if(j!=i)
+            members[j].interrupt();
+      }
+
+      finished_condition.notify_all();
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto done=[&]() { return answered || finished==members.size(); };
+
+    if(time_limit_seconds==0)
+      finished_condition.wait(lock, done);
+    else if(!finished_condition.wait_for(
+              lock, std::chrono::seconds(time_limit_seconds), done))
+    {
+      for(auto &member : members)
+        member.interrupt();
+    }
+  }
+
+  for(auto &thread : threads)
+    thread.join();
+
+  for(auto &member : members)
+    member.clear_interrupt();
+
+  if(!answered)
+  {
+    messaget::status() << "SAT checker: timed out or other error" << eom;
+    status=statust::ERROR;
+    return resultt::P_ERROR;
+  }
+
+  statistics() << "SAT checker: answer given by solver " << winner << " ("
+               << members[winner].solver->solver_text() << ")" << eom;
+
+  if(results[winner]==resultt::P_SATISFIABLE)
+  {
+    messaget::status() << "SAT checker: instance is SATISFIABLE" << eom;
+    status=statust::SAT;
+  }
+  else
+  {
+    messaget::status() << "SAT checker: instance is UNSATISFIABLE" << eom;
+    status=statust::UNSAT;
+  }
+
+  return results[winner];
+}
+
+std::unique_ptr<satcheck_portfoliot> default_sat_portfolio(
+  std::size_t size,
+  bool simplifier)
+{
+#ifdef SATCHECK_MINISAT2
+  auto portfolio=util_make_unique<satcheck_portfoliot>();
+
+  for(std::size_t i=0; i<size; i++)
+  {
+    // MiniSat::interrupt() must not be called from another thread, hence
+    // the members poll a flag of their own between rounds of solving
+    const auto stop=std::make_shared<std::atomic<bool>>(false);
+
+    const auto add=[&portfolio, &stop](
+      std::unique_ptr<cnf_solvert> solver,
+      std::function<void()> clear_interrupt)
+    {
+      portfolio->add_solver(
+        std::move(solver),
+        [stop]() { *stop=true; },
+        [stop, clear_interrupt]()
+        {
+          *stop=false;
+          clear_interrupt();
+        });
+    };
+
+    if(i==0 && simplifier)
+    {
+      auto solver=util_make_unique<satcheck_minisat_simplifiert>();
+      satcheck_minisat_simplifiert *s=solver.get();
+      s->set_stop_flag(stop.get());
+      add(std::move(solver), [s]() { s->clear_interrupt(); });
+    }
+    else
+    {
+      auto solver=util_make_unique<satcheck_minisat_no_simplifiert>();
+      satcheck_minisat_no_simplifiert *s=solver.get();
+      s->set_stop_flag(stop.get());
+
+      // the first member keeps the default configuration
+      if(i!=0)
+        s->set_random_seed(i);
+
+      add(std::move(solver), [s]() { s->clear_interrupt(); });
+    }
+  }
+
+  return portfolio;
+#else
+  return nullptr;
+#endif
+}
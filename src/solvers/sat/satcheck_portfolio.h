@@ -0,0 +1,104 @@
+/*******************************************************************\
+
+Module: Portfolio of SAT Solvers
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Portfolio of SAT Solvers
+
+#ifndef CPROVER_SOLVERS_SAT_SATCHECK_PORTFOLIO_H
+#define CPROVER_SOLVERS_SAT_SATCHECK_PORTFOLIO_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <util/message.h>
+
+#include "cnf.h"
+
+/// \brief Runs several SAT solvers on the same CNF, each in its own thread
+///
+/// All clauses, frozen variables and assumptions are passed to every
+/// member. prop_solve() returns the first answer given by any member, and
+/// interrupts the others; the model and the conflict information are then
+/// those of the member that answered first.
+///
+/// The members only share the clauses that are passed to them, so they can
+/// be run concurrently, but they must not use any process-wide state such
+/// as signal handlers. Time limits are therefore implemented by the
+/// portfolio. Members are silenced, as their messages would interleave.
+class satcheck_portfoliot:public cnf_solvert
+{
+public:
+  satcheck_portfoliot();
+  ~satcheck_portfoliot();
+
+  /// Add a member to the portfolio
+  /// \param solver: the SAT solver
+  /// \param interrupt: called from another thread to make a running (or the
+  ///   next) call to prop_solve() of \p solver return P_ERROR
+  /// \param clear_interrupt: called after the portfolio has finished
+  ///   solving, to make \p solver usable again after it was interrupted
+  void add_solver(
+    std::unique_ptr<cnf_solvert> solver,
+    std::function<void()> interrupt,
+    std::function<void()> clear_interrupt);
+
+  std::size_t size() const
+  {
+    return members.size();
+  }
+
+  const std::string solver_text() override;
+
+  void lcnf(const bvt &bv) override;
+  resultt prop_solve() override;
+  tvt l_get(literalt a) const override;
+
+  void set_assumptions(const bvt &_assumptions) override;
+  bool has_set_assumptions() const override;
+
+  bool is_in_conflict(literalt a) const override;
+  bool has_is_in_conflict() const override;
+
+  void set_frozen(literalt a) override;
+
+  void set_time_limit_seconds(uint32_t lim) override
+  {
+    time_limit_seconds=lim;
+  }
+
+protected:
+  struct membert
+  {
+    std::unique_ptr<cnf_solvert> solver;
+    std::function<void()> interrupt;
+    std::function<void()> clear_interrupt;
+  };
+
+  std::vector<membert> members;
+  null_message_handlert null_message_handler;
+  bvt assumptions;
+  uint32_t time_limit_seconds;
+
+  // the member whose model and conflict are reported
+  std::size_t winner;
+
+  void add_variables(cnf_solvert &solver) const;
+};
+
+/// A portfolio of \p size configurations of the default SAT solver, which
+/// differ in the use of the simplifier and in the random seed
+/// \param size: the number of members
+/// \param simplifier: whether the first member may use a simplifier
+/// \return nullptr if the default SAT solver cannot be interrupted, which
+///   is required to run it in a portfolio
+std::unique_ptr<satcheck_portfoliot> default_sat_portfolio(
+  std::size_t size,
+  bool simplifier);
+
+#endif // CPROVER_SOLVERS_SAT_SATCHECK_PORTFOLIO_H
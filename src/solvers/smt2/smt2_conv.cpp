@@ -133,7 +133,8 @@ void smt2_convt::write_footer(std::ostream &out)
 
 void smt2_convt::define_object_size(
   const irep_idt &id,
-  const exprt &expr)
+  const exprt &expr,
+  std::size_t first_object)
 {
   assert(expr.id()==ID_object_size);
   const exprt &ptr = expr.op0();
@@ -149,7 +150,8 @@ void smt2_convt::define_object_size(
     exprt size_expr = size_of_expr(type, ns);
     mp_integer object_size;
 
-    if(o.id()!=ID_symbol ||
+    if(number<first_object ||
+       o.id()!=ID_symbol ||
        size_expr.is_nil() ||
        to_integer(size_expr, object_size))
     {
@@ -259,7 +259,11 @@ protected:
   void convert_address_of_rec(
     const exprt &expr, const pointer_typet &result_type);
 
-  void define_object_size(const irep_idt &id, const exprt &expr);
+  // defines the size for the objects numbered from first_object on
+  void define_object_size(
+    const irep_idt &id,
+    const exprt &expr,
+    std::size_t first_object=0);
 
   // keeps track of all non-Boolean symbols and their value
   struct identifiert
@@ -177,7 +177,6 @@ decision_proceduret::resultt smt2_dect::read_result(std::istream &in)
   boolean_assignment.clear();
   boolean_assignment.resize(no_boolean_variables, false);
 
-  typedef std::unordered_map<irep_idt, irept, irep_id_hash> valuest;
   valuest values;
 
   while(in)
@@ -218,6 +217,13 @@ decision_proceduret::resultt smt2_dect::read_result(std::istream &in)
     }
   }
 
+  set_values(values);
+
+  return res;
+}
+
+void smt2_dect::set_values(valuest &values)
+{
   for(auto &assignment : identifier_map)
   {
     std::string conv_id=convert_identifier(assignment.first);
@@ -226,11 +232,11 @@ decision_proceduret::resultt smt2_dect::read_result(std::istream &in)
   }
 
   // Booleans
+  boolean_assignment.resize(no_boolean_variables, false);
+
   for(unsigned v=0; v<no_boolean_variables; v++)
   {
     const irept &value=values["B"+std::to_string(v)];
     boolean_assignment[v]=(value.id()==ID_true);
   }
-
-  return res;
 }
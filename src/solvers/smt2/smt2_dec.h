@@ -53,6 +53,12 @@ public:
 
 protected:
   resultt read_result(std::istream &in);
+
+  typedef std::unordered_map<irep_idt, irept, irep_id_hash> valuest;
+
+  /// Set the values of identifiers and Booleans from the values
+  /// returned by the solver
+  void set_values(valuest &values);
 };
 
 #endif // CPROVER_SOLVERS_SMT2_SMT2_DEC_H
@@ -0,0 +1,288 @@
+/*******************************************************************\
+
+Module: Interactive SMT2 Solver
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Interactive SMT2 Solver
+
+#include "smt2_pipe_dec.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include <util/invariant.h>
+
+#include "smt2irep.h"
+
+smt2_pipe_dect::smt2_pipe_dect(
+  const namespacet &_ns,
+  const std::string &_benchmark,
+  const std::string &_notes,
+  const std::string &_logic,
+  solvert _solver):
+  smt2_dect(_ns, _benchmark, _notes, _logic, _solver)
+{
+  PRECONDITION(is_supported(_solver));
+
+  // This option needs to precede the header, which sets the logic.
+  const std::string header=stringstream.str();
+  stringstream.str(std::string());
+  stringstream << "(set-option :print-success false)\n"
+               << header;
+}
+
+#ifndef _WIN32
+/// Blocks SIGPIPE for the calling thread while an object of this class
+/// exists. Writing to a solver that has terminated then fails with EPIPE,
+/// which shows up as an unexpected end of its output, rather than
+/// terminating the process. A SIGPIPE raised in the meantime is discarded
+/// before the signal mask is restored.
+class block_sigpipet
+{
+public:
+  block_sigpipet()
+  {
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+
+    sigset_t pending;
+    sigpending(&pending);
+    was_pending=sigismember(&pending, SIGPIPE)==1;
+
+    pthread_sigmask(SIG_BLOCK, &sigpipe, &old_mask);
+  }
+
+  ~block_sigpipet()
+  {
+    sigset_t pending;
+    sigpending(&pending);
+
+    if(!was_pending && sigismember(&pending, SIGPIPE)==1)
+    {
+      int signal_number;
+      sigwait(&sigpipe, &signal_number);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+  }
+
+protected:
+  sigset_t sigpipe, old_mask;
+  bool was_pending;
+};
+#endif
+
+smt2_pipe_dect::~smt2_pipe_dect()
+{
+  if(process)
+  {
+    {
+      #ifndef _WIN32
+      block_sigpipet block_sigpipe;
+      #endif
+      *process << "(exit)\n" << std::flush;
+    }
+
+    process->wait();
+  }
+}
+
+bool smt2_pipe_dect::is_supported(solvert solver)
+{
+  return solver==solvert::CVC4 ||
+         solver==solvert::MATHSAT ||
+         solver==solvert::YICES ||
+         solver==solvert::Z3;
+}
+
+std::string smt2_pipe_dect::decision_procedure_text() const
+{
+  return smt2_dect::decision_procedure_text()+" (interactive)";
+}
+
+void smt2_pipe_dect::get_command(
+  std::string &executable,
+  std::list<std::string> &arguments) const
+{
+  switch(solver)
+  {
+  case solvert::CVC4:
+    executable="cvc4";
+    arguments={ "--lang", "smt2", "--incremental" };
+    break;
+
+  case solvert::MATHSAT:
+    executable="mathsat";
+    arguments={ "-input=smt2" };
+    break;
+
+  case solvert::YICES:
+    executable="yices-smt2";
+    arguments={ "--incremental" };
+    break;
+
+  case solvert::Z3:
+    executable="z3";
+    arguments={ "-smt2", "-in" };
+    break;
+
+  case solvert::GENERIC:
+  case solvert::BOOLECTOR:
+  case solvert::CVC3:
+  case solvert::OPENSMT:
+    UNREACHABLE;
+  }
+}
+
+bool smt2_pipe_dect::start()
+{
+  std::string executable;
+  std::list<std::string> arguments;
+  get_command(executable, arguments);
+
+  process=std::unique_ptr<pipe_streamt>(
+    new pipe_streamt(executable, arguments));
+
+  if(process->run()<0)
+  {
+    error() << "failed to run " << executable << eom;
+    process.reset();
+    return true;
+  }
+
+  return false;
+}
+
+void smt2_pipe_dect::send()
+{
+  #ifndef _WIN32
+  block_sigpipet block_sigpipe;
+  #endif
+
+  *process << stringstream.str() << std::flush;
+  stringstream.str(std::string());
+}
+
+irept smt2_pipe_dect::read_response()
+{
+  while(true)
+  {
+    irept response=smt2irep(*process);
+
+    // acknowledgements of set-option commands
+    if(response.id()!="success" && response.id()!="unsupported")
+      return response;
+  }
+}
+
+bool smt2_pipe_dect::is_error(const irept &response)
+{
+  if(response.id().empty() &&
+     response.get_sub().size()==2 &&
+     response.get_sub().front().id()=="error")
+  {
+    error() << "SMT2 solver returned error message:\n"
+            << "\t\"" << response.get_sub()[1].id() << "\"" << eom;
+    return true;
+  }
+
+  return false;
+}
+
+decision_proceduret::resultt smt2_pipe_dect::dec_solve()
+{
+  if(!process && start())
+    return resultt::D_ERROR;
+
+  // fix up the object sizes, for the objects that are new since the last
+  // call; those that the solver has already received remain asserted
+  const std::size_t objects=pointer_logic.objects.size();
+  for(const auto &object : object_sizes)
+  {
+    std::size_t &defined=defined_object_sizes[object.second];
+    define_object_size(object.second, object.first, defined);
+    defined=objects;
+  }
+
+  out << "\n";
+
+  bvt solver_assumptions;
+  for(const auto &literal : assumptions)
+  {
+    if(literal.is_false())
+    {
+      send();
+      return resultt::D_UNSATISFIABLE;
+    }
+    else if(!literal.is_true())
+      solver_assumptions.push_back(literal);
+  }
+
+  if(solver_assumptions.empty())
+    out << "(check-sat)\n";
+  else
+  {
+    out << "(check-sat-assuming (";
+    for(const auto &literal : solver_assumptions)
+    {
+      out << ' ';
+      convert_literal(literal);
+    }
+    out << "))\n";
+  }
+
+  send();
+
+  const irept response=read_response();
+
+  if(response.id()=="sat")
+    return read_values();
+  else if(response.id()=="unsat")
+    return resultt::D_UNSATISFIABLE;
+  else if(is_error(response))
+    return resultt::D_ERROR;
+  else if(response.id().empty())
+    error() << "SMT2 solver terminated unexpectedly" << eom;
+  else
+    error() << "unexpected response from SMT2 solver: "
+            << response.id() << eom;
+
+  return resultt::D_ERROR;
+}
+
+decision_proceduret::resultt smt2_pipe_dect::read_values()
+{
+  valuest values;
+
+  if(!smt2_identifiers.empty())
+  {
+    out << "(get-value (";
+    for(const auto &id : smt2_identifiers)
+      out << " |" << id << '|';
+    out << "))\n";
+
+    send();
+
+    const irept response=read_response();
+
+    if(is_error(response))
+      return resultt::D_ERROR;
+
+    // Example: ( (B0 true) (|x#1| (_ bv1 32)) )
+    for(const auto &value : response.get_sub())
+    {
+      if(value.get_sub().size()==2)
+        values[value.get_sub()[0].id()]=value.get_sub()[1];
+    }
+  }
+
+  set_values(values);
+
+  return resultt::D_SATISFIABLE;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************\
+
+Module: Interactive SMT2 Solver
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Interactive SMT2 Solver
+
+#ifndef CPROVER_SOLVERS_SMT2_SMT2_PIPE_DEC_H
+#define CPROVER_SOLVERS_SMT2_SMT2_PIPE_DEC_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <util/pipe_stream.h>
+
+#include "smt2_dec.h"
+
+/*! \brief Decision procedure that keeps an SMT 2.x solver running
+
+  Rather than writing the problem into a file and running the solver on
+  it for each call of dec_solve(), the solver is started on the first
+  call and receives the formula over a pipe. Subsequent calls only send
+  what has been converted since, and the assumptions are passed using
+  check-sat-assuming.
+*/
+class smt2_pipe_dect:public smt2_dect
+{
+public:
+  smt2_pipe_dect(
+    const namespacet &_ns,
+    const std::string &_benchmark,
+    const std::string &_notes,
+    const std::string &_logic,
+    solvert _solver);
+
+  /// Terminates the solver
+  ~smt2_pipe_dect();
+
+  /// \return true if \p solver can be driven interactively
+  static bool is_supported(solvert solver);
+
+  resultt dec_solve() override;
+  std::string decision_procedure_text() const override;
+
+protected:
+  std::unique_ptr<pipe_streamt> process;
+
+  /// For each object size, the number of objects that its definition has
+  /// been sent for
+  std::map<irep_idt, std::size_t> defined_object_sizes;
+
+  /// The command that runs the solver such that it reads the problem from
+  /// its standard input
+  virtual void get_command(
+    std::string &executable,
+    std::list<std::string> &arguments) const;
+
+  /// \return true on error
+  bool start();
+
+  /// Send what has been converted so far to the solver
+  void send();
+
+  /// Read a response, skipping acknowledgements of set-option
+  irept read_response();
+
+  bool is_error(const irept &response);
+
+  resultt read_values();
+};
+
+#endif // CPROVER_SOLVERS_SMT2_SMT2_PIPE_DEC_H
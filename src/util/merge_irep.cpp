@@ -124,9 +124,22 @@ void merge_irept::operator()(irept &irep)
 
 const irept &merge_irept::merged(const irept &irep)
 {
+  // the result of an earlier merge: nothing to do, and no need to hash
+  // the whole tree
+  if(merged_nodes.find(&irep.read())!=merged_nodes.end())
+  {
+    statistics.already_merged++;
+    return irep;
+  }
+
+  statistics.nodes_looked_up++;
+
   irep_storet::const_iterator entry=irep_store.find(irep);
   if(entry!=irep_store.end())
+  {
+    statistics.nodes_shared++;
     return *entry;
+  }
 
   irept new_irep(irep.id());
 
@@ -159,7 +172,29 @@ const irept &merge_irept::merged(const irept &irep)
     dest_comments[it->first]=merged(it->second); // recursive call
     #endif
 
-  return *irep_store.insert(new_irep).first;
+  const irept &result=*irep_store.insert(new_irep).first;
+  merged_nodes.insert(&result.read());
+  return result;
+}
+
+// the store of the innermost hash_consing_scopet
+static merge_full_irept *hash_consing_store=nullptr;
+
+void hash_cons(irept &irep)
+{
+  if(hash_consing_store!=nullptr)
+    (*hash_consing_store)(irep);
+}
+
+hash_consing_scopet::hash_consing_scopet():
+  outer_store(hash_consing_store)
+{
+  hash_consing_store=&store;
+}
+
+hash_consing_scopet::~hash_consing_scopet()
+{
+  hash_consing_store=outer_store;
 }
 
 void merge_full_irept::operator()(irept &irep)
@@ -172,9 +207,20 @@ void merge_full_irept::operator()(irept &irep)
 
 const irept &merge_full_irept::merged(const irept &irep)
 {
+  if(merged_nodes.find(&irep.read())!=merged_nodes.end())
+  {
+    statistics.already_merged++;
+    return irep;
+  }
+
+  statistics.nodes_looked_up++;
+
   irep_storet::const_iterator entry=irep_store.find(irep);
   if(entry!=irep_store.end())
+  {
+    statistics.nodes_shared++;
     return *entry;
+  }
 
   irept new_irep(irep.id());
 
@@ -207,5 +253,7 @@ const irept &merge_full_irept::merged(const irept &irep)
     dest_comments[it->first]=merged(it->second); // recursive call
     #endif
 
-  return *irep_store.insert(new_irep).first;
+  const irept &result=*irep_store.insert(new_irep).first;
+  merged_nodes.insert(&result.read());
+  return result;
 }
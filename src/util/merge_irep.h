@@ -98,6 +98,16 @@ protected:
   const merged_irept &merged(const irept &);
 };
 
+struct merge_irep_statisticst
+{
+  // number of nodes that had to be looked up in the store
+  std::size_t nodes_looked_up=0;
+  // ... of which an equal node was in the store already
+  std::size_t nodes_shared=0;
+  // number of trees that had been merged already, which takes O(1)
+  std::size_t already_merged=0;
+};
+
 // Warning: the below uses irep_hash, as opposed to irep_full_hash,
 // i.e., any comments will be disregarded during merging. Use
 // merge_full_irept if any comments are of importance.
@@ -107,10 +117,27 @@ class merge_irept
 public:
   void operator()(irept &);
 
+  const merge_irep_statisticst &get_statistics() const
+  {
+    return statistics;
+  }
+
+  /// number of distinct nodes in the store
+  std::size_t size() const
+  {
+    return irep_store.size();
+  }
+
 protected:
   typedef std::unordered_set<irept, irep_hash> irep_storet;
   irep_storet irep_store;
 
+  // the nodes of the ireps in irep_store; as the store holds a reference,
+  // these are never modified or released
+  std::unordered_set<const void *> merged_nodes;
+
+  merge_irep_statisticst statistics;
+
   const irept &merged(const irept &irep);
 };
 
@@ -119,11 +146,57 @@ class merge_full_irept
 public:
   void operator()(irept &);
 
+  const merge_irep_statisticst &get_statistics() const
+  {
+    return statistics;
+  }
+
+  /// number of distinct nodes in the store
+  std::size_t size() const
+  {
+    return irep_store.size();
+  }
+
 protected:
   typedef std::unordered_set<irept, irep_full_hash, irep_full_eq> irep_storet;
   irep_storet irep_store;
 
+  // see merge_irept
+  std::unordered_set<const void *> merged_nodes;
+
+  merge_irep_statisticst statistics;
+
   const irept &merged(const irept &irep);
 };
 
+/// Merge \p irep into the store of the innermost hash_consing_scopet, if
+/// there is one, and do nothing otherwise. Components that create many
+/// structurally equal expressions, such as symbolic execution and the
+/// simplifier, apply this to their results. Comments are taken into
+/// account, i.e., merging never changes an irep.
+void hash_cons(irept &irep);
+
+/// Enables hash_cons() while an object of this class exists. The store
+/// keeps every irep passed to hash_cons() alive, and is released, together
+/// with all nodes that nothing else refers to, when the object is
+/// destroyed. Scopes may be nested; the innermost one is used.
+class hash_consing_scopet
+{
+public:
+  hash_consing_scopet();
+  ~hash_consing_scopet();
+
+  hash_consing_scopet(const hash_consing_scopet &)=delete;
+  hash_consing_scopet &operator=(const hash_consing_scopet &)=delete;
+
+  const merge_full_irept &get_store() const
+  {
+    return store;
+  }
+
+protected:
+  merge_full_irept store;
+  merge_full_irept *const outer_store;
+};
+
 #endif // CPROVER_UTIL_MERGE_IREP_H
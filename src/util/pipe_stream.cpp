@@ -159,12 +159,12 @@ int pipe_streamt::run()
 
     _argv[args.size()+1]=nullptr;
 
-    int result=execvp(executable.c_str(), _argv.data());
+    execvp(executable.c_str(), _argv.data());
 
-    if(result==-1)
-      perror(nullptr);
-
-    return result;
+    // only reached if the executable could not be run; the parent will
+    // see the pipes being closed
+    perror(executable.c_str());
+    _exit(127);
   }
   else if(pid==-1)
   {
@@ -34,6 +34,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #include "bv_arithmetic.h"
 #include "endianness_map.h"
 #include "simplify_utils.h"
+#include "merge_irep.h"
+#include "simplify_expr_cache.h"
 
 // #define DEBUGX
 
@@ -41,30 +43,6 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <iostream>
 #endif
 
-// #define USE_CACHE
-
-#ifdef USE_CACHE
-struct simplify_expr_cachet
-{
-public:
-  #if 1
-  typedef std::unordered_map<
-    exprt, exprt, irep_full_hash, irep_full_eq> containert;
-  #else
-  typedef std::unordered_map<exprt, exprt, irep_hash> containert;
-  #endif
-
-  containert container_normal;
-
-  containert &container()
-  {
-    return container_normal;
-  }
-};
-
-simplify_expr_cachet simplify_expr_cache;
-#endif
-
 bool simplify_exprt::simplify_abs(exprt &expr)
 {
   if(expr.operands().size()!=1)
@@ -2354,25 +2332,6 @@ bool simplify_exprt::simplify_node(exprt &expr)
 /// \return returns true if expression unchanged; returns false if changed
 bool simplify_exprt::simplify_rec(exprt &expr)
 {
-  // look up in cache
-
-  #ifdef USE_CACHE
-  std::pair<simplify_expr_cachet::containert::iterator, bool>
-    cache_result=simplify_expr_cache.container().
-      insert(std::pair<exprt, exprt>(expr, exprt()));
-
-  if(!cache_result.second) // found!
-  {
-    const exprt &new_expr=cache_result.first->second;
-
-    if(new_expr.id().empty())
-      return true; // no change
-
-    expr=new_expr;
-    return false;
-  }
-  #endif
-
   // We work on a copy to prevent unnecessary destruction of sharing.
   exprt tmp=expr;
   bool result=true;
@@ -2401,11 +2360,6 @@ bool simplify_exprt::simplify_rec(exprt &expr)
   if(!result)
   {
     expr.swap(tmp);
-
-    #ifdef USE_CACHE
-    // save in cache
-    cache_result.first->second=expr;
-    #endif
   }
 
   return result;
@@ -2417,11 +2371,32 @@ bool simplify_exprt::simplify(exprt &expr)
   if(debug_on)
     std::cout << "TO-SIMP " << format(expr) << "\n";
 #endif
+  // The cache is only consulted for entire expressions: computing the
+  // full hash of every subexpression would cost more than it saves.
+  simplify_expr_cachet *const memo=
+    do_simplify_if && local_replace_map.empty()?cache:nullptr;
+
+  exprt cached;
+  if(memo!=nullptr && memo->lookup(expr, cached))
+  {
+    if(cached.is_nil())
+      return true; // no change
+
+    expr=cached;
+    return false;
+  }
+
+  const exprt original=expr;
   bool res=simplify_rec(expr);
 #ifdef DEBUG_ON_DEMAND
   if(debug_on)
     std::cout << "FULLSIMP " << format(expr) << "\n";
 #endif
+  hash_cons(expr);
+
+  if(memo!=nullptr)
+    memo->insert(original, res?nil_exprt():expr);
+
   return res;
 }
 
@@ -0,0 +1,52 @@
+/*******************************************************************\
+
+Module: Bounded Cache of Simplifier Results
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Bounded Cache of Simplifier Results
+
+#include "simplify_expr_cache.h"
+
+simplify_expr_cachet::simplify_expr_cachet(std::size_t capacity):
+  generation_size(capacity<2?1:capacity/2)
+{
+}
+
+bool simplify_expr_cachet::lookup(const exprt &expr, exprt &result)
+{
+  containert::const_iterator entry=current.find(expr);
+  if(entry!=current.end())
+  {
+    statistics.hits++;
+    result=entry->second;
+    return true;
+  }
+
+  entry=previous.find(expr);
+  if(entry!=previous.end())
+  {
+    statistics.hits++;
+    result=entry->second;
+    insert(expr, result);
+    return true;
+  }
+
+  statistics.misses++;
+  return false;
+}
+
+void simplify_expr_cachet::insert(const exprt &expr, const exprt &result)
+{
+  if(current.size()>=generation_size)
+  {
+    previous.clear();
+    previous.swap(current);
+    statistics.evictions++;
+  }
+
+  current[expr]=result;
+}
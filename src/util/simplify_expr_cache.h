@@ -0,0 +1,68 @@
+/*******************************************************************\
+
+Module: Bounded Cache of Simplifier Results
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Bounded Cache of Simplifier Results
+
+#ifndef CPROVER_UTIL_SIMPLIFY_EXPR_CACHE_H
+#define CPROVER_UTIL_SIMPLIFY_EXPR_CACHE_H
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "expr.h"
+
+struct simplify_expr_cache_statisticst
+{
+  std::size_t hits=0;
+  std::size_t misses=0;
+  /// number of times the oldest entries were dropped
+  std::size_t evictions=0;
+};
+
+/// \brief Bounded memo of simplifier results
+///
+/// Entries are kept in two generations of at most half the capacity each.
+/// Once the current generation is full, the previous one is dropped and the
+/// current one takes its place. Entries that are found in the previous
+/// generation are moved to the current one, such that expressions that keep
+/// being simplified stay in the cache.
+class simplify_expr_cachet
+{
+public:
+  explicit simplify_expr_cachet(std::size_t capacity);
+
+  /// \param expr: expression to be simplified
+  /// \param [out] result: the simplified expression, or a nil expression if
+  ///   simplification did not change \p expr
+  /// \return true if \p expr was found
+  bool lookup(const exprt &expr, exprt &result);
+
+  /// Record that \p expr simplifies to \p result (nil if unchanged)
+  void insert(const exprt &expr, const exprt &result);
+
+  const simplify_expr_cache_statisticst &get_statistics() const
+  {
+    return statistics;
+  }
+
+  std::size_t size() const
+  {
+    return current.size()+previous.size();
+  }
+
+protected:
+  typedef std::unordered_map<exprt, exprt, irep_full_hash, irep_full_eq>
+    containert;
+
+  std::size_t generation_size;
+  containert current, previous;
+  simplify_expr_cache_statisticst statistics;
+};
+
+#endif // CPROVER_UTIL_SIMPLIFY_EXPR_CACHE_H
@@ -30,6 +30,7 @@ class index_exprt;
 class member_exprt;
 class namespacet;
 class popcount_exprt;
+class simplify_expr_cachet;
 class tvt;
 
 #define forall_value_list(it, value_list) \
@@ -41,6 +42,7 @@ class simplify_exprt
 public:
   explicit simplify_exprt(const namespacet &_ns):
     do_simplify_if(true),
+    cache(nullptr),
     ns(_ns)
 #ifdef DEBUG_ON_DEMAND
     , debug_on(false)
@@ -58,6 +60,11 @@ public:
 
   bool do_simplify_if;
 
+  /// Results for complete expressions, or nullptr for none. The results
+  /// depend on the namespace, so a cache must only be used by simplifiers
+  /// with the same namespace.
+  simplify_expr_cachet *cache;
+
   // These below all return 'true' if the simplification wasn't applicable.
   // If false is returned, the expression has changed.
 
@@ -8,8 +8,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "ssa_expr.h"
 
-#include <sstream>
 #include <cassert>
+#include <string>
 
 #include <util/arith_tools.h>
 
@@ -18,53 +18,62 @@ static void build_ssa_identifier_rec(
   const irep_idt &l0,
   const irep_idt &l1,
   const irep_idt &l2,
-  std::ostream &os,
-  std::ostream &l1_object_os)
+  std::string &id,
+  std::string &l1_object_id)
 {
   if(expr.id()==ID_member)
   {
     const member_exprt &member=to_member_expr(expr);
 
-    build_ssa_identifier_rec(member.struct_op(), l0, l1, l2, os, l1_object_os);
+    build_ssa_identifier_rec(member.struct_op(), l0, l1, l2, id, l1_object_id);
 
-    os << '.' << member.get_component_name();
+    id+='.';
+    id+=id2string(member.get_component_name());
   }
   else if(expr.id()==ID_index)
   {
     const index_exprt &index=to_index_expr(expr);
 
-    build_ssa_identifier_rec(index.array(), l0, l1, l2, os, l1_object_os);
+    build_ssa_identifier_rec(index.array(), l0, l1, l2, id, l1_object_id);
 
     mp_integer idx;
     if(to_integer(to_constant_expr(index.index()), idx))
       UNREACHABLE;
 
-    os << '[' << idx << ']';
+    id+='[';
+    id+=integer2string(idx);
+    id+=']';
   }
   else if(expr.id()==ID_symbol)
   {
-    auto symid=to_symbol_expr(expr).get_identifier();
-    os << symid;
-    l1_object_os << symid;
+    const std::string &symid=
+      id2string(to_symbol_expr(expr).get_identifier());
+    id+=symid;
+    l1_object_id+=symid;
 
     if(!l0.empty())
     {
       // Distinguish different threads of execution
-      os << '!' << l0;
-      l1_object_os << '!' << l0;
+      id+='!';
+      id+=id2string(l0);
+      l1_object_id+='!';
+      l1_object_id+=id2string(l0);
     }
 
     if(!l1.empty())
     {
       // Distinguish different calls to the same function (~stack frame)
-      os << '@' << l1;
-      l1_object_os << '@' << l1;
+      id+='@';
+      id+=id2string(l1);
+      l1_object_id+='@';
+      l1_object_id+=id2string(l1);
     }
 
     if(!l2.empty())
     {
       // Distinguish SSA steps for the same variable
-      os << '#' << l2;
+      id+='#';
+      id+=id2string(l2);
     }
   }
   else
@@ -90,10 +99,10 @@ std::pair<irep_idt, irep_idt> ssa_exprt::build_identifier(
   const irep_idt &l1,
   const irep_idt &l2)
 {
-  std::ostringstream oss;
-  std::ostringstream l1_object_oss;
+  std::string id;
+  std::string l1_object_id;
 
-  build_ssa_identifier_rec(expr, l0, l1, l2, oss, l1_object_oss);
+  build_ssa_identifier_rec(expr, l0, l1, l2, id, l1_object_id);
 
-  return std::make_pair(irep_idt(oss.str()), irep_idt(l1_object_oss.str()));
+  return std::make_pair(irep_idt(id), irep_idt(l1_object_id));
 }
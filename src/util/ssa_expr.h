@@ -119,6 +119,11 @@ public:
     return get(ID_L2);
   }
 
+  /// Renders the identifier symbol!l0\@l1#l2 into the irep. This happens
+  /// eagerly, on every change of a level: the identifier is part of the
+  /// hash and equality of every expression containing the symbol, and is
+  /// read directly by symex, the solvers and the trace, so there is no
+  /// separate numeric key that could be rendered on demand.
   void update_identifier()
   {
     const irep_idt &l0=get_level_0();
@@ -0,0 +1,208 @@
+/*******************************************************************\
+
+Module: Pool of Worker Processes
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Pool of Worker Processes
+
+#include "worker_pool.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "invariant.h"
+#include "signal_catcher.h"
+
+worker_poolt::worker_poolt(
+  std::size_t _max_workers,
+  bool _capture_output,
+  bool _run_in_process):
+  max_workers(_max_workers==0?1:_max_workers),
+  capture_output(_capture_output),
+  run_in_process(_run_in_process),
+  next_job_id(0)
+{
+}
+
+worker_poolt::~worker_poolt()
+{
+  kill_all();
+}
+
+/// Run a job, mapping any exception escaping it to exit status 255
+int worker_poolt::run_job(const jobt &job)
+{
+  try
+  {
+    return job();
+  }
+  catch(...)
+  {
+    return 255;
+  }
+}
+
+void worker_poolt::run_synchronously(std::size_t job_id, const jobt &job)
+{
+  finishedt finished;
+  finished.job_id=job_id;
+  finished.exit_status=run_in_process?run_job(job):not_run;
+  done.push_back(finished);
+}
+
+#ifndef _WIN32
+static std::string read_file(const std::string &file_name)
+{
+  std::ifstream in(file_name, std::ios::binary);
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  return buffer.str();
+}
+#endif
+
+std::size_t worker_poolt::start(jobt job)
+{
+  PRECONDITION(!full());
+
+  const std::size_t job_id=next_job_id++;
+
+  std::unique_ptr<temporary_filet> output_file;
+  if(capture_output)
+    output_file=std::unique_ptr<temporary_filet>(
+      new temporary_filet("cbmc_worker_", ".out"));
+
+  #ifdef _WIN32
+  // no fork: run the job right away, without capturing its output
+  run_synchronously(job_id, job);
+  #else
+  // anything buffered would otherwise be written by both processes
+  std::cout.flush();
+  std::cerr.flush();
+  fflush(stdout);
+  fflush(stderr);
+
+  pid_t pid=fork();
+
+  if(pid==-1)
+  {
+    // we can't fork, do the job ourselves
+    run_synchronously(job_id, job);
+    return job_id;
+  }
+
+  if(pid==0)
+  {
+    // child: the parent takes care of terminating us
+    remove_signal_catcher();
+
+    if(output_file)
+    {
+      int fd=open((*output_file)().c_str(), O_WRONLY|O_TRUNC);
+      if(fd!=-1)
+      {
+        dup2(fd, STDOUT_FILENO);
+        close(fd);
+      }
+    }
+
+    int exit_status=run_job(job);
+
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(stdout);
+    fflush(stderr);
+
+    // don't run any destructors or atexit handlers of the parent's objects
+    _exit(exit_status);
+  }
+
+  running.insert(std::make_pair(pid, workert(job_id, std::move(output_file))));
+  #endif
+
+  return job_id;
+}
+
+bool worker_poolt::wait_any(finishedt &finished)
+{
+  if(!done.empty())
+  {
+    finished=done.front();
+    done.pop_front();
+    return true;
+  }
+
+  #ifndef _WIN32
+  while(!running.empty())
+  {
+    int status;
+    pid_t pid=waitpid(-1, &status, 0);
+
+    if(pid==-1)
+    {
+      if(errno==EINTR)
+        continue;
+
+      // no children left to wait for: whatever is still recorded as running
+      // has gone missing
+      const auto it=running.begin();
+      finished.job_id=it->second.job_id;
+      finished.exit_status=255;
+      finished.output.clear();
+      running.erase(it);
+      return true;
+    }
+
+    const auto it=running.find(pid);
+
+    // not one of ours
+    if(it==running.end())
+      continue;
+
+    finished.job_id=it->second.job_id;
+    finished.exit_status=
+      WIFEXITED(status)?WEXITSTATUS(status):255;
+    finished.output=
+      it->second.output_file?read_file((*it->second.output_file)()):"";
+    running.erase(it);
+    return true;
+  }
+  #endif
+
+  return false;
+}
+
+void worker_poolt::kill_all()
+{
+  #ifndef _WIN32
+  for(const auto &worker : running)
+    kill(worker.first, SIGKILL);
+
+  for(const auto &worker : running)
+  {
+    int status;
+    while(waitpid(worker.first, &status, 0)==-1 && errno==EINTR)
+    {
+    }
+  }
+  #endif
+
+  running.clear();
+  done.clear();
+}
@@ -0,0 +1,133 @@
+/*******************************************************************\
+
+Module: Pool of Worker Processes
+
+Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Pool of Worker Processes
+
+#ifndef CPROVER_UTIL_WORKER_POOL_H
+#define CPROVER_UTIL_WORKER_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "tempfile.h"
+
+/// \brief Runs jobs concurrently in forked worker processes
+///
+/// Large parts of the code base (reference-counted `irept` sharing, the
+/// global `string_containert`, static counters in symex) are not
+/// thread-safe. Jobs are therefore run in child processes that inherit a
+/// copy-on-write snapshot of the parent's memory. A job communicates its
+/// result through its return value, which becomes the exit status of the
+/// worker (and must thus be in the range 0..255), and, optionally, through
+/// its standard output, which can be captured and handed back to the parent
+/// once the job has finished. This allows callers to replay the output of
+/// the workers in a deterministic order.
+///
+/// On platforms without `fork`, or if `fork` fails, jobs are run
+/// synchronously in `start`, unless the pool was told that jobs must not
+/// affect the state of the parent. Such jobs are not run at all instead,
+/// and are reported with exit status `not_run`.
+class worker_poolt
+{
+public:
+  typedef std::function<int()> jobt;
+
+  /// Exit status of a job that could not be run in a separate process
+  static const int not_run=-1;
+
+  /// \param _max_workers: the maximum number of concurrently running workers
+  /// \param _capture_output: whether the standard output of each worker is
+  ///   to be captured rather than written to the terminal
+  /// \param _run_in_process: whether a job may be run in the calling process
+  ///   when no worker process can be created
+  worker_poolt(
+    std::size_t _max_workers,
+    bool _capture_output,
+    bool _run_in_process=true);
+
+  worker_poolt(const worker_poolt &)=delete;
+
+  /// Kills any workers that are still running
+  ~worker_poolt();
+
+  struct finishedt
+  {
+    std::size_t job_id;
+    int exit_status;
+    /// The standard output of the job, if captured
+    std::string output;
+  };
+
+  /// Start a job in a fresh worker. The caller must make sure that the pool
+  /// is not full(), by calling wait_any() otherwise.
+  /// \return an identifier for the job, counting from zero in the order in
+  ///   which jobs are started
+  std::size_t start(jobt job);
+
+  /// Block until some job has finished.
+  /// \param [out] finished: the identifier, exit status and output of the job
+  /// \return false if there are no jobs left to wait for
+  bool wait_any(finishedt &finished);
+
+  /// Terminate all running workers without collecting their results
+  void kill_all();
+
+  bool full() const
+  {
+    return running.size()>=max_workers;
+  }
+
+  bool empty() const
+  {
+    return running.empty() && done.empty();
+  }
+
+  std::size_t max_workers_count() const
+  {
+    return max_workers;
+  }
+
+protected:
+  std::size_t max_workers;
+  bool capture_output;
+  bool run_in_process;
+  std::size_t next_job_id;
+
+  struct workert
+  {
+    std::size_t job_id;
+    // null unless output is captured
+    std::unique_ptr<temporary_filet> output_file;
+
+    workert(
+      std::size_t _job_id,
+      std::unique_ptr<temporary_filet> _output_file):
+      job_id(_job_id),
+      output_file(std::move(_output_file))
+    {
+    }
+  };
+
+  // indexed by process id
+  std::map<int, workert> running;
+
+  // jobs that have completed but have not been reported by wait_any yet
+  std::list<finishedt> done;
+
+  static int run_job(const jobt &);
+
+  /// Run \p job in the calling process, or not at all if that isn't allowed
+  void run_synchronously(std::size_t job_id, const jobt &job);
+};
+
+#endif // CPROVER_UTIL_WORKER_POOL_H
@@ -0,0 +1,88 @@
+/*******************************************************************\
+
+ Module: Unit tests for the function-modular mode of ai_baset
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for the function-modular mode of ai_baset
+
+#include <testing-utils/catch.hpp>
+
+#include <analyses/interval_domain.h>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/std_code.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+SCENARIO("ai_function_modular", "[core][analyses][ai][function_modular]")
+{
+  symbol_tablet symbol_table;
+  const signedbv_typet int_type(32);
+  const symbol_exprt g("g", int_type), x("main::x", int_type);
+
+  symbolt g_symbol;
+  g_symbol.name=g_symbol.base_name=g.get_identifier();
+  g_symbol.type=int_type;
+  g_symbol.is_static_lifetime=true;
+  symbol_table.add(g_symbol);
+
+  const namespacet ns(symbol_table);
+
+  // void f() { g=1; }
+  // void main() { x=5; g=2; f(); }
+  goto_functionst goto_functions;
+
+  goto_programt &f=goto_functions.function_map["f"].body;
+  goto_programt::targett assign_g=f.add_instruction(ASSIGN);
+  assign_g->code=code_assignt(g, from_integer(1, int_type));
+  f.add_instruction(END_FUNCTION);
+
+  goto_programt &main=goto_functions.function_map["main"].body;
+  goto_programt::targett assign_x=main.add_instruction(ASSIGN);
+  assign_x->code=code_assignt(x, from_integer(5, int_type));
+  goto_programt::targett assign_g_main=main.add_instruction(ASSIGN);
+  assign_g_main->code=code_assignt(g, from_integer(2, int_type));
+  goto_programt::targett call=main.add_instruction(FUNCTION_CALL);
+  code_function_callt function_call;
+  function_call.function()=symbol_exprt("f", code_typet());
+  call->code=function_call;
+  goto_programt::targett end=main.add_instruction(END_FUNCTION);
+
+  for(auto &function : goto_functions.function_map)
+    for(auto &instruction : function.second.body.instructions)
+      instruction.function=function.first;
+
+  goto_functions.update();
+
+  ait<interval_domaint> analysis;
+  analysis.set_function_modular(true);
+  analysis(goto_functions, ns);
+
+  THEN("Callees come before their callers")
+  {
+    const auto &components=analysis.function_components();
+    REQUIRE(components.size()==2);
+    REQUIRE(components[0]==ai_baset::componentt{ "f" });
+    REQUIRE(components[1]==ai_baset::componentt{ "main" });
+  }
+
+  THEN("Functions are analysed independently of their callers")
+  {
+    REQUIRE(analysis[assign_g].make_expression(g).is_true());
+    REQUIRE(!analysis[assign_g].is_bottom());
+  }
+
+  THEN("Calls only forget what the called function may modify")
+  {
+    REQUIRE(analysis[end].make_expression(g).is_true());
+    REQUIRE(
+      analysis[end].make_expression(x)==
+      analysis[call].make_expression(x));
+    REQUIRE(!analysis[end].make_expression(x).is_true());
+  }
+}
@@ -0,0 +1,102 @@
+/*******************************************************************\
+
+ Module: Unit tests for sparse states in ait
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for sparse states in ait
+
+#include <testing-utils/catch.hpp>
+
+#include <analyses/interval_domain.h>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+class sparse_interval_analysist:public ait<interval_domaint>
+{
+public:
+  std::size_t stored_states() const
+  {
+    return state_map.size();
+  }
+};
+
+SCENARIO("ai_sparse_states", "[core][analyses][ai][sparse_states]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const signedbv_typet int_type(32);
+  const symbol_exprt i("i", int_type), j("j", int_type);
+
+  // i=0; while(i<100) { j=i; j=j+2; i=j-1; } j=i;
+  goto_programt program;
+
+  goto_programt::targett init=program.add_instruction(ASSIGN);
+  init->code=code_assignt(i, from_integer(0, int_type));
+
+  goto_programt::targett head=program.add_instruction(GOTO);
+  head->guard=
+    not_exprt(binary_relation_exprt(i, ID_lt, from_integer(100, int_type)));
+
+  goto_programt::targett copy=program.add_instruction(ASSIGN);
+  copy->code=code_assignt(j, i);
+
+  goto_programt::targett add=program.add_instruction(ASSIGN);
+  add->code=code_assignt(j, plus_exprt(j, from_integer(2, int_type)));
+
+  goto_programt::targett sub=program.add_instruction(ASSIGN);
+  sub->code=code_assignt(i, minus_exprt(j, from_integer(1, int_type)));
+
+  goto_programt::targett back=program.add_instruction(GOTO);
+  back->guard=true_exprt();
+  back->targets.push_back(head);
+
+  goto_programt::targett exit=program.add_instruction(ASSIGN);
+  exit->code=code_assignt(j, i);
+  head->targets.push_back(exit);
+
+  program.add_instruction(END_FUNCTION);
+  program.update();
+
+  sparse_interval_analysist dense, sparse;
+  sparse.set_sparse_states(true);
+
+  dense(program, ns);
+  sparse(program, ns);
+
+  THEN("Only the states at block heads are stored")
+  {
+    REQUIRE(dense.stored_states()==program.instructions.size());
+    // the first instruction, the loop head, the loop body, the exit
+    // and the end of the function
+    REQUIRE(sparse.stored_states()==5);
+  }
+
+  THEN("The states of all instructions are the same as without sparse states")
+  {
+    forall_goto_program_instructions(it, program)
+    {
+      REQUIRE(
+        sparse[it].make_expression(i)==dense[it].make_expression(i));
+      REQUIRE(
+        sparse[it].make_expression(j)==dense[it].make_expression(j));
+    }
+  }
+
+  THEN("The states after instructions are recomputed, too")
+  {
+    const exprt after_add=
+      static_cast<const interval_domaint &>(sparse.abstract_state_after(add))
+        .make_expression(j);
+    REQUIRE(
+      after_add==
+      static_cast<const interval_domaint &>(dense.abstract_state_after(add))
+        .make_expression(j));
+  }
+}
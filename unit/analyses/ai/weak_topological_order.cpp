@@ -0,0 +1,134 @@
+/*******************************************************************\
+
+ Module: Unit tests for the weak topological order of ai_baset
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for the weak topological order of ai_baset
+
+#include <testing-utils/catch.hpp>
+
+#include <analyses/interval_domain.h>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+class wto_interval_analysist:public ait<interval_domaint>
+{
+public:
+  const wtot &wto(const goto_programt &goto_program)
+  {
+    return get_wto(goto_program);
+  }
+};
+
+SCENARIO(
+  "ai_weak_topological_order",
+  "[core][analyses][ai][weak_topological_order]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const signedbv_typet int_type(32);
+  const symbol_exprt i("i", int_type), j("j", int_type), k("k", int_type);
+
+  // i=0; k=0;
+  // while(i<10) { j=0; while(j<10) { j=j+1; k=k+1; } i=i+1; }
+  // k=i;
+  goto_programt program;
+
+  goto_programt::targett init_i=program.add_instruction(ASSIGN);
+  init_i->code=code_assignt(i, from_integer(0, int_type));
+  goto_programt::targett init_k=program.add_instruction(ASSIGN);
+  init_k->code=code_assignt(k, from_integer(0, int_type));
+
+  goto_programt::targett outer_head=program.add_instruction(GOTO);
+  outer_head->guard=
+    not_exprt(binary_relation_exprt(i, ID_lt, from_integer(10, int_type)));
+
+  goto_programt::targett init_j=program.add_instruction(ASSIGN);
+  init_j->code=code_assignt(j, from_integer(0, int_type));
+
+  goto_programt::targett inner_head=program.add_instruction(GOTO);
+  inner_head->guard=
+    not_exprt(binary_relation_exprt(j, ID_lt, from_integer(10, int_type)));
+
+  goto_programt::targett inc_j=program.add_instruction(ASSIGN);
+  inc_j->code=code_assignt(j, plus_exprt(j, from_integer(1, int_type)));
+  goto_programt::targett inc_k=program.add_instruction(ASSIGN);
+  inc_k->code=code_assignt(k, plus_exprt(k, from_integer(1, int_type)));
+
+  goto_programt::targett inner_back=program.add_instruction(GOTO);
+  inner_back->guard=true_exprt();
+  inner_back->targets.push_back(inner_head);
+
+  goto_programt::targett inc_i=program.add_instruction(ASSIGN);
+  inc_i->code=code_assignt(i, plus_exprt(i, from_integer(1, int_type)));
+  inner_head->targets.push_back(inc_i);
+
+  goto_programt::targett outer_back=program.add_instruction(GOTO);
+  outer_back->guard=true_exprt();
+  outer_back->targets.push_back(outer_head);
+
+  goto_programt::targett exit=program.add_instruction(ASSIGN);
+  exit->code=code_assignt(k, i);
+  outer_head->targets.push_back(exit);
+
+  goto_programt::targett end=program.add_instruction(END_FUNCTION);
+
+  for(auto &instruction : program.instructions)
+    instruction.function="main";
+
+  program.update();
+
+  wto_interval_analysist by_number, by_wto;
+  by_wto.set_weak_topological_order(true);
+
+  THEN("The loops are nested components of the order")
+  {
+    const auto &wto=by_wto.wto(program);
+    REQUIRE(wto.size()==program.instructions.size());
+
+    // init_i init_k (outer_head init_j (inner_head inc_j inc_k inner_back)
+    //   inc_i outer_back) exit end
+    REQUIRE(wto[2].location==outer_head);
+    REQUIRE(wto[2].component_end==10);
+    REQUIRE(wto[4].location==inner_head);
+    REQUIRE(wto[4].component_end==8);
+    REQUIRE(wto[8].location==inc_i);
+    REQUIRE(wto[10].location==exit);
+    REQUIRE(wto[11].location==end);
+
+    for(std::size_t index=0; index<wto.size(); index++)
+      if(index!=2 && index!=4)
+        REQUIRE(wto[index].component_end==0);
+  }
+
+  by_number(program, ns);
+  by_wto(program, ns);
+
+  THEN("The states are the same as in the order of the location numbers")
+  {
+    forall_goto_program_instructions(it, program)
+    {
+      REQUIRE(by_wto[it].make_expression(i)==by_number[it].make_expression(i));
+      REQUIRE(by_wto[it].make_expression(j)==by_number[it].make_expression(j));
+      REQUIRE(by_wto[it].make_expression(k)==by_number[it].make_expression(k));
+    }
+  }
+
+  THEN("Iterations are counted per function")
+  {
+    const auto &statistics=by_wto.get_iteration_statistics();
+    REQUIRE(statistics.size()==1);
+    REQUIRE(statistics.at("main").fixedpoints==1);
+    REQUIRE(statistics.at("main").visits>=program.instructions.size());
+    REQUIRE(
+      statistics.at("main").visits<=
+      by_number.get_iteration_statistics().at("main").visits);
+  }
+}
@@ -0,0 +1,166 @@
+/*******************************************************************\
+
+ Module: Unit tests for widening and narrowing in ai_baset
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for widening and narrowing in ai_baset
+
+#include <testing-utils/catch.hpp>
+
+#include <analyses/interval_domain.h>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+class interval_analysist:public ait<interval_domaint>
+{
+public:
+  integer_intervalt interval(locationt l, const symbol_exprt &symbol) const
+  {
+    const exprt bounds=(*this)[l].make_expression(symbol);
+    integer_intervalt result;
+
+    if(bounds.is_false())
+      return integer_intervalt(1, 0);
+
+    for(const auto &bound : bounds.id()==ID_and?bounds.operands():
+        exprt::operandst{ bounds })
+    {
+      if(bound.id()!=ID_le)
+        continue;
+
+      mp_integer value;
+      if(bound.op0()==symbol && !to_integer(bound.op1(), value))
+        result.make_le_than(value);
+      else if(bound.op1()==symbol && !to_integer(bound.op0(), value))
+        result.make_ge_than(value);
+    }
+
+    return result;
+  }
+
+  std::size_t get_widenings() const
+  {
+    return widenings;
+  }
+};
+
+SCENARIO("ai_widening", "[core][analyses][ai][widening]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const signedbv_typet int_type(32);
+  const symbol_exprt i("i", int_type);
+  const exprt limit=from_integer(1000000, int_type);
+
+  // i=0; while(i<1000000) i=i+1;
+  goto_programt program;
+
+  goto_programt::targett init=program.add_instruction(ASSIGN);
+  init->code=code_assignt(i, from_integer(0, int_type));
+
+  goto_programt::targett head=program.add_instruction(GOTO);
+  head->guard=not_exprt(binary_relation_exprt(i, ID_lt, limit));
+
+  goto_programt::targett increment=program.add_instruction(ASSIGN);
+  increment->code=code_assignt(i, plus_exprt(i, from_integer(1, int_type)));
+
+  goto_programt::targett back=program.add_instruction(GOTO);
+  back->guard=true_exprt();
+  back->targets.push_back(head);
+
+  goto_programt::targett exit=program.add_instruction(SKIP);
+  head->targets.push_back(exit);
+
+  program.add_instruction(END_FUNCTION);
+  program.update();
+
+  interval_analysist analysis;
+
+  GIVEN("Widening without narrowing")
+  {
+    analysis.set_narrowing_iterations(0);
+    analysis(program, ns);
+
+    THEN("The loop converges after dropping the upper bound")
+    {
+      REQUIRE(analysis.get_widenings()>=1);
+      REQUIRE(analysis.interval(head, i)==lower_interval(mp_integer(0)));
+      REQUIRE(analysis.interval(exit, i)==lower_interval(mp_integer(1000000)));
+    }
+  }
+
+  GIVEN("Widening and narrowing")
+  {
+    analysis(program, ns);
+
+    THEN("The bound of the loop is recovered")
+    {
+      REQUIRE(
+        analysis.interval(head, i)==
+        integer_intervalt(mp_integer(0), mp_integer(1000000)));
+      REQUIRE(
+        analysis.interval(increment, i)==
+        integer_intervalt(mp_integer(0), mp_integer(999999)));
+      REQUIRE(analysis.interval(exit, i)==integer_intervalt(mp_integer(1000000)));
+    }
+  }
+
+  GIVEN("A loop that is shorter than the widening delay")
+  {
+    head->guard=not_exprt(
+      binary_relation_exprt(i, ID_lt, from_integer(2, int_type)));
+    analysis(program, ns);
+
+    THEN("No widening is needed")
+    {
+      REQUIRE(analysis.get_widenings()==0);
+      REQUIRE(analysis.interval(exit, i)==integer_intervalt(mp_integer(2)));
+    }
+  }
+}
+
+SCENARIO("ai_interval_wrap_around", "[core][analyses][ai][widening]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const unsignedbv_typet unsigned_type(32);
+  const symbol_exprt x("x", unsigned_type);
+  const symbol_exprt y("y", unsigned_type);
+
+  // unsigned x; assume(x>0); y=x+1; assert(y>1);
+  goto_programt program;
+
+  goto_programt::targett assumption=program.add_instruction(ASSUME);
+  assumption->guard=
+    binary_relation_exprt(x, ID_gt, from_integer(0, unsigned_type));
+
+  goto_programt::targett assign=program.add_instruction(ASSIGN);
+  assign->code=code_assignt(y, plus_exprt(x, from_integer(1, unsigned_type)));
+
+  goto_programt::targett assertion=program.add_instruction(ASSERT);
+  assertion->guard=
+    binary_relation_exprt(y, ID_gt, from_integer(1, unsigned_type));
+
+  program.add_instruction(END_FUNCTION);
+  program.update();
+
+  interval_analysist analysis;
+  analysis(program, ns);
+
+  THEN("The lower bound of x is known, and y may wrap around to 0")
+  {
+    REQUIRE(analysis.interval(assign, x)==lower_interval(mp_integer(1)));
+    REQUIRE(analysis.interval(assertion, y)==integer_intervalt());
+
+    exprt condition=assertion->guard;
+    analysis[assertion].ai_simplify(condition, ns);
+    REQUIRE(!condition.is_true());
+  }
+}
@@ -154,5 +154,45 @@ SCENARIO("dependence_graph", "[core][analyses][dependence_graph]")
         }
       }
     }
+
+    WHEN("Constructing a dependence graph with sparse states")
+    {
+      dependence_grapht dep_graph(ns), sparse_dep_graph(ns);
+      sparse_dep_graph.set_sparse_states(true);
+      dep_graph(goto_model.goto_functions, ns);
+      sparse_dep_graph(goto_model.goto_functions, ns);
+
+      THEN("The graph is the same as without sparse states")
+      {
+        REQUIRE(sparse_dep_graph.size() == dep_graph.size());
+
+        for(std::size_t node_idx = 0; node_idx < dep_graph.size(); ++node_idx)
+        {
+          const dep_nodet &node = dep_graph[node_idx];
+          const dep_nodet &sparse_node = sparse_dep_graph[node_idx];
+          REQUIRE(sparse_node.PC == node.PC);
+          REQUIRE(sparse_node.in.size() == node.in.size());
+          REQUIRE(sparse_node.out.size() == node.out.size());
+
+          for(const auto &dep_edge : node.in)
+          {
+            REQUIRE(sparse_node.in.count(dep_edge.first));
+            REQUIRE(
+              sparse_node.in.at(dep_edge.first).get() ==
+              dep_edge.second.get());
+          }
+
+          const dep_graph_domaint &sparse_domain =
+            sparse_dep_graph[sparse_node.PC];
+          REQUIRE(sparse_domain.get_node_id() == node_idx);
+          REQUIRE(
+            dependence_graph_test_get_control_deps(sparse_domain) ==
+            dependence_graph_test_get_control_deps(dep_graph[node.PC]));
+          REQUIRE(
+            dependence_graph_test_get_data_deps(sparse_domain) ==
+            dependence_graph_test_get_data_deps(dep_graph[node.PC]));
+        }
+      }
+    }
   }
 }
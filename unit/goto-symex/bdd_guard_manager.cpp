@@ -0,0 +1,63 @@
+/*******************************************************************\
+
+ Module: Unit tests for bdd_guard_managert
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for bdd_guard_managert
+
+#include <testing-utils/catch.hpp>
+
+#include <util/std_expr.h>
+
+#include <goto-symex/bdd_guard_manager.h>
+
+static guardt make_guard(const exprt &expr)
+{
+  guardt guard;
+  guard.add(expr);
+  return guard;
+}
+
+SCENARIO("bdd_guard_manager", "[core][goto-symex][bdd_guard_manager]")
+{
+  bdd_guard_managert guard_manager;
+
+  const symbol_exprt a("a", bool_typet());
+  const symbol_exprt b("b", bool_typet());
+  const symbol_exprt c("c", bool_typet());
+
+  GIVEN("Guards that are a condition and its negation")
+  {
+    const guardt g1=make_guard(a);
+    const guardt g2=make_guard(not_exprt(a));
+
+    THEN("Their disjunction is true, and their conjunction false")
+    {
+      REQUIRE(guard_manager.disjunction(g1, g2).is_true());
+      REQUIRE(guard_manager.canonical(make_guard(or_exprt(a, not_exprt(a))))
+                .is_true());
+      REQUIRE(guard_manager.canonical(make_guard(and_exprt(a, not_exprt(a))))
+                .is_false());
+    }
+  }
+
+  GIVEN("Disjunctions of the same conditions, in different orders")
+  {
+    const guardt g1=make_guard(or_exprt(a, or_exprt(b, c)));
+    const guardt g2=make_guard(or_exprt(or_exprt(c, a), b));
+
+    THEN("They have the same canonical form")
+    {
+      const guardt canonical=guard_manager.canonical(g1);
+      REQUIRE(canonical==guard_manager.canonical(g2));
+      REQUIRE(
+        canonical==guard_manager.disjunction(
+          make_guard(c), make_guard(or_exprt(b, a))));
+      REQUIRE(guard_manager.number_of_atoms()==3);
+    }
+  }
+}
@@ -0,0 +1,184 @@
+/*******************************************************************\
+
+ Module: Unit tests for word_level_preprocessing
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for word_level_preprocessing
+
+#include <testing-utils/catch.hpp>
+
+#include <util/arith_tools.h>
+#include <util/find_symbols.h>
+#include <util/namespace.h>
+#include <util/replace_expr.h>
+#include <util/simplify_expr.h>
+#include <util/ssa_expr.h>
+#include <util/std_types.h>
+#include <util/symbol_table.h>
+
+#include <goto-symex/word_level_preprocessing.h>
+
+static ssa_exprt ssa_symbol(const irep_idt &name, const typet &type)
+{
+  ssa_exprt result(symbol_exprt(name, type));
+  result.set_level_2(1);
+  return result;
+}
+
+/// The value of \p expr once \p symbol is replaced by \p value
+static exprt evaluate(
+  exprt expr,
+  const exprt &symbol,
+  const mp_integer &value,
+  const namespacet &ns)
+{
+  replace_expr(symbol, from_integer(value, symbol.type()), expr);
+  simplify(expr, ns);
+  return expr;
+}
+
+SCENARIO("word_level_preprocessing", "[core][goto-symex][word_level]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const unsignedbv_typet u64(64);
+  const unsignedbv_typet u8(8);
+  const symex_targett::sourcet source;
+
+  GIVEN("Arithmetic on values whose range is assumed")
+  {
+    symex_target_equationt equation;
+    const ssa_exprt x=ssa_symbol("x", u64), y=ssa_symbol("y", u64);
+
+    // assume(x<100); y=x*x; assert(y<=9801); assert(y!=2021);
+    equation.assumption(
+      true_exprt(), binary_relation_exprt(x, ID_lt, from_integer(100, u64)),
+      source);
+    equation.assignment(
+      true_exprt(), y, y, y, mult_exprt(x, x), source,
+      symex_targett::assignment_typet::STATE);
+    equation.assertion(
+      true_exprt(), binary_relation_exprt(y, ID_le, from_integer(9801, u64)),
+      "", source);
+    equation.assertion(
+      true_exprt(), notequal_exprt(y, from_integer(2021, u64)), "", source);
+
+    const exprt original_rhs=std::next(equation.SSA_steps.begin())->ssa_rhs;
+
+    const word_level_preprocessing_statisticst statistics=
+      word_level_preprocessing(equation, ns);
+
+    auto step=equation.SSA_steps.begin();
+    const exprt &rhs=(++step)->ssa_rhs;
+
+    THEN("The multiplication is done at the width of its result")
+    {
+      REQUIRE(rhs.id()==ID_typecast);
+      REQUIRE(rhs.op0().id()==ID_mult);
+      REQUIRE(rhs.op0().type()==unsignedbv_typet(14));
+      REQUIRE(step->cond_expr==equal_exprt(y, rhs));
+
+      REQUIRE(statistics.narrowings.size()>=2);
+      REQUIRE(statistics.narrowings[0].id==ID_mult);
+      REQUIRE(statistics.narrowings[0].from_width==64);
+      REQUIRE(statistics.narrowings[0].to_width==14);
+
+      for(const int value : { 0, 1, 42, 99 })
+        REQUIRE(
+          evaluate(rhs, x, value, ns)==evaluate(original_rhs, x, value, ns));
+    }
+
+    THEN("Comparisons implied by the ranges are decided")
+    {
+      REQUIRE((++step)->cond_expr.is_true());
+      REQUIRE(statistics.decided==1);
+    }
+
+    THEN("Other comparisons are done at a smaller width")
+    {
+      const exprt &assertion=equation.SSA_steps.back().cond_expr;
+      REQUIRE(assertion.id()==ID_notequal);
+      REQUIRE(assertion.op0().type()==unsignedbv_typet(14));
+      REQUIRE(
+        assertion.op1()==from_integer(2021, unsignedbv_typet(14)));
+    }
+  }
+
+  GIVEN("Assignments of copies and of values of small types")
+  {
+    symex_target_equationt equation;
+    const ssa_exprt a=ssa_symbol("a", u8), b=ssa_symbol("b", u64),
+      c=ssa_symbol("c", u64), d=ssa_symbol("d", u64);
+
+    // b=(u64)a; c=b; d=c+(c&15);
+    equation.assignment(
+      true_exprt(), b, b, b, typecast_exprt(a, u64), source,
+      symex_targett::assignment_typet::STATE);
+    equation.assignment(
+      true_exprt(), c, c, c, b, source,
+      symex_targett::assignment_typet::STATE);
+    equation.assignment(
+      true_exprt(), d, d, d,
+      plus_exprt(c, bitand_exprt(c, from_integer(15, u64))), source,
+      symex_targett::assignment_typet::STATE);
+
+    exprt original_rhs=equation.SSA_steps.back().ssa_rhs;
+    replace_expr(c, typecast_exprt(a, u64), original_rhs);
+
+    const word_level_preprocessing_statisticst statistics=
+      word_level_preprocessing(equation, ns);
+
+    exprt rhs=equation.SSA_steps.back().ssa_rhs;
+
+    THEN("Copies are substituted and the addition is narrowed")
+    {
+      REQUIRE(statistics.substitutions>=1);
+      REQUIRE(rhs.id()==ID_typecast);
+      REQUIRE(rhs.op0().id()==ID_plus);
+      REQUIRE(rhs.op0().type()==unsignedbv_typet(9));
+      REQUIRE(!has_symbol(rhs, { c.get_identifier() }));
+
+      replace_expr(b, typecast_exprt(a, u64), rhs);
+      const exprt expected=evaluate(original_rhs, a, 200, ns);
+      REQUIRE(evaluate(rhs, a, 200, ns)==expected);
+      REQUIRE(expected==from_integer(208, u64));
+    }
+  }
+
+  GIVEN("The same comparison before and after an assumption")
+  {
+    symex_target_equationt equation;
+    const ssa_exprt x=ssa_symbol("x", u64), z=ssa_symbol("z", u64);
+    const binary_relation_exprt x_small(x, ID_lt, from_integer(50, u64));
+    const binary_relation_exprt z_small(z, ID_lt, from_integer(50, u64));
+
+    // assert(x<50); assert(z<50); assume(x<10); assert(x<50); assert(z<50);
+    equation.assertion(true_exprt(), x_small, "", source);
+    equation.assertion(true_exprt(), z_small, "", source);
+    equation.assumption(
+      true_exprt(), binary_relation_exprt(x, ID_lt, from_integer(10, u64)),
+      source);
+    equation.assertion(true_exprt(), x_small, "", source);
+    equation.assertion(true_exprt(), z_small, "", source);
+
+    word_level_preprocessing(equation, ns);
+
+    auto step=equation.SSA_steps.begin();
+    const exprt &x_before=(step++)->cond_expr;
+    const exprt &z_before=(step++)->cond_expr;
+    const exprt &x_after=(++step)->cond_expr;
+    const exprt &z_after=(++step)->cond_expr;
+
+    THEN("Only the comparison that depends on the assumption is decided")
+    {
+      REQUIRE(!x_before.is_constant());
+      REQUIRE(!z_before.is_constant());
+      REQUIRE(x_after.is_true());
+      REQUIRE(z_after==z_before);
+    }
+  }
+}
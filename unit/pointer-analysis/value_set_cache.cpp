@@ -0,0 +1,174 @@
+/*******************************************************************\
+
+ Module: Unit tests for value_set_cachet
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for value_set_cachet
+
+#include <testing-utils/catch.hpp>
+
+#include <sstream>
+
+#include <pointer-analysis/value_set_analysis.h>
+
+#include <util/namespace.h>
+#include <util/std_code.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+static void add_symbol(
+  symbol_tablet &symbol_table,
+  const irep_idt &name,
+  const typet &type)
+{
+  symbolt symbol;
+  symbol.name=symbol.base_name=name;
+  symbol.type=type;
+  symbol.is_static_lifetime=type.id()!=ID_code;
+  symbol.is_lvalue=type.id()!=ID_code;
+  symbol_table.add(symbol);
+}
+
+/// Whether both analyses have the same value sets for all instructions
+static bool same_value_sets(
+  const goto_functionst &goto_functions,
+  const value_set_analysist &a,
+  const value_set_analysist &b)
+{
+  forall_goto_functions(f_it, goto_functions)
+    forall_goto_program_instructions(i_it, f_it->second.body)
+      if(a[i_it].value_set.values!=b[i_it].value_set.values)
+        return false;
+
+  return true;
+}
+
+SCENARIO("value_set_cache", "[core][pointer-analysis][value_set_cache]")
+{
+  symbol_tablet symbol_table;
+  const signedbv_typet int_type(32);
+  const pointer_typet pointer_type(int_type, 64);
+  const code_typet function_type;
+
+  const symbol_exprt a("a", int_type), b("b", int_type);
+  const symbol_exprt p("p", pointer_type), q("q", pointer_type);
+  const symbol_exprt r("r", pointer_type);
+
+  add_symbol(symbol_table, "a", int_type);
+  add_symbol(symbol_table, "b", int_type);
+  add_symbol(symbol_table, "p", pointer_type);
+  add_symbol(symbol_table, "q", pointer_type);
+  add_symbol(symbol_table, "r", pointer_type);
+  add_symbol(symbol_table, "f", function_type);
+  add_symbol(symbol_table, "g", function_type);
+  add_symbol(symbol_table, "main", function_type);
+
+  const namespacet ns(symbol_table);
+
+  // void f() { p=&a; r=malloc(sizeof(int)); }
+  // void g() { q=&b; }
+  // void main() { f(); g(); q=p; }
+  goto_functionst goto_functions;
+
+  side_effect_exprt allocate(ID_allocate, pointer_type);
+  allocate.add(ID_C_cxx_alloc_type)=int_type;
+
+  goto_programt &f=goto_functions.function_map["f"].body;
+  f.add_instruction(ASSIGN)->code=code_assignt(p, address_of_exprt(a));
+  f.add_instruction(ASSIGN)->code=code_assignt(r, allocate);
+  f.add_instruction(END_FUNCTION);
+
+  goto_programt &g=goto_functions.function_map["g"].body;
+  goto_programt::targett assign_q=g.add_instruction(ASSIGN);
+  assign_q->code=code_assignt(q, address_of_exprt(b));
+  g.add_instruction(END_FUNCTION);
+
+  goto_programt &main=goto_functions.function_map["main"].body;
+  for(const char *callee : { "f", "g" })
+  {
+    code_function_callt call;
+    call.function()=symbol_exprt(callee, function_type);
+    main.add_instruction(FUNCTION_CALL)->code=call;
+  }
+  main.add_instruction(ASSIGN)->code=code_assignt(q, p);
+  main.add_instruction(END_FUNCTION);
+
+  for(auto &function : goto_functions.function_map)
+  {
+    function.second.type=function_type;
+    for(auto &instruction : function.second.body.instructions)
+      instruction.function=function.first;
+  }
+
+  goto_functions.update();
+
+  value_set_analysist analysis(ns);
+  analysis(goto_functions);
+
+  value_set_cachet written;
+  analysis.store(goto_functions, written);
+
+  std::stringstream file;
+  written.write(file);
+
+  value_set_cachet cache;
+  REQUIRE(!cache.read(file));
+
+  THEN("All functions are reused if nothing has changed")
+  {
+    REQUIRE(
+      cache.reusable_functions(goto_functions, ns)==
+      std::set<irep_idt>({ "f", "g", "main" }));
+
+    value_set_analysist cached_analysis(ns);
+    cached_analysis(goto_functions, cache);
+    REQUIRE(same_value_sets(goto_functions, cached_analysis, analysis));
+  }
+
+  THEN("Functions are reused when their location numbers change")
+  {
+    // as if instructions had been added to a function before them
+    unsigned location_number=100;
+    for(auto &function : goto_functions.function_map)
+      function.second.body.compute_location_numbers(location_number);
+
+    REQUIRE(
+      cache.reusable_functions(goto_functions, ns)==
+      std::set<irep_idt>({ "f", "g", "main" }));
+
+    // the dynamic object is named after the new location number of its
+    // allocation
+    value_set_analysist cached_analysis(ns), fresh_analysis(ns);
+    cached_analysis(goto_functions, cache);
+    fresh_analysis(goto_functions);
+    REQUIRE(same_value_sets(goto_functions, cached_analysis, fresh_analysis));
+    REQUIRE(!same_value_sets(goto_functions, cached_analysis, analysis));
+  }
+
+  THEN("Changed functions and their callers are analysed again")
+  {
+    assign_q->code=code_assignt(q, address_of_exprt(a));
+
+    REQUIRE(
+      cache.reusable_functions(goto_functions, ns)==
+      std::set<irep_idt>({ "f" }));
+
+    value_set_analysist cached_analysis(ns), fresh_analysis(ns);
+    cached_analysis(goto_functions, cache);
+    fresh_analysis(goto_functions);
+    REQUIRE(same_value_sets(goto_functions, cached_analysis, fresh_analysis));
+    REQUIRE(!same_value_sets(goto_functions, cached_analysis, analysis));
+  }
+
+  THEN("Files that are not value set caches are rejected")
+  {
+    std::istringstream other("\x7f" "ELF");
+    value_set_cachet other_cache;
+    REQUIRE(other_cache.read(other));
+    REQUIRE(other_cache.reusable_functions(goto_functions, ns).empty());
+  }
+}
@@ -0,0 +1,77 @@
+/*******************************************************************\
+
+ Module: Unit tests for boolbvt
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for the bit-blasting cache of boolbvt
+
+#include <testing-utils/catch.hpp>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+#include <solvers/flattening/boolbv.h>
+#include <solvers/sat/cnf_clause_list.h>
+
+SCENARIO("boolbv_cache", "[core][solvers][flattening][boolbv]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const unsignedbv_typet u32(32);
+  cnf_clause_listt cnf;
+  boolbvt boolbv(ns, cnf);
+
+  const symbol_exprt x("x", u32), y("y", u32);
+  // a copy, as the node of a newly built expression is not shareable
+  const exprt product=static_cast<const exprt &>(mult_exprt(x, y));
+
+  GIVEN("A term that is converted again")
+  {
+    const bvt &bv=boolbv.convert_bv(product);
+    const std::size_t clauses=cnf.no_clauses();
+
+    THEN("The same node is found without converting it again")
+    {
+      const exprt copy=product;
+      REQUIRE(&boolbv.convert_bv(copy)==&bv);
+      REQUIRE(boolbv.get_bv_cache_statistics().node_hits==1);
+      REQUIRE(cnf.no_clauses()==clauses);
+    }
+
+    THEN("An equal term that is not shared is found by its structure")
+    {
+      const mult_exprt equal(x, y);
+      const std::size_t misses=boolbv.get_bv_cache_statistics().misses;
+      REQUIRE(&boolbv.convert_bv(equal)==&bv);
+      REQUIRE(&boolbv.convert_bv(equal)==&bv);
+      // the node of equal is not shareable, hence not found by identity
+      REQUIRE(boolbv.get_bv_cache_statistics().structural_hits==2);
+      REQUIRE(boolbv.get_bv_cache_statistics().node_hits==0);
+
+      const exprt shared=equal;
+      REQUIRE(&boolbv.convert_bv(shared)==&bv);
+      REQUIRE(&boolbv.convert_bv(shared)==&bv);
+      REQUIRE(boolbv.get_bv_cache_statistics().structural_hits==3);
+      REQUIRE(boolbv.get_bv_cache_statistics().node_hits==1);
+      REQUIRE(boolbv.get_bv_cache_statistics().misses==misses);
+      REQUIRE(cnf.no_clauses()==clauses);
+    }
+
+    THEN("The cache persists across calls to the solver")
+    {
+      boolbv.set_to_true(equal_exprt(product, from_integer(6, u32)));
+      const std::size_t misses=boolbv.get_bv_cache_statistics().misses;
+      boolbv.set_to_true(notequal_exprt(product, from_integer(7, u32)));
+      // only the new constant is converted
+      REQUIRE(boolbv.get_bv_cache_statistics().misses==misses+1);
+      REQUIRE(&boolbv.convert_bv(product)==&bv);
+      REQUIRE(boolbv.get_bv_cache_statistics().node_hits==3);
+    }
+  }
+}
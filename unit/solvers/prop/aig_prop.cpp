@@ -0,0 +1,273 @@
+/*******************************************************************\
+
+ Module: Unit tests for aig_prop_solvert
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for aig_prop_solvert
+
+#include <testing-utils/catch.hpp>
+
+#include <random>
+
+#include <solvers/prop/aig_prop.h>
+#include <solvers/sat/cnf_clause_list.h>
+
+/// A plain DPLL solver, which is good enough for the small circuits used
+/// here
+class dpll_solvert:public cnf_clause_list_assignmentt
+{
+public:
+  const std::string solver_text() override
+  {
+    return "DPLL";
+  }
+
+  void set_assumptions(const bvt &_assumptions) override
+  {
+    assumptions=_assumptions;
+  }
+  bool has_set_assumptions() const override
+  {
+    return true;
+  }
+
+  resultt prop_solve() override
+  {
+    assignment.assign(no_variables(), tvt::unknown());
+    std::vector<bvt> all(clauses.begin(), clauses.end());
+
+    for(const auto &l : assumptions)
+    {
+      if(l.is_false())
+        return resultt::P_UNSATISFIABLE;
+      else if(!l.is_true())
+        all.push_back({ l });
+    }
+
+    if(!solve(all))
+      return resultt::P_UNSATISFIABLE;
+
+    for(auto &value : assignment)
+      if(value.is_unknown())
+        value=tvt(false);
+
+    return resultt::P_SATISFIABLE;
+  }
+
+protected:
+  bvt assumptions;
+
+  bool solve(const std::vector<bvt> &all)
+  {
+    const std::vector<tvt> saved=assignment;
+
+    // unit propagation
+    for(bool progress=true; progress; )
+    {
+      progress=false;
+
+      for(const auto &clause : all)
+      {
+        std::size_t unassigned=0;
+        literalt last;
+        bool satisfied=false;
+
+        for(const auto &l : clause)
+        {
+          const tvt value=assignment[l.var_no()];
+          if(value.is_unknown())
+          {
+            unassigned++;
+            last=l;
+          }
+          else if(value.is_true()!=l.sign())
+            satisfied=true;
+        }
+
+        if(satisfied)
+          continue;
+
+        if(unassigned==0)
+        {
+          assignment=saved;
+          return false;
+        }
+
+        if(unassigned==1)
+        {
+          assignment[last.var_no()]=tvt(!last.sign());
+          progress=true;
+        }
+      }
+    }
+
+    for(std::size_t v=1; v<assignment.size(); v++)
+      if(assignment[v].is_unknown())
+      {
+        for(const bool value : { false, true })
+        {
+          assignment[v]=tvt(value);
+          if(solve(all))
+            return true;
+        }
+
+        assignment=saved;
+        return false;
+      }
+
+    return true;
+  }
+};
+
+SCENARIO("aig_prop_rewriting", "[core][solvers][prop][aig_prop]")
+{
+  dpll_solvert dpll;
+  aig_prop_solvert aig_prop(dpll);
+  aig_prop.optimize();
+
+  const literalt a=aig_prop.new_variable(), b=aig_prop.new_variable();
+  const literalt a_and_b=aig_prop.land(a, b);
+
+  REQUIRE(aig_prop.land(b, a)==a_and_b);
+  REQUIRE(aig_prop.land(a_and_b, !a)==const_literal(false));
+  REQUIRE(aig_prop.land(a_and_b, a)==a_and_b);
+  REQUIRE(aig_prop.land(!a_and_b, !a)==!a);
+  REQUIRE(aig_prop.land(!a_and_b, a)==aig_prop.land(a, !b));
+  REQUIRE(
+    aig_prop.land(!aig_prop.land(a, b), !aig_prop.land(a, !b))==!a);
+  REQUIRE(aig_prop.lxor(a, b)==!aig_prop.lequal(a, b));
+  REQUIRE(aig_prop.lor(a, b)==aig_prop.lor(b, a));
+}
+
+/// Builds random circuits over six inputs and compares the result of the
+/// solver, as well as the values of all nodes, with their truth tables
+SCENARIO("aig_prop_solver", "[core][solvers][prop][aig_prop]")
+{
+  std::mt19937 random(1);
+  const std::uint64_t inputs_table[]=
+  {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+  };
+
+  for(unsigned round=0; round<300; round++)
+  {
+    dpll_solvert dpll;
+    aig_prop_solvert aig_prop(dpll);
+    // all combinations of the optimizations
+    aig_prop.rewriting=(round&1)!=0;
+    aig_prop.sweeping=(round&2)!=0;
+    aig_prop.cut_encoding=(round&4)!=0;
+
+    bvt literals;
+    std::vector<std::uint64_t> tables;
+
+    for(const auto &table : inputs_table)
+    {
+      literals.push_back(aig_prop.new_variable());
+      tables.push_back(table);
+    }
+
+    const auto pick=[&](std::uint64_t &table)
+    {
+      const std::size_t i=random()%literals.size();
+      const bool sign=random()%2==0;
+      table=sign?~tables[i]:tables[i];
+      return literals[i]^sign;
+    };
+
+    const auto add_gates=[&](unsigned count)
+    {
+      for(unsigned i=0; i<count; i++)
+      {
+        std::uint64_t x, y, z;
+        const literalt a=pick(x), b=pick(y), c=pick(z);
+
+        switch(random()%5)
+        {
+        case 0:
+          literals.push_back(aig_prop.land(a, b));
+          tables.push_back(x&y);
+          break;
+        case 1:
+          literals.push_back(aig_prop.lor(a, b));
+          tables.push_back(x|y);
+          break;
+        case 2:
+          literals.push_back(aig_prop.lxor(a, b));
+          tables.push_back(x^y);
+          break;
+        case 3:
+          literals.push_back(aig_prop.lselect(a, b, c));
+          tables.push_back((x&y)|(~x&z));
+          break;
+        default:
+          literals.push_back(aig_prop.land(bvt{ a, b, c }));
+          tables.push_back(x&y&z);
+        }
+      }
+    };
+
+    std::uint64_t satisfying=~std::uint64_t(0);
+
+    // add constraints in two steps, solving after each
+    for(unsigned step=0; step<2; step++)
+    {
+      add_gates(20);
+
+      for(unsigned i=0; i<2; i++)
+      {
+        std::uint64_t table;
+        const literalt l=pick(table);
+        aig_prop.l_set_to_true(l);
+        satisfying&=table;
+      }
+
+      const propt::resultt result=aig_prop.prop_solve();
+
+      if(satisfying==0)
+      {
+        REQUIRE(result==propt::resultt::P_UNSATISFIABLE);
+        break;
+      }
+
+      REQUIRE(result==propt::resultt::P_SATISFIABLE);
+
+      unsigned model=0;
+      for(unsigned i=0; i<6; i++)
+        if(aig_prop.l_get(literals[i]).is_true())
+          model|=1u<<i;
+
+      REQUIRE(((satisfying>>model)&1)!=0);
+
+      for(std::size_t i=0; i<literals.size(); i++)
+        REQUIRE(
+          aig_prop.l_get(literals[i]).is_true()==(((tables[i]>>model)&1)!=0));
+
+      // an assumption holds for a single call only
+      std::uint64_t assumed;
+      aig_prop.set_assumptions({ pick(assumed) });
+      const propt::resultt assumed_result=aig_prop.prop_solve();
+      aig_prop.set_assumptions(bvt());
+
+      if((satisfying&assumed)==0)
+      {
+        REQUIRE(assumed_result==propt::resultt::P_UNSATISFIABLE);
+        continue;
+      }
+
+      REQUIRE(assumed_result==propt::resultt::P_SATISFIABLE);
+
+      model=0;
+      for(unsigned i=0; i<6; i++)
+        if(aig_prop.l_get(literals[i]).is_true())
+          model|=1u<<i;
+
+      REQUIRE(((satisfying&assumed)>>model&1)!=0);
+    }
+  }
+}
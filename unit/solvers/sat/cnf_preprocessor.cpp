@@ -0,0 +1,208 @@
+/*******************************************************************\
+
+ Module: Unit tests for cnf_preprocessort
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for cnf_preprocessort
+
+#include <testing-utils/catch.hpp>
+
+#include <random>
+
+#include <solvers/sat/cnf_preprocessor.h>
+
+static bool satisfies(
+  const std::vector<tvt> &assignment,
+  const std::vector<bvt> &clauses)
+{
+  for(const auto &clause : clauses)
+  {
+    bool satisfied=false;
+    for(const auto &l : clause)
+      if(assignment[l.var_no()].is_true()!=l.sign())
+        satisfied=true;
+    if(!satisfied)
+      return false;
+  }
+
+  return true;
+}
+
+/// Solves by enumerating all assignments, which is good enough for the
+/// handful of variables used here
+class brute_force_solvert:public cnf_clause_list_assignmentt
+{
+public:
+  const std::string solver_text() override
+  {
+    return "brute force";
+  }
+
+  void set_assumptions(const bvt &_assumptions) override
+  {
+    assumptions=_assumptions;
+  }
+
+  bool has_set_assumptions() const override
+  {
+    return true;
+  }
+
+  resultt prop_solve() override
+  {
+    std::vector<bvt> all(clauses.begin(), clauses.end());
+    for(const auto &l : assumptions)
+      all.push_back(bvt(1, l));
+
+    const std::size_t n=no_variables();
+    assignment.resize(n);
+
+    for(unsigned long bits=0; bits<(1ul<<(n-1)); bits++)
+    {
+      for(std::size_t v=1; v<n; v++)
+        assignment[v]=tvt(((bits>>(v-1))&1)!=0);
+
+      if(satisfies(assignment, all))
+        return resultt::P_SATISFIABLE;
+    }
+
+    return resultt::P_UNSATISFIABLE;
+  }
+
+protected:
+  bvt assumptions;
+};
+
+static std::vector<bvt> random_clauses(
+  std::mt19937 &generator,
+  std::size_t no_variables,
+  std::size_t no_clauses)
+{
+  std::uniform_int_distribution<unsigned> variable(1, no_variables-1);
+  std::uniform_int_distribution<unsigned> length(1, 4);
+  std::bernoulli_distribution sign;
+
+  std::vector<bvt> result;
+
+  for(std::size_t i=0; i<no_clauses; i++)
+  {
+    bvt clause;
+    for(unsigned j=length(generator); j>0; j--)
+      clause.push_back(literalt(variable(generator), sign(generator)));
+    result.push_back(clause);
+  }
+
+  return result;
+}
+
+SCENARIO("Preprocessing CNF", "[core][solvers][sat][cnf_preprocessor]")
+{
+  GIVEN("Equivalences and a chain of implications")
+  {
+    cnf_preprocessort preprocessor;
+    const literalt a(1, false), b(2, false), c(3, false), d(4, false);
+
+    // a<=>b, b<=>c, c->d, a|d
+    cnf_clause_listt::clausest clauses=
+    {
+      {!a, b}, {a, !b}, {!b, c}, {b, !c}, {!c, d}, {a, d}
+    };
+
+    preprocessor.freeze(a);
+    REQUIRE(preprocessor.simplify(clauses, 5));
+
+    THEN("Equivalent literals are substituted by frozen ones")
+    {
+      REQUIRE(preprocessor.map_literal(!c)==!a);
+      REQUIRE(preprocessor.get_statistics().equivalences==2);
+      REQUIRE(preprocessor.get_statistics().clauses_before==6);
+      REQUIRE(preprocessor.get_statistics().clauses_after<6);
+    }
+  }
+
+  GIVEN("Conflicting units")
+  {
+    cnf_preprocessort preprocessor;
+    const literalt a(1, false), b(2, false);
+    cnf_clause_listt::clausest clauses={ {a}, {!a, b}, {!b} };
+
+    THEN("Unsatisfiability is detected")
+    {
+      REQUIRE_FALSE(preprocessor.simplify(clauses, 3));
+    }
+  }
+
+  GIVEN("Random clauses")
+  {
+    std::mt19937 generator(42);
+    const std::size_t no_variables=11;
+
+    for(unsigned round=0; round<300; round++)
+    {
+      const std::vector<bvt> original=
+        random_clauses(generator, no_variables, 5+round%40);
+
+      // the brute force solver on the original clauses
+      brute_force_solvert reference;
+      reference.set_no_variables(no_variables);
+      for(const auto &clause : original)
+        reference.lcnf(clause);
+      const bool expected=
+        reference.prop_solve()==propt::resultt::P_SATISFIABLE;
+
+      cnf_preprocessing_solvert solver(
+        std::unique_ptr<cnft>(new brute_force_solvert()));
+      null_message_handlert message_handler;
+      solver.set_message_handler(message_handler);
+      solver.set_no_variables(no_variables);
+      solver.set_frozen(literalt(1, false));
+
+      for(const auto &clause : original)
+        solver.lcnf(clause);
+
+      const bool result=solver.prop_solve()==propt::resultt::P_SATISFIABLE;
+      REQUIRE(result==expected);
+
+      if(result)
+      {
+        std::vector<tvt> assignment(no_variables);
+        for(std::size_t v=1; v<no_variables; v++)
+          assignment[v]=solver.l_get(literalt(v, false));
+        REQUIRE(satisfies(assignment, original));
+      }
+
+      // add further clauses over eliminated variables and solve again,
+      // assuming the frozen variable
+      std::vector<bvt> extended=original;
+      for(const auto &clause : random_clauses(generator, no_variables, 3))
+      {
+        solver.lcnf(clause);
+        extended.push_back(clause);
+      }
+
+      reference.lcnf(bvt(1, literalt(1, true)));
+      for(std::size_t i=original.size(); i<extended.size(); i++)
+        reference.lcnf(extended[i]);
+      const bool expected_extended=
+        reference.prop_solve()==propt::resultt::P_SATISFIABLE;
+
+      solver.set_assumptions(bvt(1, literalt(1, true)));
+      const bool result_extended=
+        solver.prop_solve()==propt::resultt::P_SATISFIABLE;
+      REQUIRE(result_extended==expected_extended);
+
+      if(result_extended)
+      {
+        extended.push_back(bvt(1, literalt(1, true)));
+        std::vector<tvt> assignment(no_variables);
+        for(std::size_t v=1; v<no_variables; v++)
+          assignment[v]=solver.l_get(literalt(v, false));
+        REQUIRE(satisfies(assignment, extended));
+      }
+    }
+  }
+}
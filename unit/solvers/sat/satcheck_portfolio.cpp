@@ -0,0 +1,145 @@
+/*******************************************************************\
+
+ Module: Unit tests for satcheck_portfoliot
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for satcheck_portfoliot
+
+#include <testing-utils/catch.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <util/make_unique.h>
+
+#include <solvers/sat/cnf_clause_list.h>
+#include <solvers/sat/satcheck_portfolio.h>
+
+/// Solves by enumerating all assignments, or runs until interrupted
+class test_solvert:public cnf_solvert
+{
+public:
+  explicit test_solvert(bool _answers):
+    answers(_answers),
+    interrupted(false)
+  {
+  }
+
+  const std::string solver_text() override
+  {
+    return answers?"brute force":"never answers";
+  }
+
+  void lcnf(const bvt &bv) override
+  {
+    clauses.push_back(bv);
+    clause_counter++;
+  }
+
+  resultt prop_solve() override
+  {
+    while(!answers)
+    {
+      if(interrupted)
+        return resultt::P_ERROR;
+      std::this_thread::yield();
+    }
+
+    const std::size_t n=no_variables();
+    assignment.resize(n);
+
+    for(unsigned long bits=0; bits<(1ul<<(n-1)); bits++)
+    {
+      for(std::size_t v=1; v<n; v++)
+        assignment[v]=((bits>>(v-1))&1)!=0;
+
+      if(satisfied())
+        return resultt::P_SATISFIABLE;
+    }
+
+    return resultt::P_UNSATISFIABLE;
+  }
+
+  tvt l_get(literalt a) const override
+  {
+    if(a.is_constant())
+      return tvt(a.is_true());
+    return tvt(assignment[a.var_no()]!=a.sign());
+  }
+
+  const bool answers;
+  std::atomic<bool> interrupted;
+
+protected:
+  std::vector<bvt> clauses;
+  std::vector<bool> assignment;
+
+  bool satisfied() const
+  {
+    for(const auto &clause : clauses)
+    {
+      bool result=false;
+      for(const auto &l : clause)
+        result|=l_get(l).is_true();
+      if(!result)
+        return false;
+    }
+
+    return true;
+  }
+};
+
+static test_solvert &add_test_solver(
+  satcheck_portfoliot &portfolio,
+  bool answers)
+{
+  auto solver=util_make_unique<test_solvert>(answers);
+  test_solvert &result=*solver;
+  portfolio.add_solver(
+    std::move(solver),
+    [&result]() { result.interrupted=true; },
+    [&result]() { result.interrupted=false; });
+  return result;
+}
+
+SCENARIO("satcheck_portfolio", "[core][solvers][sat][satcheck_portfolio]")
+{
+  GIVEN("A portfolio with one member that never answers")
+  {
+    satcheck_portfoliot portfolio;
+    test_solvert &slow=add_test_solver(portfolio, false);
+    add_test_solver(portfolio, true);
+
+    const literalt a=portfolio.new_variable(), b=portfolio.new_variable();
+    portfolio.lcnf({ a, b });
+    portfolio.lcnf({ !a, b });
+
+    THEN("The answer and the model are those of the other member")
+    {
+      REQUIRE(portfolio.prop_solve()==propt::resultt::P_SATISFIABLE);
+      REQUIRE(portfolio.l_get(b).is_true());
+      REQUIRE(!slow.interrupted);
+
+      // clauses added later are passed on as well
+      portfolio.lcnf({ !b });
+      REQUIRE(portfolio.prop_solve()==propt::resultt::P_UNSATISFIABLE);
+    }
+  }
+
+  GIVEN("A portfolio in which no member answers")
+  {
+    satcheck_portfoliot portfolio;
+    add_test_solver(portfolio, false);
+    add_test_solver(portfolio, false);
+    portfolio.set_time_limit_seconds(1);
+
+    THEN("Solving stops at the time limit")
+    {
+      REQUIRE(portfolio.prop_solve()==propt::resultt::P_ERROR);
+    }
+  }
+}
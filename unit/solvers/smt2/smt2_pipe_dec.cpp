@@ -0,0 +1,120 @@
+/*******************************************************************\
+
+ Module: Unit tests for smt2_pipe_dect
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+/// \file
+/// Unit tests for smt2_pipe_dect
+
+#include <testing-utils/catch.hpp>
+
+#include <util/arith_tools.h>
+#include <util/c_types.h>
+#include <util/config.h>
+#include <util/namespace.h>
+#include <util/pointer_predicates.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+
+#include <solvers/smt2/smt2_pipe_dec.h>
+
+#ifndef _WIN32
+
+/// Runs a shell command in place of the solver
+class scripted_solvert:public smt2_pipe_dect
+{
+public:
+  scripted_solvert(const namespacet &_ns, const std::string &_script):
+    smt2_pipe_dect(_ns, "test", "", "QF_AUFBV", solvert::Z3),
+    script(_script)
+  {
+  }
+
+protected:
+  std::string script;
+
+  void get_command(
+    std::string &executable,
+    std::list<std::string> &arguments) const override
+  {
+    executable="sh";
+    arguments={ "-c", script };
+  }
+};
+
+SCENARIO("smt2_pipe_dect", "[core][solvers][smt2][smt2_pipe_dec]")
+{
+  symbol_tablet symbol_table;
+  const namespacet ns(symbol_table);
+  const symbol_exprt a("a", bool_typet());
+
+  GIVEN("A solver that answers unsat to every query, until told to exit")
+  {
+    scripted_solvert solver(
+      ns,
+      "while read -r line; do "
+      "case \"$line\" in *check-sat*) echo unsat;; *exit*) exit 0;; esac; "
+      "done");
+
+    solver.set_to_true(a);
+
+    THEN("The answer is read back, also for later queries")
+    {
+      REQUIRE(solver()==decision_proceduret::resultt::D_UNSATISFIABLE);
+      solver.set_to_false(a);
+      REQUIRE(solver()==decision_proceduret::resultt::D_UNSATISFIABLE);
+    }
+  }
+
+  GIVEN("A formula with the size of an object, and a solver that fails "
+        "when a definition of the size is sent twice")
+  {
+    config.set_arch("none");
+    config.bv_encoding.object_bits=config.bv_encoding.default_object_bits;
+
+    scripted_solvert solver(
+      ns,
+      "seen=; repeated=0; "
+      "while read -r line; do "
+      "case \"$line\" in "
+      "*implies*object_size*) "
+      "case \"$seen\" in *\"|$line|\"*) repeated=1;; esac; "
+      "seen=\"$seen|$line|\";; "
+      "*check-sat*) "
+      "if [ $repeated = 0 ]; then echo unsat; "
+      "else echo '(error \"repeated\")'; fi;; "
+      "*exit*) exit 0;; esac; "
+      "done");
+
+    const symbol_exprt x("x", unsignedbv_typet(32));
+    const symbol_exprt p("p", pointer_type(x.type()));
+    solver.set_to_true(equal_exprt(p, address_of_exprt(x)));
+    solver.set_to_true(
+      equal_exprt(object_size(p), from_integer(4, size_type())));
+
+    THEN("Later queries do not define the size again")
+    {
+      REQUIRE(solver()==decision_proceduret::resultt::D_UNSATISFIABLE);
+      solver.set_to_true(a);
+      REQUIRE(solver()==decision_proceduret::resultt::D_UNSATISFIABLE);
+    }
+  }
+
+  GIVEN("A solver that terminates without reading its input")
+  {
+    scripted_solvert solver(ns, "exit 0");
+
+    solver.set_to_true(a);
+
+    THEN("The query fails, and does not raise SIGPIPE")
+    {
+      REQUIRE(solver()==decision_proceduret::resultt::D_ERROR);
+      REQUIRE(solver()==decision_proceduret::resultt::D_ERROR);
+    }
+  }
+}
+
+#endif
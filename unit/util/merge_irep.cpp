@@ -0,0 +1,91 @@
+/*******************************************************************\
+
+ Module: Unit tests for merge_irept
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+#include <testing-utils/catch.hpp>
+
+#include <util/merge_irep.h>
+#include <util/std_expr.h>
+#include <util/std_types.h>
+
+SCENARIO("Merging ireps", "[core][util][merge_irep]")
+{
+  const signedbv_typet int_type(32);
+  const symbol_exprt x("x", int_type);
+  const symbol_exprt y("y", int_type);
+
+  GIVEN("Two structurally equal expressions built separately")
+  {
+    exprt e1=plus_exprt(x, y);
+    exprt e2=plus_exprt(symbol_exprt("x", int_type), y);
+
+    REQUIRE(&e1.read()!=&e2.read());
+
+    merge_full_irept merge;
+    merge(e1);
+    merge(e2);
+
+    THEN("They share a single node")
+    {
+      REQUIRE(e1==e2);
+      REQUIRE(&e1.read()==&e2.read());
+      REQUIRE(&e1.op0().read()==&e2.op0().read());
+    }
+
+    THEN("Merging them again takes the shortcut")
+    {
+      const std::size_t looked_up=merge.get_statistics().nodes_looked_up;
+      merge(e1);
+      REQUIRE(merge.get_statistics().nodes_looked_up==looked_up);
+      REQUIRE(merge.get_statistics().already_merged>0);
+    }
+
+    THEN("Modifying a merged expression does not affect the other one")
+    {
+      e1.op1()=x;
+      REQUIRE(e2.op1()==y);
+    }
+  }
+
+  GIVEN("A hash consing scope")
+  {
+    exprt e1=plus_exprt(x, y);
+    exprt e2=plus_exprt(symbol_exprt("x", int_type), y);
+
+    THEN("Expressions are merged only within the scope")
+    {
+      {
+        hash_consing_scopet scope;
+        hash_cons(e1);
+        hash_cons(e2);
+        REQUIRE(&e1.read()==&e2.read());
+        REQUIRE(scope.get_store().size()>0);
+      }
+
+      exprt e3=plus_exprt(x, y);
+      hash_cons(e3);
+      REQUIRE(&e3.read()!=&e1.read());
+      REQUIRE(e3==e1);
+    }
+  }
+
+  GIVEN("Expressions that only differ in a comment")
+  {
+    exprt e1=x;
+    exprt e2=x;
+    e2.set(ID_C_SSA_symbol, true);
+
+    THEN("Full merging keeps them apart")
+    {
+      merge_full_irept merge;
+      merge(e1);
+      merge(e2);
+      REQUIRE(!e1.get_bool(ID_C_SSA_symbol));
+      REQUIRE(e2.get_bool(ID_C_SSA_symbol));
+    }
+  }
+}
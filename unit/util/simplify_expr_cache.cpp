@@ -0,0 +1,98 @@
+/*******************************************************************\
+
+ Module: Unit tests for simplify_expr_cachet
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+#include <testing-utils/catch.hpp>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/simplify_expr_cache.h>
+#include <util/simplify_expr_class.h>
+#include <util/std_expr.h>
+#include <util/std_types.h>
+#include <util/symbol_table.h>
+
+SCENARIO("Caching simplifier results", "[core][util][simplify_expr_cache]")
+{
+  const signedbv_typet int_type(32);
+  const symbol_exprt x("x", int_type);
+  const symbol_exprt y("y", int_type);
+  const symbol_exprt z("z", int_type);
+
+  GIVEN("A cache with room for two entries")
+  {
+    simplify_expr_cachet cache(2);
+    exprt result;
+
+    cache.insert(plus_exprt(x, y), z);
+    cache.insert(minus_exprt(x, y), nil_exprt());
+
+    THEN("Structurally equal expressions are found")
+    {
+      REQUIRE(cache.lookup(plus_exprt(x, y), result));
+      REQUIRE(result==z);
+      REQUIRE(cache.lookup(minus_exprt(x, y), result));
+      REQUIRE(result.is_nil());
+      REQUIRE_FALSE(cache.lookup(plus_exprt(y, x), result));
+
+      const simplify_expr_cache_statisticst &s=cache.get_statistics();
+      REQUIRE(s.hits==2);
+      REQUIRE(s.misses==1);
+    }
+
+    THEN("It does not grow beyond its capacity")
+    {
+      cache.insert(mult_exprt(x, y), z);
+      cache.insert(div_exprt(x, y), z);
+
+      REQUIRE(cache.size()==2);
+      REQUIRE(cache.get_statistics().evictions==3);
+      REQUIRE_FALSE(cache.lookup(plus_exprt(x, y), result));
+      REQUIRE(cache.lookup(div_exprt(x, y), result));
+    }
+
+    THEN("Recently used entries survive")
+    {
+      cache.insert(mult_exprt(x, y), z);
+      REQUIRE(cache.lookup(minus_exprt(x, y), result));
+      cache.insert(div_exprt(x, y), z);
+
+      REQUIRE(cache.lookup(minus_exprt(x, y), result));
+      REQUIRE_FALSE(cache.lookup(plus_exprt(x, y), result));
+    }
+  }
+
+  GIVEN("A simplifier that uses a cache")
+  {
+    symbol_tablet symbol_table;
+    const namespacet ns(symbol_table);
+    simplify_expr_cachet cache(8);
+
+    simplify_exprt simplifier(ns);
+    simplifier.cache=&cache;
+
+    THEN("Simplifying an expression again takes the result from the cache")
+    {
+      exprt e1=plus_exprt(from_integer(1, int_type), from_integer(2, int_type));
+      exprt e2=e1;
+
+      REQUIRE(!simplifier.simplify(e1));
+      REQUIRE(!simplifier.simplify(e2));
+      REQUIRE(e1==from_integer(3, int_type));
+      REQUIRE(e2==e1);
+      REQUIRE(cache.get_statistics().hits==1);
+      REQUIRE(cache.get_statistics().misses==1);
+    }
+
+    THEN("Other simplifiers do not see the cache")
+    {
+      exprt e=plus_exprt(from_integer(1, int_type), from_integer(2, int_type));
+      REQUIRE(!simplify_exprt(ns).simplify(e));
+      REQUIRE(cache.size()==0);
+    }
+  }
+}
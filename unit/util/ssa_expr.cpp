@@ -0,0 +1,61 @@
+/*******************************************************************\
+
+ Module: Unit tests for ssa_exprt
+
+ Author: agent, agent@local
+
+\*******************************************************************/
+
+#include <testing-utils/catch.hpp>
+
+#include <util/arith_tools.h>
+#include <util/ssa_expr.h>
+#include <util/std_types.h>
+
+SCENARIO("SSA identifiers", "[core][util][ssa_expr]")
+{
+  const signedbv_typet int_type(32);
+
+  GIVEN("An SSA expression for a symbol")
+  {
+    ssa_exprt ssa(symbol_exprt("x", int_type));
+
+    THEN("The identifier carries the levels that are set")
+    {
+      REQUIRE(ssa.get_identifier()=="x");
+
+      ssa.set_level_0(1);
+      ssa.set_level_1(2);
+      REQUIRE(ssa.get_identifier()=="x!1@2");
+      REQUIRE(ssa.get_l1_object_identifier()=="x!1@2");
+
+      ssa.set_level_2(3);
+      REQUIRE(ssa.get_identifier()=="x!1@2#3");
+      REQUIRE(ssa.get_l1_object_identifier()=="x!1@2");
+
+      ssa.remove_level_2();
+      REQUIRE(ssa.get_identifier()=="x!1@2");
+    }
+
+  }
+
+  GIVEN("An SSA expression for an array element of a struct member")
+  {
+    struct_typet struct_type;
+    const array_typet array_type(int_type, from_integer(4, int_type));
+    struct_type.components().push_back(
+      struct_typet::componentt("a", array_type));
+
+    const member_exprt member(
+      symbol_exprt("s", struct_type), "a", array_type);
+    ssa_exprt ssa(index_exprt(member, from_integer(2, int_type)));
+
+    THEN("The identifier renders the access path after the root")
+    {
+      ssa.set_level_1(1);
+      ssa.set_level_2(7);
+      REQUIRE(ssa.get_identifier()=="s@1#7.a[2]");
+      REQUIRE(ssa.get_l1_object_identifier()=="s@1");
+    }
+  }
+}